@@ -0,0 +1,170 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include <string>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "MappedFile.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Many files stored in a single mapped archive.
+   *
+   * Opening a pack maps one file, after which looking an entry up is a
+   * binary search and reading it is a pointer into the mapping, with no
+   * system call. SO::Surface, SO::Texture, SO::BakedImage and fonts load
+   * entries in place through SDL_RWFromConstMem.
+   *
+   * Layout, little endian:
+   *
+   * | Offset          | Size      | Field                              |
+   * |-----------------|-----------|------------------------------------|
+   * | 0               | 4         | magic "SOPK"                       |
+   * | 4               | 4         | version, 1                         |
+   * | 8               | 4         | number of entries                  |
+   * | 12              | 4         | reserved, 0                        |
+   * | 16              | 24 each   | index, sorted by name              |
+   * | after the index |           | names, then blobs 64 bytes aligned |
+   *
+   * An index record holds the offset and length of the name, then the
+   * 64 bits offset and size of the blob, all from the start of the file.
+   *
+   * Packs are produced by SO::AssetPack::pack or the tools/so-pack
+   * command.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class AssetPack
+  {
+  public:
+
+    /** Contents of an entry, in the mapping */
+    struct Entry
+    {
+      const void* data;
+      std::size_t size;
+    };
+
+    /**
+     * @brief Open a pack.
+     * @param path Path of the pack
+     * @throw SO::Error if it can't be read or isn't a pack
+     */
+    explicit AssetPack(const char* path);
+
+    AssetPack(const AssetPack& orig)            = delete;
+    AssetPack(AssetPack&& orig)                 = delete;
+    AssetPack& operator=(const AssetPack& orig) = delete;
+    AssetPack& operator=(AssetPack&& orig)      = delete;
+
+    ~AssetPack() = default;
+
+    /**
+     * @brief Write files to a pack.
+     * @param path Path of the pack
+     * @param names Names of the files, relative to root, as they are
+     * looked up in the pack
+     * @param root Directory the files are read from, nullptr for the
+     * working directory
+     * @throw SO::Error if a file can't be read, a name appears twice or
+     * the pack can't be written
+     */
+    static void pack(const char* path,
+		     std::vector<std::string> names,
+		     const char* root = nullptr);
+
+    /**
+     * @brief Check if the pack has an entry.
+     * @param name Name of the entry
+     * @return bool
+     */
+    bool contains(const std::string& name) const;
+
+    /**
+     * @brief Get an entry.
+     * @param name Name of the entry
+     * @return Entry
+     * @throw SO::Error if there's no such entry
+     */
+    Entry get(const std::string& name) const;
+
+    /**
+     * @brief Open an entry for reading.
+     * @param name Name of the entry
+     * @return SDL_RWops* reading the mapping, to be closed by the caller
+     * @throw SO::Error if there's no such entry
+     */
+    SDL_RWops* open(const std::string& name) const;
+
+#ifdef _SDL_TTF_H
+    /**
+     * @brief Open a font stored in the pack.
+     * @param name Name of the entry
+     * @param size Point size of the font
+     * @return TTF_Font* to be closed with TTF_CloseFont
+     * @throw SO::Error on failure
+     * @warning The font reads the pack, it must be closed before the
+     * pack is destroyed.
+     */
+    TTF_Font* openFont(const std::string& name, int size) const;
+#endif
+
+    /**
+     * @brief Get the number of entries.
+     * @return std::size_t
+     */
+    std::size_t getCount() const;
+
+    /**
+     * @brief Get the name of an entry, in sorted order.
+     * @param index Index of the entry
+     * @return std::string
+     */
+    std::string getName(std::size_t index) const;
+
+  private:
+
+    static constexpr Uint32 Magic      = 0x4B504F53; // "SOPK"
+    static constexpr Uint32 Version    = 1;
+    static constexpr Uint32 HeaderSize = 16;
+    static constexpr Uint32 RecordSize = 24;
+    static constexpr Uint32 Alignment  = 64;
+
+    // Index record of an entry, nullptr if there's none
+    const Uint8* find(const std::string& name) const;
+
+    MappedFile   m_file;
+    const Uint8* m_index;
+    std::size_t  m_count;
+  };
+
+}
+
+#endif // ASSET_PACK_HPP
@@ -0,0 +1,152 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BAKED_IMAGE_HPP
+#define BAKED_IMAGE_HPP
+
+#include <string>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Surface.hpp"
+#include "MappedFile.hpp"
+
+namespace SO
+{
+
+  class AssetPack; // Forward declaration
+
+  /**
+   * @brief Image whose pixels are stored ready to upload.
+   *
+   * A baked file is a header followed by the rows of the image, already
+   * in the pixel format of the textures made from it. Loading one maps
+   * the file in memory, so nothing is decoded nor converted before
+   * SDL_UpdateTexture.
+   *
+   * Layout, little endian:
+   *
+   * | Offset | Size | Field                               |
+   * |--------|------|-------------------------------------|
+   * | 0      | 4    | magic "SOBK"                        |
+   * | 4      | 4    | version, 1                          |
+   * | 8      | 4    | SDL_PixelFormatEnum of the pixels   |
+   * | 12     | 4    | width                               |
+   * | 16     | 4    | height                              |
+   * | 20     | 4    | pitch, bytes per row                |
+   * | 24     | 4    | offset of the pixels, 64 bytes aligned |
+   *
+   * Files are produced by SO::BakedImage::bake or the tools/so-bake
+   * command.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class BakedImage
+  {
+  public:
+
+    /**
+     * @brief Map a baked file.
+     * @param path Path of the file
+     * @throw SO::Error if it can't be read or isn't a baked image
+     */
+    explicit BakedImage(const char* path);
+
+    /**
+     * @brief Read a baked image stored in an asset pack, in place.
+     * @param pack Pack of the image, it must outlive the baked image
+     * @param name Name of the entry
+     * @throw SO::Error if there's no such entry or it isn't a baked image
+     */
+    BakedImage(const AssetPack& pack, const std::string& name);
+
+    BakedImage(const BakedImage& orig)            = delete;
+    BakedImage(BakedImage&& orig)                 = delete;
+    BakedImage& operator=(const BakedImage& orig) = delete;
+    BakedImage& operator=(BakedImage&& orig)      = delete;
+
+    ~BakedImage() = default;
+
+    /**
+     * @brief Write the pixels of a surface to a baked file.
+     * @param surface Surface to bake
+     * @param path Path of the file
+     * @param format Format the pixels are stored in
+     * @throw SO::Error on failure
+     */
+    static void bake(Surface& surface,
+		     const char* path,
+		     PixelFormats format = PixelFormats::ARGB8888);
+
+    /**
+     * @brief Get the format of the pixels.
+     * @return PixelFormats
+     */
+    PixelFormats getFormat() const;
+
+    /**
+     * @brief Get the width of the image.
+     * @return int
+     */
+    int getWidth() const;
+
+    /**
+     * @brief Get the height of the image.
+     * @return int
+     */
+    int getHeight() const;
+
+    /**
+     * @brief Get the number of bytes between two rows.
+     * @return int
+     */
+    int getPitch() const;
+
+    /**
+     * @brief Get the pixels, in the mapped file.
+     * @return const void*
+     */
+    const void* getPixels() const;
+
+  private:
+
+    static constexpr Uint32 Magic      = 0x4B424F53; // "SOBK"
+    static constexpr Uint32 Version    = 1;
+    static constexpr Uint32 HeaderSize = 28;
+    static constexpr Uint32 Alignment  = 64;
+
+    // Check the header and find the pixels
+    void parse(const Uint8* data, std::size_t size);
+
+    MappedFile   m_file;     // empty when read from a pack
+
+    PixelFormats m_format;
+    int          m_width;
+    int          m_height;
+    int          m_pitch;
+    const Uint8* m_pixels;
+  };
+
+}
+
+#endif // BAKED_IMAGE_HPP
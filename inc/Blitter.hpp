@@ -0,0 +1,235 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BLITTER_HPP
+#define BLITTER_HPP
+
+#include "Utils.hpp"
+#include "Error.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Native pixel kernels used by SO::Surface.
+   *
+   * Kernels have scalar, SSE2 and AVX2 versions returning the same
+   * results. The fastest one the CPU supports is picked the first time
+   * a kernel runs.
+   *
+   * Operations covering at least SO::Blitter::getThreshold() pixels are
+   * split into bands of rows about the size of the L2 cache, shared
+   * between SO::Blitter::getThreads() OpenMP threads. Smaller ones run
+   * on the calling thread.
+   *
+   * **SDL 2.0.0**, AVX2 needs **SDL 2.0.4**
+   */
+
+  class Blitter
+  {
+  public:
+
+    /** Instruction set of the kernels */
+    enum class Kernel
+    {
+      Scalar,
+      SSE2,
+      AVX2
+    };
+
+    Blitter() = delete;
+
+    /**
+     * @brief Check if kernels of an instruction set can run.
+     * @param kernel Instruction set
+     * @return bool
+     */
+    static bool isSupported(Kernel kernel);
+
+    /**
+     * @brief Get the instruction set of the kernels in use.
+     * @return Kernel
+     */
+    static Kernel getKernel();
+
+    /**
+     * @brief Force the instruction set of the kernels, for testing and
+     * benchmarking.
+     * @param kernel Instruction set
+     * @throw SO::Error if the CPU doesn't support it
+     */
+    static void setKernel(Kernel kernel);
+
+    /**
+     * @brief Blend ARGB8888 pixels over ARGB8888 or RGB888 pixels.
+     *
+     * Each channel gets src * a + dst * (255 - a), divided by 255 with
+     * rounding, where a is the alpha of the source pixel. The alpha of
+     * the destination gets a + alpha * (255 - a) the same way, so a
+     * transparent source keeps the destination and an opaque one
+     * replaces it exactly.
+     *
+     * @param src Source pixels
+     * @param dst Destination pixels
+     * @param count Number of pixels
+     */
+    static void blendRow(const Uint32* src, Uint32* dst, std::size_t count);
+
+    /**
+     * @brief Blend a rectangle of pixels, as SO::Blitter::blendRow.
+     * @param src First source pixel
+     * @param srcPitch Bytes between two source rows
+     * @param dst First destination pixel
+     * @param dstPitch Bytes between two destination rows
+     * @param width Pixels per row
+     * @param height Number of rows
+     */
+    static void blend(const void* src, int srcPitch,
+		      void* dst, int dstPitch,
+		      int width, int height);
+
+    /**
+     * @brief Copy a rectangle of pixels.
+     * @param src First source pixel
+     * @param srcPitch Bytes between two source rows
+     * @param dst First destination pixel
+     * @param dstPitch Bytes between two destination rows
+     * @param width Bytes per row
+     * @param height Number of rows
+     */
+    static void copy(const void* src, int srcPitch,
+		     void* dst, int dstPitch,
+		     int width, int height);
+
+    /**
+     * @brief Fill a rectangle of pixels with a color.
+     * @param dst First pixel
+     * @param pitch Bytes between two rows
+     * @param bytesPerPixel Size of a pixel, from 1 to 4
+     * @param width Pixels per row
+     * @param height Number of rows
+     * @param color Pixel value, in the format of the pixels
+     */
+    static void fill(void* dst, int pitch, int bytesPerPixel,
+		     int width, int height, Uint32 color);
+
+    /**
+     * @brief Scale a rectangle of 32 bits pixels.
+     *
+     * Nearest samples pixels at their center, as SDL_BlitScaled does
+     * since SDL 2.0.16. Linear and Box work on the 4 bytes of the pixels
+     * independently, so on any 32 bits format, and have scalar and SSE2
+     * versions returning the same results. Colors are not premultiplied
+     * by their alpha.
+     *
+     * @param src First source pixel
+     * @param srcPitch Bytes between two source rows
+     * @param srcWidth Source pixels per row
+     * @param srcHeight Number of source rows
+     * @param dst First destination pixel
+     * @param dstPitch Bytes between two destination rows
+     * @param dstWidth Destination pixels per row
+     * @param dstHeight Number of destination rows
+     * @param blend Blend the sampled ARGB8888 pixels as
+     * SO::Blitter::blendRow instead of copying them
+     * @param filter Sampling of the source pixels
+     */
+    static void scale(const void* src, int srcPitch, int srcWidth, int srcHeight,
+		      void* dst, int dstPitch, int dstWidth, int dstHeight,
+		      bool blend, ScaleFilters filter = ScaleFilters::Nearest);
+
+    /**
+     * @brief Check if a conversion has native kernels.
+     *
+     * Conversions between the 32 bits RGB formats, with or without
+     * alpha, and RGB24 or BGR24 do. Conversions to 32 bits have SSE2 and
+     * AVX2 kernels, the others a scalar one.
+     *
+     * @param from Format of the source
+     * @param to Format of the destination
+     * @return bool
+     */
+    static bool canConvert(PixelFormats from, PixelFormats to);
+
+    /**
+     * @brief Convert a rectangle of pixels to an other format.
+     *
+     * Channels are copied, a missing alpha becomes opaque and unused
+     * bytes are cleared. Conversions without native kernels go through
+     * SDL_ConvertPixels.
+     *
+     * @param src First source pixel
+     * @param srcPitch Bytes between two source rows
+     * @param srcFormat Format of the source
+     * @param dst First destination pixel, src itself to convert in place
+     * @param dstPitch Bytes between two destination rows
+     * @param dstFormat Format of the destination
+     * @param width Pixels per row
+     * @param height Number of rows
+     * @throw SO::Error if converting in place without native kernels or
+     * between pixels or rows of different sizes, or if SDL_ConvertPixels
+     * fails
+     */
+    static void convert(const void* src, int srcPitch, PixelFormats srcFormat,
+			void* dst, int dstPitch, PixelFormats dstFormat,
+			int width, int height);
+
+    /**
+     * @brief Get the number of threads sharing large operations.
+     * @return int, 1 without OpenMP
+     */
+    static int getThreads();
+
+    /**
+     * @brief Set the number of threads sharing large operations.
+     * @param threads Number of threads, 0 for the OpenMP default and 1
+     * to never split operations
+     */
+    static void setThreads(int threads);
+
+    /**
+     * @brief Get the number of pixels from which operations are split
+     * across threads.
+     * @return std::size_t
+     */
+    static std::size_t getThreshold();
+
+    /**
+     * @brief Set the number of pixels from which operations are split
+     * across threads.
+     * @param pixels Number of pixels, 512x512 by default
+     */
+    static void setThreshold(std::size_t pixels);
+
+    /**
+     * @brief Check if an operation on a rectangle would be split across
+     * threads.
+     * @param width Width of the rectangle
+     * @param height Height of the rectangle
+     * @return bool
+     */
+    static bool isParallel(int width, int height);
+  };
+
+}
+
+#endif // BLITTER_HPP
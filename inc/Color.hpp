@@ -102,7 +102,7 @@ namespace SO
     {
       r = orig.r;
       g = orig.g;
-      b = orig.g;
+      b = orig.b;
       a = orig.a;
       return *this;
     }
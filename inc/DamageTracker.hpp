@@ -0,0 +1,117 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef DAMAGE_TRACKER_HPP
+#define DAMAGE_TRACKER_HPP
+
+#include <vector>
+
+#include "Utils.hpp"
+#include "Rect.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Set of regions touched during a frame.
+   *
+   * Rects closer than a margin to each other are merged as they are
+   * added, so the set stays small and covers few pixels twice. When it
+   * grows past a maximum count, the two rects whose union wastes the
+   * least area are merged.
+   */
+
+  class DamageTracker
+  {
+  public:
+
+    /**
+     * @brief Create an empty tracker.
+     * @param margin Rects closer than this many pixels are merged
+     * @param maxRects Maximum number of rects kept
+     */
+    explicit DamageTracker(int margin = 8, std::size_t maxRects = 16);
+
+    /**
+     * @brief Mark a region as damaged.
+     * @param rect Damaged region, clipped to the bounds if any
+     * @return DamageTracker&
+     * @note A region inside an already damaged one leaves the set
+     * unchanged.
+     */
+    DamageTracker& add(const Rect& rect);
+
+    /**
+     * @brief Mark the whole bounds as damaged.
+     * @return DamageTracker&
+     */
+    DamageTracker& addAll();
+
+    /**
+     * @brief Forget every damaged region.
+     * @return DamageTracker&
+     */
+    DamageTracker& clear();
+
+    /**
+     * @brief Get the area damage is clipped to.
+     * @return Rect
+     */
+    Rect getBounds() const;
+
+    /**
+     * @brief Get the total area covered by the damaged regions.
+     * @return Uint64
+     */
+    Uint64 getArea() const;
+
+    /**
+     * @brief Get the merged damaged regions, which don't overlap.
+     * @return const std::vector<Rect>&
+     */
+    const std::vector<Rect>& getRects() const;
+
+    /**
+     * @brief Return whether nothing is damaged.
+     * @return bool
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Clip damage to an area, an empty Rect disables clipping.
+     * @param bounds Area damage is clipped to
+     * @return DamageTracker&
+     * @note Regions already recorded are not clipped again.
+     */
+    DamageTracker& setBounds(const Rect& bounds);
+
+  private:
+
+    int               m_margin;
+    std::size_t       m_maxRects;
+    Rect              m_bounds;
+    std::vector<Rect> m_rects;
+  };
+
+}
+
+#endif // DAMAGE_TRACKER_HPP
@@ -0,0 +1,176 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef FONT_ATLAS_HPP
+#define FONT_ATLAS_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Color.hpp"
+#include "Sprite.hpp"
+#include "TextureAtlas.hpp"
+#include "TextLayout.hpp"
+
+#ifdef _SDL_TTF_H
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Glyphs of fonts cached in a SO::TextureAtlas.
+   *
+   * Each glyph is rasterized once per font and style, in white, then
+   * tinted by the color mod of the sprite drawing it. A font being
+   * opened at a given size, a font and its style identify the glyphs.
+   *
+   * Drawing text reuses the atlas pages and scratch buffers, so text
+   * changing every frame doesn't create textures.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class FontAtlas
+  {
+  public:
+
+    /** A rasterized glyph */
+    struct Glyph
+    {
+      TextureAtlas::Handle handle;
+      int                  offset;  // from the pen to the left of the image
+      int                  advance; // from the pen to the next one
+    };
+
+    /**
+     * @brief Create an empty atlas.
+     * @param renderer Renderer text is drawn with
+     * @param pageSize Width and height of the atlas pages
+     */
+    explicit FontAtlas(Renderer& renderer, int pageSize = 512);
+
+    FontAtlas(const FontAtlas& orig)            = delete;
+    FontAtlas(FontAtlas&& orig)                 = delete;
+    FontAtlas& operator=(const FontAtlas& orig) = delete;
+    FontAtlas& operator=(FontAtlas&& orig)      = delete;
+
+    ~FontAtlas() = default;
+
+    /**
+     * @brief Draw a line of UTF-8 text, with kerning.
+     * @param font Font to draw with, in its current style
+     * @param text Text to draw, '\n' starts a new line
+     * @param x Left of the text
+     * @param y Top of the text
+     * @param color Color of the text
+     * @return FontAtlas&
+     * @throw SO::Error on failure
+     * @note Glyphs are submitted with a single SO::Renderer::drawSprites
+     * per atlas page, usually one.
+     */
+    FontAtlas& drawText(TTF_Font* font,
+			const std::string& text,
+			int x, int y,
+			const Color& color = Color::White);
+
+    /**
+     * @brief Draw text laid out by SO::TextLayout.
+     * @param font Font the text was laid out with
+     * @param layout Layout of the text
+     * @param x Left of the layout
+     * @param y Top of the layout
+     * @param color Color of the text
+     * @return FontAtlas&
+     * @throw SO::Error on failure
+     */
+    FontAtlas& drawText(TTF_Font* font,
+			const TextLayout::Layout& layout,
+			int x, int y,
+			const Color& color = Color::White);
+
+    /**
+     * @brief Draw prepared sprites of glyphs.
+     * @param sprites Sprites whose src was set by SO::FontAtlas::place
+     * @param pages Page of each sprite
+     * @param count Number of sprites
+     * @return FontAtlas&
+     * @throw SO::Error on failure
+     * @sa SO::FontAtlas::place
+     */
+    FontAtlas& drawGlyphs(const Sprite* sprites, const Uint32* pages, std::size_t count);
+
+    /**
+     * @brief Get a glyph, rasterizing it if needed.
+     * @param font Font of the glyph, in its current style
+     * @param codepoint Character of the glyph
+     * @return const Glyph&
+     * @throw SO::Error if it can't be rasterized
+     */
+    const Glyph& getGlyph(TTF_Font* font, Uint16 codepoint);
+
+    /**
+     * @brief Set up the sprite of a glyph drawn with its pen at (x, y).
+     * @param font Font of the glyph
+     * @param codepoint Character of the glyph
+     * @param x Pen position
+     * @param y Top of the line
+     * @param color Color of the glyph
+     * @param sprite Sprite to set up
+     * @return Uint32 Atlas page of the sprite
+     * @throw SO::Error if the glyph can't be rasterized
+     */
+    Uint32 place(TTF_Font* font, Uint16 codepoint, int x, int y,
+		 const Color& color, Sprite& sprite);
+
+    /**
+     * @brief Get the atlas the glyphs live in.
+     * @return TextureAtlas&
+     */
+    TextureAtlas& getAtlas();
+
+  private:
+
+    // font index in m_fonts, style and codepoint
+    Uint64 key(TTF_Font* font, Uint16 codepoint);
+
+    Renderer&                          m_renderer;
+    TextureAtlas                       m_atlas;
+
+    std::vector<const TTF_Font*>       m_fonts;
+    std::unordered_map<Uint64, Glyph>  m_glyphs;
+
+    // reused by drawText
+    std::vector<Sprite>                m_sprites;
+    std::vector<Uint32>                m_pages;
+    std::vector<std::vector<Sprite>>   m_batches; // one per page
+  };
+
+}
+
+#endif // _SDL_TTF_H
+
+#endif // FONT_ATLAS_HPP
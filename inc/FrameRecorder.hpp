@@ -0,0 +1,178 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef FRAME_RECORDER_HPP
+#define FRAME_RECORDER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief What SO::FrameRecorder does with a frame when every buffer
+   * is waiting for the writer.
+   */
+  enum class DropPolicy
+  {
+    /** Wait for the writer, the render loop stalls but nothing is lost */
+    Block,
+    /** Drop the frame being captured */
+    Newest,
+    /** Drop the oldest frame not yet written and keep the new one */
+    Oldest
+  };
+
+  /**
+   * @brief Record the output of a SO::Renderer into a Y4M (I420) stream.
+   *
+   * Every N frames, SO::FrameRecorder::capture copies the current target
+   * into one of a fixed number of buffers. A writer thread converts
+   * them to I420 and appends them to the file, so memory use is bounded
+   * by the number of buffers.
+   *
+   * It works with a software renderer created on a SO::Surface, which
+   * allows recording without a display.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class FrameRecorder
+  {
+  public:
+
+    /**
+     * @brief Open a Y4M file and start the writer.
+     * @param renderer Renderer to capture
+     * @param path Path of the file to write
+     * @param width Width of the captured area
+     * @param height Height of the captured area
+     * @param fps Frame rate written in the stream header
+     * @param interval Capture one frame every interval calls of capture
+     * @param buffers Number of frames that can wait for the writer
+     * @param policy What to do when every buffer is waiting
+     * @throw SO::Error if the file can't be opened
+     */
+    explicit FrameRecorder(Renderer& renderer,
+			   const std::string& path,
+			   int width,
+			   int height,
+			   int fps = 60,
+			   int interval = 1,
+			   std::size_t buffers = 4,
+			   DropPolicy policy = DropPolicy::Newest);
+
+    FrameRecorder(const FrameRecorder& orig)            = delete;
+    FrameRecorder(FrameRecorder&& orig)                 = delete;
+    FrameRecorder& operator=(const FrameRecorder& orig) = delete;
+    FrameRecorder& operator=(FrameRecorder&& orig)      = delete;
+
+    /**
+     * @brief Write every pending frame and close the file.
+     */
+    ~FrameRecorder();
+
+    /**
+     * @brief Count a frame and capture it if it's due.
+     * @return FrameRecorder&
+     * @throw SO::Error if reading the pixels or writing the file failed
+     * @note Call it once per frame, before SO::Renderer::present.
+     */
+    FrameRecorder& capture();
+
+    /**
+     * @brief Get the number of frames captured.
+     * @return Uint32
+     */
+    Uint32 getCaptured() const;
+
+    /**
+     * @brief Get the number of frames dropped under backpressure.
+     * @return Uint32
+     */
+    Uint32 getDropped() const;
+
+    /**
+     * @brief Get the number of frames written to the file.
+     * @return Uint32
+     */
+    Uint32 getWritten() const;
+
+    /**
+     * @brief Convert ARGB8888 pixels to planar I420 (BT.601, studio range).
+     * @param pixels Source pixels
+     * @param pitch Length of a source row in bytes
+     * @param width Width in pixels
+     * @param height Height in pixels
+     * @param y Luma plane, width x height bytes
+     * @param u Cb plane, (width + 1) / 2 x (height + 1) / 2 bytes
+     * @param v Cr plane, same size as u
+     * @remark Uses SSE2 when available, with the same result as the
+     * scalar path.
+     */
+    static void toI420(const void* pixels, int pitch,
+		       int width, int height,
+		       Uint8* y, Uint8* u, Uint8* v);
+
+  private:
+
+    void run();
+
+    Renderer&                       m_renderer;
+    SDL_RWops*                      m_file;
+
+    int                             m_width;
+    int                             m_height;
+    int                             m_interval;
+    DropPolicy                      m_policy;
+    Uint32                          m_frame;
+
+    std::vector<std::vector<Uint8>> m_buffers;
+    std::vector<std::vector<Uint8>*> m_free;  // buffers ready to be filled
+    std::deque<std::vector<Uint8>*> m_queue;  // buffers waiting for the writer
+
+    Uint32                          m_captured;
+    Uint32                          m_dropped;
+    Uint32                          m_written;
+    bool                            m_failed;
+
+    mutable std::mutex              m_mutex;
+    std::condition_variable         m_filled;   // a buffer was queued
+    std::condition_variable         m_released; // a buffer was written
+    bool                            m_stop;
+
+    std::thread                     m_writer;
+  };
+
+}
+
+#endif // FRAME_RECORDER_HPP
@@ -0,0 +1,99 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Read-only view of a whole file.
+   *
+   * The file is mapped in memory with mmap where available, and read
+   * into a buffer otherwise. Either way the contents stay valid, and
+   * don't move, until the SO::MappedFile is destroyed.
+   */
+
+  class MappedFile
+  {
+  public:
+
+    /**
+     * @brief Create an empty view.
+     */
+    MappedFile();
+
+    /**
+     * @brief Map a file.
+     * @param path Path of the file
+     * @throw SO::Error if it can't be opened or is empty
+     */
+    explicit MappedFile(const char* path);
+
+    MappedFile(const MappedFile& orig)            = delete;
+    MappedFile& operator=(const MappedFile& orig) = delete;
+
+    /**
+     * @brief Take over the view of orig, which is left empty.
+     */
+    MappedFile(MappedFile&& orig) noexcept;
+
+    /**
+     * @brief Unmap the file and take over the view of orig, which is
+     * left empty.
+     */
+    MappedFile& operator=(MappedFile&& orig) noexcept;
+
+    ~MappedFile();
+
+    /**
+     * @brief Get the contents of the file.
+     * @return const Uint8*, nullptr if empty
+     */
+    const Uint8* getData() const;
+
+    /**
+     * @brief Get the size of the file.
+     * @return std::size_t
+     */
+    std::size_t getSize() const;
+
+  private:
+
+    void unmap();
+
+    const Uint8*       m_data;
+    std::size_t        m_size;
+
+    // copy of the file where it can't be mapped
+    std::vector<Uint8> m_buffer;
+  };
+
+}
+
+#endif // MAPPED_FILE_HPP
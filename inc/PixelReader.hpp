@@ -0,0 +1,169 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PIXEL_READER_HPP
+#define PIXEL_READER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Rect.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Asynchronous pixel readback of a SO::Renderer.
+   *
+   * Each read copies the pixels of the current target, in the target's
+   * own format, into one buffer of a preallocated ring. Conversion to the
+   * requested format and delivery happen on a worker thread, so the
+   * render thread only pays for the raw copy.
+   *
+   * When every buffer of the ring is still waiting for the worker, a new
+   * read blocks until the oldest one is delivered. Memory use is thus
+   * bounded by the size of the ring.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class PixelReader
+  {
+  public:
+
+    /** Pixels delivered by a read */
+    struct Frame
+    {
+      int                width  = 0;
+      int                height = 0;
+      int                pitch  = 0;
+      PixelFormats       format = PixelFormats::Unknown;
+      std::vector<Uint8> pixels;
+    };
+
+    /** Called on the worker thread with each delivered frame, must not throw */
+    using Callback = std::function<void(Frame&)>;
+
+    /**
+     * @brief Create a reader with a ring of buffers.
+     * @param renderer Renderer to read from
+     * @param buffers Number of buffers in the ring
+     * @param width Width to preallocate the buffers for
+     * @param height Height to preallocate the buffers for
+     * @note Buffers grow on demand when a read is larger than
+     * width x height.
+     */
+    explicit PixelReader(Renderer& renderer,
+			 std::size_t buffers = 3,
+			 int width = 0,
+			 int height = 0);
+
+    PixelReader(const PixelReader& orig)            = delete;
+    PixelReader(PixelReader&& orig)                 = delete;
+    PixelReader& operator=(const PixelReader& orig) = delete;
+    PixelReader& operator=(PixelReader&& orig)      = delete;
+
+    /**
+     * @brief Deliver every pending read and stop the worker.
+     */
+    ~PixelReader();
+
+    /**
+     * @brief Read pixels from the current target.
+     * @param rect Area to read
+     * @param format Format of the delivered pixels
+     * @return std::future<Frame>
+     * @throw SO::Error if the copy fails
+     * @note The future holds an SO::Error if the conversion fails.
+     */
+    std::future<Frame> read(const Rect& rect, PixelFormats format);
+
+    /**
+     * @brief Read pixels from the current target.
+     * @param rect Area to read
+     * @param format Format of the delivered pixels
+     * @param callback Called on the worker thread with the frame
+     * @return PixelReader&
+     * @throw SO::Error if the copy fails
+     * @remark Frames whose conversion fails are dropped.
+     */
+    PixelReader& read(const Rect& rect, PixelFormats format, Callback callback);
+
+    /**
+     * @brief Block until every pending read is delivered.
+     * @return PixelReader&
+     */
+    PixelReader& wait();
+
+    /**
+     * @brief Get the number of reads not yet delivered.
+     * @return std::size_t
+     */
+    std::size_t getPending() const;
+
+  private:
+
+    struct Slot
+    {
+      std::vector<Uint8>        raw;
+      int                       width;
+      int                       height;
+      int                       pitch;
+      Uint32                    rawFormat;
+      PixelFormats              format;
+      std::promise<Frame>       promise;
+      Callback                  callback;
+    };
+
+    Slot& acquire();
+
+    void  copy(const Rect& rect, PixelFormats format);
+
+    void  run();
+
+    Renderer&               m_renderer;
+
+    std::vector<Slot>       m_slots;
+    std::size_t             m_next;     // next slot to fill
+    std::deque<Slot*>       m_queue;    // slots waiting for the worker
+    std::size_t             m_busy;     // slots queued or being converted
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_filled;   // a slot was queued
+    std::condition_variable m_released; // a slot was delivered
+    bool                    m_stop;
+
+    std::thread             m_worker;
+  };
+
+}
+
+#endif // PIXEL_READER_HPP
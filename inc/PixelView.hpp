@@ -0,0 +1,487 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PIXEL_VIEW_HPP
+#define PIXEL_VIEW_HPP
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Color.hpp"
+#include "Surface.hpp"
+#include "TextureLock.hpp"
+
+#include <cstddef>
+#include <iterator>
+
+namespace SO
+{
+
+  /**
+   * @brief Layout of a packed pixel format, bits and shift of each channel.
+   *
+   * Channels are expanded to 8 bits as SDL_GetRGBA does and reduced by
+   * truncation as SDL_MapRGBA does. A format without alpha reads as
+   * opaque.
+   */
+
+  template<typename T,
+	   int RBits, int RShift,
+	   int GBits, int GShift,
+	   int BBits, int BShift,
+	   int ABits = 0, int AShift = 0>
+  struct PackedPixelTraits
+  {
+    using Pixel = T;
+
+    static constexpr bool HasAlpha = ABits > 0;
+
+    static constexpr Uint8 expand(Uint32 value, int bits)
+    {
+      return (value & ((1u << bits) - 1)) * 255 / ((1u << bits) - 1);
+    }
+
+    static constexpr Uint32 reduce(Uint8 value, int bits, int shift)
+    {
+      return Uint32(value >> (8 - bits)) << shift;
+    }
+
+    static constexpr Color unpack(Pixel pixel)
+    {
+      return Color(expand(pixel >> RShift, RBits),
+		   expand(pixel >> GShift, GBits),
+		   expand(pixel >> BShift, BBits),
+		   HasAlpha ? expand(pixel >> AShift, ABits) : 0xFF);
+    }
+
+    static constexpr Pixel pack(const Color& color)
+    {
+      return Pixel(reduce(color.getRed(), RBits, RShift)
+		   | reduce(color.getGreen(), GBits, GShift)
+		   | reduce(color.getBlue(), BBits, BShift)
+		   | (HasAlpha ? reduce(color.getAlpha(), ABits, AShift) : 0));
+    }
+  };
+
+  /** Pixel of the 24 bits formats, in memory order */
+  struct Pixel24
+  {
+    Uint8 bytes[3];
+  };
+
+  /**
+   * @brief Layout of a 24 bits format, index in memory of each channel.
+   */
+
+  template<int R, int G, int B>
+  struct BytePixelTraits
+  {
+    using Pixel = Pixel24;
+
+    static constexpr bool HasAlpha = false;
+
+    static constexpr Color unpack(Pixel pixel)
+    {
+      return Color(pixel.bytes[R], pixel.bytes[G], pixel.bytes[B]);
+    }
+
+    static Pixel pack(const Color& color)
+    {
+      Pixel pixel;
+
+      pixel.bytes[R] = color.getRed();
+      pixel.bytes[G] = color.getGreen();
+      pixel.bytes[B] = color.getBlue();
+
+      return pixel;
+    }
+  };
+
+  /**
+   * @brief Storage and conversion of a pixel format, known at compile time.
+   *
+   * Specialized for the packed 8, 16, 24 and 32 bits RGB formats. Indexed,
+   * 10 bits and YUV formats have none.
+   */
+
+  template<PixelFormats F>
+  struct PixelTraits;
+
+  template<> struct PixelTraits<PixelFormats::RGB332>   : PackedPixelTraits<Uint8, 3, 5, 3, 2, 2, 0> {};
+
+  template<> struct PixelTraits<PixelFormats::RGB444>   : PackedPixelTraits<Uint16, 4, 8, 4, 4, 4, 0> {};
+  template<> struct PixelTraits<PixelFormats::RGB555>   : PackedPixelTraits<Uint16, 5, 10, 5, 5, 5, 0> {};
+  template<> struct PixelTraits<PixelFormats::BGR555>   : PackedPixelTraits<Uint16, 5, 0, 5, 5, 5, 10> {};
+  template<> struct PixelTraits<PixelFormats::ARGB4444> : PackedPixelTraits<Uint16, 4, 8, 4, 4, 4, 0, 4, 12> {};
+  template<> struct PixelTraits<PixelFormats::RGBA4444> : PackedPixelTraits<Uint16, 4, 12, 4, 8, 4, 4, 4, 0> {};
+  template<> struct PixelTraits<PixelFormats::ABGR4444> : PackedPixelTraits<Uint16, 4, 0, 4, 4, 4, 8, 4, 12> {};
+  template<> struct PixelTraits<PixelFormats::BGRA4444> : PackedPixelTraits<Uint16, 4, 4, 4, 8, 4, 12, 4, 0> {};
+  template<> struct PixelTraits<PixelFormats::ARGB1555> : PackedPixelTraits<Uint16, 5, 10, 5, 5, 5, 0, 1, 15> {};
+  template<> struct PixelTraits<PixelFormats::RGBA5551> : PackedPixelTraits<Uint16, 5, 11, 5, 6, 5, 1, 1, 0> {};
+  template<> struct PixelTraits<PixelFormats::ABGR1555> : PackedPixelTraits<Uint16, 5, 0, 5, 5, 5, 10, 1, 15> {};
+  template<> struct PixelTraits<PixelFormats::BGRA5551> : PackedPixelTraits<Uint16, 5, 1, 5, 6, 5, 11, 1, 0> {};
+  template<> struct PixelTraits<PixelFormats::RGB565>   : PackedPixelTraits<Uint16, 5, 11, 6, 5, 5, 0> {};
+  template<> struct PixelTraits<PixelFormats::BGR565>   : PackedPixelTraits<Uint16, 5, 0, 6, 5, 5, 11> {};
+
+  template<> struct PixelTraits<PixelFormats::RGB24>    : BytePixelTraits<0, 1, 2> {};
+  template<> struct PixelTraits<PixelFormats::BGR24>    : BytePixelTraits<2, 1, 0> {};
+
+  template<> struct PixelTraits<PixelFormats::RGB888>   : PackedPixelTraits<Uint32, 8, 16, 8, 8, 8, 0> {};
+  template<> struct PixelTraits<PixelFormats::RGBX8888> : PackedPixelTraits<Uint32, 8, 24, 8, 16, 8, 8> {};
+  template<> struct PixelTraits<PixelFormats::BGR888>   : PackedPixelTraits<Uint32, 8, 0, 8, 8, 8, 16> {};
+  template<> struct PixelTraits<PixelFormats::BGRX8888> : PackedPixelTraits<Uint32, 8, 8, 8, 16, 8, 24> {};
+  template<> struct PixelTraits<PixelFormats::ARGB8888> : PackedPixelTraits<Uint32, 8, 16, 8, 8, 8, 0, 8, 24> {};
+  template<> struct PixelTraits<PixelFormats::RGBA8888> : PackedPixelTraits<Uint32, 8, 24, 8, 16, 8, 8, 8, 0> {};
+  template<> struct PixelTraits<PixelFormats::ABGR8888> : PackedPixelTraits<Uint32, 8, 0, 8, 8, 8, 16, 8, 24> {};
+  template<> struct PixelTraits<PixelFormats::BGRA8888> : PackedPixelTraits<Uint32, 8, 8, 8, 16, 8, 24, 8, 0> {};
+
+  /**
+   * @brief Typed access to pixels of a format known at compile time.
+   *
+   * A view neither owns nor locks the pixels, it must not outlive the
+   * SO::TextureLock or the locked SO::Surface it was made from. Pixels
+   * are read and written as PixelTraits<F>::Pixel, or as SO::Color
+   * through SO::PixelView::load and SO::PixelView::store, so loops
+   * compile down to plain loads and stores.
+   *
+   * @code
+   * SO::PixelView<SO::PixelFormats::ARGB8888> view(surface);
+   *
+   * for (int y = 0; y < view.getHeight(); ++y)
+   *   for (Uint32& pixel : view.getRow(y))
+   *     pixel |= 0xFF000000;
+   * @endcode
+   *
+   * @sa SO::visitPixels to pick the view from the format at runtime
+   */
+
+  template<PixelFormats F>
+  class PixelView
+  {
+  public:
+
+    using Traits = PixelTraits<F>;
+    using Pixel  = typename Traits::Pixel;
+
+    static constexpr PixelFormats Format = F;
+
+    /** Pixels of a row */
+    class Span
+    {
+    public:
+
+      Span(Pixel* first, int width) : m_first(first), m_width(width) {}
+
+      Pixel* begin() const { return m_first; }
+
+      Pixel* end() const { return m_first + m_width; }
+
+      int size() const { return m_width; }
+
+      Pixel& operator[](int x) const { return m_first[x]; }
+
+    private:
+
+      Pixel* m_first;
+      int    m_width;
+    };
+
+    /** Every pixel, row after row, skipping the padding between rows */
+    class Iterator
+    {
+    public:
+
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = Pixel;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = Pixel*;
+      using reference         = Pixel&;
+
+      Iterator(const PixelView* view, int x, int y)
+	: m_view(view), m_x(x), m_y(y), m_row(view->getRow(y).begin()) {}
+
+      reference operator*() const { return m_row[m_x]; }
+
+      pointer operator->() const { return m_row + m_x; }
+
+      Iterator& operator++()
+      {
+	if (++m_x == m_view->getWidth())
+	  {
+	    m_x   = 0;
+	    m_row = m_view->getRow(++m_y).begin();
+	  }
+
+	return *this;
+      }
+
+      Iterator operator++(int)
+      {
+	Iterator previous = *this;
+
+	++(*this);
+
+	return previous;
+      }
+
+      bool operator==(const Iterator& other) const { return m_x == other.m_x && m_y == other.m_y; }
+
+      bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+
+      const PixelView* m_view;
+      int              m_x;
+      int              m_y;
+      Pixel*           m_row;
+    };
+
+    /**
+     * @brief View pixels of format F.
+     * @param pixels First pixel
+     * @param pitch Bytes between two rows
+     * @param width Pixels per row
+     * @param height Number of rows
+     */
+    PixelView(void* pixels, int pitch, int width, int height)
+      : m_pixels(static_cast<Uint8*>(pixels)), m_pitch(pitch), m_width(width), m_height(height) {}
+
+    /**
+     * @brief View the pixels of a surface.
+     * @param surface Surface of format F, locked if it needs to be
+     * @throw SO::Error if the format isn't F or the surface must be locked
+     */
+    explicit PixelView(Surface& surface)
+      : PixelView(surface.toSDL()->pixels, surface.toSDL()->pitch, surface.toSDL()->w, surface.toSDL()->h)
+    {
+      const SDL_Surface* sdl = surface.toSDL();
+
+      if (static_cast<PixelFormats>(sdl->format->format) != F)
+	throw Error("PixelView: format mismatch");
+
+      if (SDL_MUSTLOCK(sdl) && sdl->locked == 0)
+	throw Error("PixelView: surface must be locked");
+    }
+
+    /**
+     * @brief View the pixels of a locked texture.
+     * @param lock Lock of a texture of format F
+     * @throw SO::Error if the format isn't F
+     */
+    explicit PixelView(const TextureLock& lock)
+      : PixelView(lock.getPixels(), lock.getPitch(), lock.getWidth(), lock.getHeight())
+    {
+      if (lock.getFormat() != F)
+	throw Error("PixelView: format mismatch");
+    }
+
+    /**
+     * @brief Convert a color to a pixel of format F.
+     * @param color Color, its alpha ignored by formats without one
+     * @return Pixel
+     */
+    static Pixel pack(const Color& color)
+    {
+      return Traits::pack(color);
+    }
+
+    /**
+     * @brief Convert a pixel of format F to a color.
+     * @param pixel Pixel
+     * @return SO::Color, opaque for formats without alpha
+     */
+    static Color unpack(Pixel pixel)
+    {
+      return Traits::unpack(pixel);
+    }
+
+    /**
+     * @brief Get the height of the view.
+     * @return int
+     */
+    int getHeight() const { return m_height; }
+
+    /**
+     * @brief Get the length of a row in bytes.
+     * @return int
+     */
+    int getPitch() const { return m_pitch; }
+
+    /**
+     * @brief Get the width of the view.
+     * @return int
+     */
+    int getWidth() const { return m_width; }
+
+    /**
+     * @brief Get a row of pixels.
+     * @param y Row
+     * @return Span
+     */
+    Span getRow(int y) const
+    {
+      return Span(reinterpret_cast<Pixel*>(m_pixels + y * m_pitch), m_width);
+    }
+
+    /**
+     * @brief Get a pixel.
+     * @param x Column
+     * @param y Row
+     * @return Pixel&
+     */
+    Pixel& at(int x, int y) const
+    {
+      return this->getRow(y)[x];
+    }
+
+    /**
+     * @brief Read the color of a pixel.
+     * @param x Column
+     * @param y Row
+     * @return SO::Color
+     */
+    Color load(int x, int y) const
+    {
+      return Traits::unpack(this->at(x, y));
+    }
+
+    /**
+     * @brief Write the color of a pixel.
+     * @param x Column
+     * @param y Row
+     * @param color Color, its alpha ignored by formats without one
+     */
+    void store(int x, int y, const Color& color) const
+    {
+      this->at(x, y) = Traits::pack(color);
+    }
+
+    Iterator begin() const { return Iterator(this, 0, m_width > 0 ? 0 : m_height); }
+
+    Iterator end() const { return Iterator(this, 0, m_height); }
+
+  private:
+
+    Uint8* m_pixels;
+    int    m_pitch;
+    int    m_width;
+    int    m_height;
+  };
+
+  /**
+   * @brief Call a function with the view matching the format of pixels.
+   *
+   * The function, usually a generic lambda taking `auto view`, is
+   * instantiated for every format having SO::PixelTraits, so its loops
+   * are specialized while the format is only known at runtime.
+   *
+   * @param format Format of the pixels
+   * @param pixels First pixel
+   * @param pitch Bytes between two rows
+   * @param width Pixels per row
+   * @param height Number of rows
+   * @param function Called with a SO::PixelView
+   * @return What function returns, the same type for every view
+   * @throw SO::Error if the format has no SO::PixelTraits
+   */
+  template<typename Function>
+  auto visitPixels(PixelFormats format, void* pixels, int pitch, int width, int height,
+		   Function&& function)
+    -> decltype(function(PixelView<PixelFormats::ARGB8888>(pixels, pitch, width, height)))
+  {
+#define SO_VISIT_PIXELS(F)						\
+    case PixelFormats::F:						\
+      return function(PixelView<PixelFormats::F>(pixels, pitch, width, height))
+
+    switch (format)
+      {
+	SO_VISIT_PIXELS(RGB332);
+	SO_VISIT_PIXELS(RGB444);
+	SO_VISIT_PIXELS(RGB555);
+	SO_VISIT_PIXELS(BGR555);
+	SO_VISIT_PIXELS(ARGB4444);
+	SO_VISIT_PIXELS(RGBA4444);
+	SO_VISIT_PIXELS(ABGR4444);
+	SO_VISIT_PIXELS(BGRA4444);
+	SO_VISIT_PIXELS(ARGB1555);
+	SO_VISIT_PIXELS(RGBA5551);
+	SO_VISIT_PIXELS(ABGR1555);
+	SO_VISIT_PIXELS(BGRA5551);
+	SO_VISIT_PIXELS(RGB565);
+	SO_VISIT_PIXELS(BGR565);
+	SO_VISIT_PIXELS(RGB24);
+	SO_VISIT_PIXELS(BGR24);
+	SO_VISIT_PIXELS(RGB888);
+	SO_VISIT_PIXELS(RGBX8888);
+	SO_VISIT_PIXELS(BGR888);
+	SO_VISIT_PIXELS(BGRX8888);
+	SO_VISIT_PIXELS(ARGB8888);
+	SO_VISIT_PIXELS(RGBA8888);
+	SO_VISIT_PIXELS(ABGR8888);
+	SO_VISIT_PIXELS(BGRA8888);
+
+      default:
+	throw Error("PixelView: unsupported pixel format");
+      }
+
+#undef SO_VISIT_PIXELS
+  }
+
+  /**
+   * @brief Call a function with the view matching the format of a surface.
+   * @param surface Surface, locked if it needs to be
+   * @param function Called with a SO::PixelView
+   * @return What function returns
+   * @throw SO::Error if the format is unsupported or the surface must be
+   * locked
+   */
+  template<typename Function>
+  auto visitPixels(Surface& surface, Function&& function)
+    -> decltype(visitPixels(PixelFormats::Unknown, nullptr, 0, 0, 0, function))
+  {
+    SDL_Surface* sdl = surface.toSDL();
+
+    if (SDL_MUSTLOCK(sdl) && sdl->locked == 0)
+      throw Error("PixelView: surface must be locked");
+
+    return visitPixels(static_cast<PixelFormats>(sdl->format->format),
+		       sdl->pixels, sdl->pitch, sdl->w, sdl->h, function);
+  }
+
+  /**
+   * @brief Call a function with the view matching the format of a locked
+   * texture.
+   * @param lock Lock of the texture
+   * @param function Called with a SO::PixelView
+   * @return What function returns
+   * @throw SO::Error if the format is unsupported
+   */
+  template<typename Function>
+  auto visitPixels(const TextureLock& lock, Function&& function)
+    -> decltype(visitPixels(PixelFormats::Unknown, nullptr, 0, 0, 0, function))
+  {
+    return visitPixels(lock.getFormat(), lock.getPixels(), lock.getPitch(),
+		       lock.getWidth(), lock.getHeight(), function);
+  }
+
+}
+
+#endif // PIXEL_VIEW_HPP
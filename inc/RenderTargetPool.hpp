@@ -0,0 +1,181 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RENDER_TARGET_POOL_HPP
+#define RENDER_TARGET_POOL_HPP
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Texture.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Pool of render target textures.
+   *
+   * Targets are keyed by their width, height and pixel format. They are
+   * handed out as SO::RenderTargetPool::Lease objects, which give the
+   * texture back to the pool when destroyed. Targets unused for longer
+   * than the idle timeout are destroyed by SO::RenderTargetPool::trim,
+   * and every idle target when SO::TextureMemory runs over its budget.
+   *
+   * The content of a reused target is undefined, clear it before use.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class RenderTargetPool
+  {
+  private:
+
+    using Key = std::tuple<int, int, PixelFormats>;
+
+  public:
+
+    /**
+     * @brief Exclusive use of a pooled target, returned on destruction.
+     * @warning The pool must outlive its leases.
+     */
+    class Lease
+    {
+    public:
+
+      Lease() = default;
+
+      Lease(const Lease& orig)            = delete;
+      Lease& operator=(const Lease& orig) = delete;
+
+      Lease(Lease&& orig);
+      Lease& operator=(Lease&& orig);
+
+      ~Lease();
+
+      /**
+       * @brief Give the texture back to the pool before destruction.
+       */
+      void release();
+
+      /** Return false once released */
+      explicit operator bool() const { return m_texture != nullptr; }
+
+      Texture& operator*()  const { return *m_texture; }
+      Texture* operator->() const { return m_texture.get(); }
+      Texture* get()        const { return m_texture.get(); }
+
+    private:
+
+      friend class RenderTargetPool;
+
+      Lease(RenderTargetPool* pool, const Key& key, std::unique_ptr<Texture> texture);
+
+      RenderTargetPool*        m_pool = nullptr;
+      Key                      m_key;
+      std::unique_ptr<Texture> m_texture;
+    };
+
+    /**
+     * @brief Create an empty pool.
+     * @param renderer Renderer the targets are created with
+     * @param idleTimeout Milliseconds an unused target is kept
+     */
+    explicit RenderTargetPool(Renderer& renderer, Uint32 idleTimeout = 5000);
+
+    RenderTargetPool(const RenderTargetPool& orig)            = delete;
+    RenderTargetPool(RenderTargetPool&& orig)                 = delete;
+    RenderTargetPool& operator=(const RenderTargetPool& orig) = delete;
+    RenderTargetPool& operator=(RenderTargetPool&& orig)      = delete;
+
+    ~RenderTargetPool();
+
+    /**
+     * @brief Lease a target, reusing an idle one when possible.
+     * @param width Width of the target
+     * @param height Height of the target
+     * @param format Pixel format of the target
+     * @return Lease
+     * @throw SO::Error if a new texture can't be created
+     * @note Idle targets are trimmed first.
+     */
+    Lease acquire(int width, int height,
+		  PixelFormats format = PixelFormats::ARGB8888);
+
+    /**
+     * @brief Destroy targets idle for longer than the timeout.
+     * @return RenderTargetPool&
+     */
+    RenderTargetPool& trim();
+
+    /**
+     * @brief Destroy every idle target.
+     * @return RenderTargetPool&
+     */
+    RenderTargetPool& clear();
+
+    /**
+     * @brief Get the number of targets waiting in the pool.
+     * @return std::size_t
+     */
+    std::size_t getIdle() const;
+
+    /**
+     * @brief Get the number of targets currently leased.
+     * @return std::size_t
+     */
+    std::size_t getLeased() const;
+
+    /**
+     * @brief Set how long an unused target is kept.
+     * @param idleTimeout Timeout in milliseconds
+     * @return RenderTargetPool&
+     */
+    RenderTargetPool& setIdleTimeout(Uint32 idleTimeout);
+
+  private:
+
+    struct Idle
+    {
+      std::unique_ptr<Texture> texture;
+      Uint32                   since; // SDL_GetTicks when it was returned
+    };
+
+    void giveBack(const Key& key, std::unique_ptr<Texture> texture);
+
+    Renderer&                        m_renderer;
+    Uint32                           m_idleTimeout;
+    std::map<Key, std::vector<Idle>> m_idle;
+    std::size_t                      m_idleCount;
+    std::size_t                      m_leased;
+
+    TextureMemory::Handle            m_budgetCallback;
+  };
+
+}
+
+#endif // RENDER_TARGET_POOL_HPP
@@ -32,6 +32,8 @@
 
 #include <vector>
 #include <utility>
+#include <iterator>
+#include <type_traits>
 
 #include "Utils.hpp"
 #include "Error.hpp"
@@ -40,14 +42,55 @@
 #include "Color.hpp"
 #include "Texture.hpp"
 #include "Window.hpp"
+#include "Surface.hpp"
+#include "Sprite.hpp"
+#include "DamageTracker.hpp"
 
 
 namespace SO
 {
 
+  /**
+   * @brief Per-frame counters of a SO::Renderer.
+   *
+   * Calls are counted as they reach SDL, so a deferred renderer reports
+   * the batched calls, not the individual draws. Define
+   * SO_NO_RENDERER_STATS when building the library to compile the
+   * counting out.
+   */
+  struct RendererStats
+  {
+    Uint32 clearCalls    = 0;
+    Uint32 pointCalls    = 0;
+    Uint32 lineCalls     = 0;
+    Uint32 rectCalls     = 0;
+    Uint32 fillRectCalls = 0;
+    Uint32 copyCalls     = 0; // SDL_RenderCopy and SDL_RenderCopyEx
+    Uint32 geometryCalls = 0; // SDL_RenderGeometry
+    Uint32 textureBinds  = 0; // copies from a different texture than the last one
+    Uint32 stateChanges  = 0;
+    Uint64 pixelsFilled  = 0; // area covered by filled rects
+    Uint64 pixelsCopied  = 0; // area covered by texture copies
+    double presentTime   = 0; // milliseconds spent inside present
+
+    /** Total number of draw calls sent to SDL */
+    Uint32 drawCalls() const
+    {
+      return clearCalls + pointCalls + lineCalls + rectCalls
+	+ fillRectCalls + copyCalls + geometryCalls;
+    }
+  };
+
   /**
    * @brief Wrapper class for **SDL_Renderer**.
    *
+   * The renderer keeps a shadow copy of its render state (draw color,
+   * blend mode, viewport, clip rect, scale and target). Getters are
+   * served from it and setting a state to its current value doesn't
+   * reach SDL. The copy is refreshed from SDL at each present, so
+   * changes made directly through SO::Renderer::toSDL() are only seen
+   * after the next frame.
+   *
    * **SDL 2.0.0**
    */
   
@@ -88,6 +131,19 @@ namespace SO
                       Uint32 flags = Renderer::Null,
                       int index = -1);
 
+    /**
+     * @brief Explicit constructor for Class SO::Renderer.
+     *
+     * Create a software 2D rendering context drawing into a SO::Surface.
+     * No window is needed, which allows headless rendering.
+     *
+     * @param surface the surface where rendering is done, it must
+     * outlive the renderer
+     * @throw SO::Error if there was an error
+     * @sa SO::Renderer:~Renderer
+     */
+    explicit Renderer(Surface& surface);
+
 
     // rules of five
     Renderer(const Renderer& orig)             = delete;
@@ -184,6 +240,43 @@ namespace SO
     Pair<float> getScale() const;
 #endif
 
+    /**
+     * @brief Return the number of render state changes actually sent to SDL
+     * since the last call to SO::Renderer::present.
+     * @return Uint32
+     * @note Setting a state to the value it already has is skipped and
+     * not counted. Always 0 when built with SO_NO_RENDERER_STATS.
+     */
+    Uint32 getStateChanges() const;
+
+    /**
+     * @brief Get the statistics of the last presented frame.
+     * @return const RendererStats&
+     * @note Counters are collected while the next frame is drawn and
+     * published by SO::Renderer::present. Always zero when built with
+     * SO_NO_RENDERER_STATS.
+     * @sa SO::RendererStats
+     */
+    const RendererStats& stats() const;
+
+    /**
+     * @brief Return the regions damaged since the last present.
+     * @return const SO::DamageTracker&
+     * @note Regions are in pixels of the output. Right after a present,
+     * they hold what was invalidated, or the whole output if the back
+     * buffer was lost.
+     * @sa SO::Renderer::setDamageTracking
+     */
+    const DamageTracker& getDamage() const;
+
+    /**
+     * @brief Return whether damage tracking is enabled.
+     * @return bool
+     * @sa SO::Renderer::setDamageTracking
+     */
+    bool isDamageTracking() const;
+
+
     /**
      * @brief Return the current renderer's target.
      * @return SDL_Texture*
@@ -225,6 +318,15 @@ namespace SO
 #endif    
 
 
+    /**
+     * @brief Return wheter the renderer records its drawing operations
+     * instead of sending them to SDL immediately.
+     * @return bool
+     * @sa SO::Renderer::setDeferred
+     */
+    bool isDeferred() const;
+
+
     // set methods
 
     /**
@@ -238,6 +340,59 @@ namespace SO
     Renderer& setClipRect(const Rect& rect);
 
 
+    /**
+     * @brief Enable or disable the deferred mode of the renderer.
+     *
+     * In deferred mode, drawing operations (points, lines, rects, copies
+     * and clear) are recorded into a preallocated command list instead of
+     * being sent to SDL. Adjacent commands sharing the same texture, draw
+     * color and blend mode are merged, then the whole list is submitted
+     * by SO::Renderer::flush or SO::Renderer::present.
+     * @param enable
+     * @param capacity number of commands to preallocate
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * With SDL 2.0.18 or later, a run of copies from the same texture is
+     * submitted as a single SDL_RenderGeometry call. Rotated copies are
+     * submitted one SDL_RenderCopyEx call each.
+     * @warning Texture's color mod, alpha mod and blend mode are read by SDL
+     * when the commands are flushed, not when they are recorded.
+     * @note Destroying a SO::Texture flushes the pending commands copying
+     * from it first, the list never refers to a destroyed texture.
+     * @note Disabling the deferred mode flushes the pending commands.
+     * @sa SO::Renderer::flush
+     */
+    Renderer& setDeferred(bool enable, std::size_t capacity = 4096);
+
+    /**
+     * @brief Enable or disable damage tracking.
+     *
+     * When enabled, the default target is replaced by a back buffer
+     * texture which keeps its content from one frame to the next. Every
+     * draw records the area it touches, and SO::Renderer::present skips
+     * frames where nothing was drawn. A scene then only needs to redraw
+     * what changed, see SO::Renderer::invalidate.
+     *
+     * @param enable true to enable damage tracking
+     * @return SO::Renderer&
+     * @throw SO::Error if render targets aren't supported or on failure
+     * @note A batch of points or rects is damaged as its bounding box.
+     * @warning The logical size and scale of the default target don't
+     * apply to the back buffer.
+     */
+    Renderer& setDamageTracking(bool enable);
+
+
+    /**
+     * @brief Set the blend mode used for drawing operations (Fill and Line).
+     * @param blendMode
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @sa SO::Renderer::getDrawBlendMode
+     */
+    Renderer& setDrawBlendMode(BlendModes blendMode);
+
+
     /**
      * @brief Set the color for drawing operation.
      * @param c the color
@@ -298,12 +453,23 @@ namespace SO
     /**
      * @brief Set a texture as the current rendering target.
      * @param texture the targeted texture, which must be created with the SO::TextureAccessTarget
-     * flag, or NULL for the default render target
-     * @return bool
+     * flag
+     * @return bool false if the renderer doesn't support render targets
      * @throw SO::Error on failure
      * @version **SDL2.0.0**
+     * @sa SO::Renderer::resetTarget
+     * @sa SO::Renderer::pushTarget
      */
     bool setTarget(Texture& texture);
+
+    /**
+     * @brief Restore the default rendering target.
+     * @return bool false if the renderer doesn't support render targets
+     * @throw SO::Error on failure
+     * @version **SDL2.0.0**
+     * @sa SO::Renderer::setTarget
+     */
+    bool resetTarget();
 #endif
 
     /**
@@ -370,9 +536,66 @@ namespace SO
 		     const Point* center = NULL,
 		     const Flip flip = Flip::Null);
     
+    /**
+     * @brief Draw the outline of a circle on the renderer.
+     * @param x0
+     * @param y0
+     * @param r the radius
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note The outline is rasterized into a scratch buffer and submitted
+     * with a single call to **SDL_RenderDrawPoints**.
+     */
     Renderer& drawCircle(int x0, int y0, int r);
 
+    /**
+     * @brief Draw many sprites of the same texture on the renderer at once.
+     * @param texture the source texture
+     * @param sprites the sprites to draw, in order
+     * @param count number of sprites
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note With **SDL 2.0.18** and up, sprites are turned into textured
+     * quads (rotation and flipping done on the CPU) and submitted with a
+     * single call to **SDL_RenderGeometry**. Older versions fall back to
+     * one **SDL_RenderCopyEx** per sprite.
+     * @sa SO::Sprite
+     */
+    Renderer& drawSprites(Texture& texture, const Sprite* sprites, std::size_t count);
+
+    Renderer& drawSprites(Texture& texture, const std::vector<Sprite>& sprites);
+
+    /**
+     * @brief Draw the outlines of many circles on the renderer at once.
+     * @param circles pairs of center and radius
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     */
+    Renderer& drawCircles(const std::vector<Pair<Point, int>>& circles);
+
+    Renderer& drawCircles(const Pair<Point, int>* circles, std::size_t count);
+
+    /**
+     * @brief Draw a filled circle on the renderer.
+     * @param x0
+     * @param y0
+     * @param r the radius
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note The disc is rasterized into one span per row and submitted
+     * with a single call to **SDL_RenderFillRects**.
+     */
     Renderer& fillCircle(int x0, int y0, int r);
+
+    /**
+     * @brief Draw many filled circles on the renderer at once.
+     * @param circles pairs of center and radius
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     */
+    Renderer& fillCircles(const std::vector<Pair<Point, int>>& circles);
+
+    Renderer& fillCircles(const Pair<Point, int>* circles, std::size_t count);
  
     /**
      * @brief Draw a line on the renderer.
@@ -389,22 +612,147 @@ namespace SO
 
     Renderer& drawLine(const Pair<Point>& points);
 
+    /**
+     * @brief Draw a series of connected lines on the renderer.
+     * @param points the points along the lines
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     */
     Renderer& drawLines(const std::vector<Point>& points);
 
+    Renderer& drawLines(const Point* points, std::size_t count);
+
+    /**
+     * @brief Draw a series of connected lines from a range of points.
+     * @param first
+     * @param last
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note Pointers and std::vector iterators over SO::Point are handed
+     * to SDL as is. Other ranges are copied into a reused scratch buffer,
+     * their elements only need to be convertible to SO::Point.
+     */
+    template<typename InputIt>
+    Renderer& drawLines(InputIt first, InputIt last);
+
+    /**
+     * @brief Draw a series of connected lines from separate coordinates buffers.
+     * @param x the first x coordinate
+     * @param y the first y coordinate
+     * @param count number of points
+     * @param stride distance in bytes between two consecutive x (or y)
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note Works for structure-of-arrays buffers (the default stride)
+     * as well as for arrays of structures. Interleaved x, y pairs are
+     * handed to SDL without copying.
+     */
+    Renderer& drawLines(const int* x, const int* y,
+			std::size_t count,
+			std::size_t stride = sizeof(int));
+
     Renderer& drawPoint(int x, int y);
 
     Renderer& drawPoint(const Point& p);
 
     Renderer& drawPoints(const std::vector<Point>& points);
 
+    Renderer& drawPoints(const Point* points, std::size_t count);
+
+    template<typename InputIt>
+    Renderer& drawPoints(InputIt first, InputIt last);
+
+    Renderer& drawPoints(const int* x, const int* y,
+			 std::size_t count,
+			 std::size_t stride = sizeof(int));
+
     Renderer& drawRect(const Rect& rect);
 
     Renderer& drawRects(const std::vector<Rect>& rects);
 
+    Renderer& drawRects(const Rect* rects, std::size_t count);
+
+    template<typename InputIt>
+    Renderer& drawRects(InputIt first, InputIt last);
+
+    /**
+     * @brief Draw rectangles from separate coordinates buffers.
+     * @param x
+     * @param y
+     * @param w
+     * @param h
+     * @param count number of rectangles
+     * @param stride distance in bytes between two consecutive x (or y, w, h)
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @sa SO::Renderer::drawLines
+     */
+    Renderer& drawRects(const int* x, const int* y, const int* w, const int* h,
+			std::size_t count,
+			std::size_t stride = sizeof(int));
+
     Renderer& fillRect(const Rect& rect);
 
     Renderer& fillRects(const std::vector<Rect>& rects);
 
+    Renderer& fillRects(const Rect* rects, std::size_t count);
+
+    template<typename InputIt>
+    Renderer& fillRects(InputIt first, InputIt last);
+
+    Renderer& fillRects(const int* x, const int* y, const int* w, const int* h,
+			std::size_t count,
+			std::size_t stride = sizeof(int));
+
+
+    /**
+     * @brief Submit to SDL every command recorded in deferred mode.
+     * @return SO::Renderer&
+     * @throw SO::Error on failure
+     * @note Does nothing if the renderer is not in deferred mode.
+     * @sa SO::Renderer::setDeferred
+     */
+    Renderer& flush();
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+    /**
+     * @brief Make a texture the rendering target, remembering the
+     * current one.
+     * @param texture the targeted texture, which must be created with
+     * the SO::TextureAccess::Target flag
+     * @return Renderer&
+     * @throw SO::Error if render targets aren't supported or on failure
+     * @note On failure, nothing is pushed.
+     * @version **SDL2.0.0**
+     * @sa SO::Renderer::popTarget
+     */
+    Renderer& pushTarget(Texture& texture);
+
+    /**
+     * @brief Mark an area of the output as needing to be redrawn.
+     *
+     * Typical use is to invalidate what changed, then redraw the scene
+     * clipped to each rect of SO::Renderer::getDamage. Draws clipped to
+     * a damaged rect don't change the damage, so the rects can be
+     * iterated while drawing.
+     *
+     * @param rect area in pixels of the output
+     * @return SO::Renderer&
+     * @note Does nothing if damage tracking is disabled.
+     */
+    Renderer& invalidate(const Rect& rect);
+
+    /**
+     * @brief Restore the rendering target active before the matching
+     * SO::Renderer::pushTarget.
+     * @return Renderer&
+     * @throw SO::Error if the stack is empty or on failure
+     * @version **SDL2.0.0**
+     * @sa SO::Renderer::pushTarget
+     */
+    Renderer& popTarget();
+#endif
+
 
     /**
      * @brief Update the renderer with any rendering perfomed since the previous call.
@@ -444,6 +792,7 @@ namespace SO
      * @return SO::Renderer&
      * @throw SO::Error on failure
      * @remark This is a very slow operation, and should not be used frequently.
+     * SO::PixelReader reads without stalling the render loop.
      */
     Renderer& readPixels(const Rect& rect, PixelFormats format, void* pixels, int pitch); // Need to be change in the future
     
@@ -464,10 +813,232 @@ namespace SO
 
   private:
 
+    friend class Texture;
+
+    enum class Command : Uint8
+    {
+      Clear,
+      Points,
+      Lines,
+      Rects,
+      FillRects,
+      Copy,
+      CopyEx
+    };
+
+    // A recorded drawing operation. Its geometry lives in one of the
+    // payload buffers, starting at first.
+    struct DrawCommand
+    {
+      Command       type;
+      SDL_BlendMode blendMode;
+      SDL_Color     color;
+      SDL_Texture*  texture;
+      Uint32        first;
+      Uint32        count;
+    };
+
+    struct CopyExArgs
+    {
+      SDL_Rect         src;
+      SDL_Rect         dst;
+      double           angle;
+      SDL_Point        center;
+      bool             hasCenter;
+      SDL_RendererFlip flip;
+    };
+
+    void init();
+
+    // Called by SO::Texture before destroying texture, so that no live
+    // renderer keeps referring to it
+    static void release(SDL_Texture* texture) noexcept;
+
+    // Called by SO::Texture before writing to the pixels of texture, so
+    // that pending copies from it draw what they were given
+    static void modifying(SDL_Texture* texture);
+
+    void forget(SDL_Texture* texture);
+
+    void flushCopiesFrom(SDL_Texture* texture);
+
+    bool applyTarget(SDL_Texture* texture);
+
+    void createBackBuffer();
+
+    void touch(const SDL_Rect& area);
+
+    DrawCommand& record(Command type, SDL_Texture* texture, Uint32 first);
+
+    void submit(const DrawCommand& command);
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    bool gatherCopies(const DrawCommand& command);
+#endif
+
+    void applyDrawState(const SDL_Color& color, SDL_BlendMode blendMode);
+
+    void syncState();
+
+    void submitPoints(Command type, const SDL_Point* points, std::size_t count);
+
+    void submitRects(Command type, const SDL_Rect* rects, std::size_t count);
+
+    void countDraw(Command type, const SDL_Rect* rects, std::size_t count);
+
+    void countCopy(SDL_Texture* texture, const SDL_Rect* dst, Uint32 calls);
+
+    void countPixels(const SDL_Rect* dst);
+
+    const SDL_Point* gatherPoints(const int* x, const int* y,
+				  std::size_t count,
+				  std::size_t stride);
+
+    const SDL_Rect* gatherRects(const int* x, const int* y,
+				const int* w, const int* h,
+				std::size_t count,
+				std::size_t stride);
+
+    // Contiguous ranges of T, whose memory can be handed to SDL directly
+    template<typename It, typename T>
+    using IsContiguous = std::integral_constant<bool,
+      std::is_same<It, T*>::value ||
+      std::is_same<It, const T*>::value ||
+      std::is_same<It, typename std::vector<T>::iterator>::value ||
+      std::is_same<It, typename std::vector<T>::const_iterator>::value>;
+
+    template<typename InputIt>
+    void submitPointRange(Command type, InputIt first, InputIt last, std::true_type);
+
+    template<typename InputIt>
+    void submitPointRange(Command type, InputIt first, InputIt last, std::false_type);
+
+    template<typename InputIt>
+    void submitRectRange(Command type, InputIt first, InputIt last, std::true_type);
+
+    template<typename InputIt>
+    void submitRectRange(Command type, InputIt first, InputIt last, std::false_type);
+
     SDL_Renderer* m_renderer; // wrapped object
 
+    bool          m_deferred;
+
+    // shadow copy of the render state, getters are served from here
+    Color         m_drawColor;
+    SDL_BlendMode m_drawBlendMode;
+    SDL_Color     m_appliedColor;     // draw color SDL actually has
+    SDL_BlendMode m_appliedBlendMode; // draw blend mode SDL actually has
+    Rect          m_viewport;
+    Rect          m_clipRect;
+    bool          m_clipEnabled;
+    Pair<float>   m_scale;
+    SDL_Texture*  m_target;
+    bool          m_targetSupported;
+
+    std::vector<SDL_Texture*> m_targetStack; // targets saved by pushTarget
+
+    bool          m_damageTracking;
+    SDL_Texture*  m_backBuffer;   // stands for the default target when tracking
+    DamageTracker m_damage;
+
+    RendererStats m_stats;        // frame being recorded
+    RendererStats m_frameStats;   // last presented frame
+    SDL_Texture*  m_boundTexture; // last texture copied from, to count binds
+
+    std::vector<DrawCommand> m_commands;
+    std::vector<SDL_Point>   m_points;
+    std::vector<SDL_Rect>    m_rects;
+    std::vector<CopyExArgs>  m_copiesEx;
+
+    // scratch buffers reused by the rasterizers
+    std::vector<SDL_Point>   m_scratchPoints;
+    std::vector<SDL_Rect>    m_scratchRects;
+    std::vector<int>         m_scratchSpans;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex>  m_vertices;
+    std::vector<int>         m_indices;
+#endif
+
   };
 
+
+  // Template methods of class Renderer
+
+  template<typename InputIt>
+  Renderer& Renderer::drawLines(InputIt first, InputIt last)
+  {
+    this->submitPointRange(Command::Lines, first, last, IsContiguous<InputIt, Point>());
+    return *this;
+  }
+
+  template<typename InputIt>
+  Renderer& Renderer::drawPoints(InputIt first, InputIt last)
+  {
+    this->submitPointRange(Command::Points, first, last, IsContiguous<InputIt, Point>());
+    return *this;
+  }
+
+  template<typename InputIt>
+  Renderer& Renderer::drawRects(InputIt first, InputIt last)
+  {
+    this->submitRectRange(Command::Rects, first, last, IsContiguous<InputIt, Rect>());
+    return *this;
+  }
+
+  template<typename InputIt>
+  Renderer& Renderer::fillRects(InputIt first, InputIt last)
+  {
+    this->submitRectRange(Command::FillRects, first, last, IsContiguous<InputIt, Rect>());
+    return *this;
+  }
+
+  template<typename InputIt>
+  void Renderer::submitPointRange(Command type, InputIt first, InputIt last, std::true_type)
+  {
+    const std::size_t count = std::distance(first, last);
+
+    if (count != 0)
+      this->submitPoints(type, (const SDL_Point*)&*first, count);
+  }
+
+  template<typename InputIt>
+  void Renderer::submitPointRange(Command type, InputIt first, InputIt last, std::false_type)
+  {
+    m_scratchPoints.clear();
+
+    for (; first != last; ++first)
+    {
+      const Point point = *first;
+      m_scratchPoints.push_back({point.getX(), point.getY()});
+    }
+
+    this->submitPoints(type, m_scratchPoints.data(), m_scratchPoints.size());
+  }
+
+  template<typename InputIt>
+  void Renderer::submitRectRange(Command type, InputIt first, InputIt last, std::true_type)
+  {
+    const std::size_t count = std::distance(first, last);
+
+    if (count != 0)
+      this->submitRects(type, (const SDL_Rect*)&*first, count);
+  }
+
+  template<typename InputIt>
+  void Renderer::submitRectRange(Command type, InputIt first, InputIt last, std::false_type)
+  {
+    m_scratchRects.clear();
+
+    for (; first != last; ++first)
+    {
+      const Rect rect = *first;
+      m_scratchRects.push_back({rect.getX(), rect.getY(),
+				rect.getWidth(), rect.getHeight()});
+    }
+
+    this->submitRects(type, m_scratchRects.data(), m_scratchRects.size());
+  }
+
 }
 
 #endif /* RENDERER_HPP */
@@ -10,15 +10,33 @@
 #include <SDL2/SDL_ttf.h>
 
 // lib import
+#include "AssetPack.hpp"
+#include "BakedImage.hpp"
+#include "Blitter.hpp"
 #include "Color.hpp"
+#include "DamageTracker.hpp"
 #include "Error.hpp"
 #include "Event.hpp"
+#include "FontAtlas.hpp"
+#include "FrameRecorder.hpp"
+#include "MappedFile.hpp"
 #include "PixelFormat.hpp"
+#include "PixelReader.hpp"
+#include "PixelView.hpp"
 #include "Point.hpp"
 #include "Rect.hpp"
+#include "RenderTargetPool.hpp"
 #include "Renderer.hpp"
+#include "SkylinePacker.hpp"
+#include "Sprite.hpp"
 #include "Surface.hpp"
+#include "TextLayout.hpp"
 #include "Texture.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureCache.hpp"
+#include "TextureLoader.hpp"
+#include "TextureLock.hpp"
+#include "TextureMemory.hpp"
 #include "Utils.hpp"
 #include "Window.hpp"
 #include "WindowSurface.hpp"
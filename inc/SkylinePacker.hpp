@@ -0,0 +1,98 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SKYLINE_PACKER_HPP
+#define SKYLINE_PACKER_HPP
+
+#include <vector>
+
+#include "Utils.hpp"
+#include "Rect.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Pack rectangles into a fixed size area.
+   *
+   * The packer keeps the skyline formed by the top edges of the rects
+   * placed so far. Each rect goes where its bottom is the lowest, ties
+   * going to the spot which wastes the least width.
+   */
+
+  class SkylinePacker
+  {
+  public:
+
+    /**
+     * @brief Create a packer for an empty area.
+     * @param width Width of the area
+     * @param height Height of the area
+     */
+    SkylinePacker(int width, int height);
+
+    /**
+     * @brief Find room for a rect and reserve it.
+     * @param width Width of the rect
+     * @param height Height of the rect
+     * @param rect Set to the reserved area on success
+     * @return bool false if there's no room left
+     */
+    bool insert(int width, int height, Rect& rect);
+
+    /**
+     * @brief Free the whole area.
+     * @return SkylinePacker&
+     */
+    SkylinePacker& clear();
+
+    /**
+     * @brief Get the fraction of the area covered by inserted rects.
+     * @return float
+     */
+    float getOccupancy() const;
+
+    int getHeight() const;
+
+    int getWidth() const;
+
+  private:
+
+    struct Segment
+    {
+      int x;
+      int y;     // top of the skyline over the segment
+      int width;
+    };
+
+    // Lowest y a rect of this width can sit at from segment, or -1
+    int fit(std::size_t segment, int width, int height) const;
+
+    int                  m_width;
+    int                  m_height;
+    Uint64               m_used;
+    std::vector<Segment> m_skyline;
+  };
+
+}
+
+#endif // SKYLINE_PACKER_HPP
@@ -0,0 +1,54 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SPRITE_HPP
+#define SPRITE_HPP
+
+#include "Utils.hpp"
+
+#include "Rect.hpp"
+#include "Color.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief One entry of a sprite batch drawn by SO::Renderer::drawSprites.
+   */
+
+  struct Sprite
+  {
+    /** Area of the texture to draw, an empty Rect for the whole texture */
+    Rect   src;
+    /** Area of the target to draw into */
+    Rect   dst;
+    /** Color and alpha the texture is modulated with */
+    Color  colorMod = Color(0xFF, 0xFF, 0xFF, 0xFF);
+    /** Clockwise rotation in degrees around the center of dst */
+    double angle    = 0;
+    /** Flipping applied to the texture */
+    Flip   flip     = Flip::Null;
+  };
+
+}
+
+#endif // SPRITE_HPP
@@ -5,11 +5,14 @@
 #include "Rect.hpp"
 #include "Error.hpp"
 
+#include <string>
 #include <utility>
 
 namespace SO
 {
 
+  class AssetPack; // Forward declaration
+
   class Surface
   {
   public:
@@ -24,8 +27,29 @@ namespace SO
 
     explicit Surface(SDL_Surface* surface);
 
+    /**
+     * @brief Load an image.
+     * @param path Path of the image
+     * @param stretch Surface whose format the image is converted to, or
+     * nullptr to keep it as loaded
+     * @throw SO::Error on failure
+     * @remark Conversions between common formats go through the kernels
+     * of SO::Blitter::convert instead of SDL_ConvertSurface.
+     */
     Surface(const char* path, const Surface* const stretch = nullptr);
 
+    /**
+     * @brief Load an image stored in an asset pack, without copying the
+     * encoded data.
+     * @param pack Pack of the image
+     * @param name Name of the entry
+     * @param stretch Surface whose format the image is converted to, or
+     * nullptr to keep it as loaded
+     * @throw SO::Error on failure
+     */
+    Surface(const AssetPack& pack, const std::string& name,
+	    const Surface* const stretch = nullptr);
+
     virtual ~Surface();
 
 
@@ -71,6 +95,12 @@ namespace SO
      * Blits with negative dstRect coordinates will be clipped properly. The final
      * blit rectangle is saved in dstRect after all clipping is performed (srcRect
      * is not modified).
+     * @remark ARGB8888 surfaces blended onto ARGB8888 or RGB888 ones,
+     * without color or alpha modulation nor color key, go through the
+     * SIMD kernels of SO::Blitter instead of SDL. Channels may differ by
+     * up to 2 from SDL's, which approximates the division by 255.
+     * @remark Large blits, and copies between surfaces of the same format
+     * without blending, are split across threads as SO::Blitter describes.
      */
     Surface& blit(const Rect& srcRect, Surface& dst, Rect& dstRect);
 
@@ -93,16 +123,39 @@ namespace SO
      * @param srcRect
      * @param dst
      * @param dstRect
+     * @param filter Sampling of the source pixels
      * @return SO::Surface&
      * @throw SO::Error on failure.
+     * @remark Scaled blits needing no clipping go through SO::Blitter,
+     * split across threads when large, if they blend as SO::Surface::blit
+     * does or copy 32 bits pixels between surfaces of the same format.
+     * @remark SO::ScaleFilters::Linear and SO::ScaleFilters::Box always
+     * go through SO::Blitter. Other formats, modulations, color keys and
+     * clipping are then handled by blitting a scaled ARGB8888 copy.
      */
-    Surface& blitScaled(const Rect& srcRect, Surface& dst, Rect& dstRect);
+    Surface& blitScaled(const Rect& srcRect, Surface& dst, Rect& dstRect,
+			ScaleFilters filter = ScaleFilters::Nearest);
+
+    Surface& blitScaled(Surface& dst, Rect& dstRect,
+			ScaleFilters filter = ScaleFilters::Nearest);
 
-    Surface& blitScaled(Surface& dst, Rect& dstRect);
+    Surface& blitScaled(const Rect& srcRect, Surface& dst,
+			ScaleFilters filter = ScaleFilters::Nearest);
 
-    Surface& blitScaled(const Rect& srcRect, Surface& dst);
+    Surface& blitScaled(Surface& dst,
+			ScaleFilters filter = ScaleFilters::Nearest);
 
-    Surface& blitScaled(Surface& dst);
+    /**
+     * @brief Convert the pixels into a surface of the same size, without
+     * allocating.
+     * @param dst Destination, in any format
+     * @return SO::Surface&
+     * @throw SO::Error if the sizes differ or on failure, notably for
+     * indexed formats.
+     * @remark Common conversions have native kernels, see
+     * SO::Blitter::canConvert, the others go through SDL_ConvertPixels.
+     */
+    Surface& convertTo(Surface& dst);
 
     /**
      * @brief Use this method to perform a fast fill of a rectangle with a
@@ -112,6 +165,8 @@ namespace SO
      * @param color the color to fill with
      * @return SO::Surface&
      * @throw SO::Error on failure.
+     * @remark Large fills are split across threads as SO::Blitter
+     * describes.
      */
     Surface& fillRect(const Rect& rect, Uint32 color);
 
@@ -119,6 +174,22 @@ namespace SO
 
     Surface& loadBMP(const char* path);
 
+    /**
+     * @brief Lock the surface for direct access to its pixels.
+     * @return SO::Surface&
+     * @throw SO::Error on failure.
+     * @remark Only RLE surfaces need to be locked, locks nest and must
+     * be balanced by SO::Surface::unlock.
+     * @sa SO::PixelView
+     */
+    Surface& lock();
+
+    /**
+     * @brief Release a lock of SO::Surface::lock.
+     * @return SO::Surface&
+     */
+    Surface& unlock();
+
     /**
      * @brief Return the C pointer of the wrapped SDL_Surface.
      * @return SDL_Surface*
@@ -135,6 +206,32 @@ namespace SO
 
     void free();
 
+    // Take loaded, converted to the format of stretch if any
+    void adopt(SDL_Surface* loaded, const Surface* const stretch);
+
+    // SDL_BlitSurface, through SO::Blitter when isBlendableOnto(dst)
+    void blitTo(const SDL_Rect* srcRect, Surface& dst, SDL_Rect* dstRect);
+
+    // SDL_BlitScaled, through SO::Blitter when unclipped and blendable
+    // or copyable onto dst
+    void blitScaledTo(const SDL_Rect* srcRect, Surface& dst, SDL_Rect* dstRect,
+		      ScaleFilters filter);
+
+    // Filtered scaling, to receives the final area
+    void blitFiltered(SDL_Rect from, Surface& dst, SDL_Rect& to, ScaleFilters filter);
+
+    // SDL_FillRect, through SO::Blitter when split across threads
+    void fillTo(const SDL_Rect* rect, Uint32 color);
+
+    // Called by fillTo and the blits with the final area they wrote to
+    virtual void modified(const SDL_Rect& area);
+
+    // ARGB8888 blended onto ARGB8888 or RGB888, without modulation nor key
+    bool isBlendableOnto(const Surface& dst) const;
+
+    // Same non-indexed format, without blending, modulation nor key
+    bool isCopyableOnto(const Surface& dst) const;
+
   };
 
 }
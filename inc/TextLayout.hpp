@@ -0,0 +1,222 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXT_LAYOUT_HPP
+#define TEXT_LAYOUT_HPP
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+
+#ifdef _SDL_TTF_H
+
+namespace SO
+{
+
+  /**
+   * @brief Wraps, aligns and measures text against fonts.
+   *
+   * Text is measured from the advance and kerning of its glyphs, queried
+   * once per font and cached, instead of TTF_SizeText. Layouts are
+   * cached by font, style, text, wrap width and alignment, so laying out
+   * the same string every frame costs a hash lookup.
+   *
+   * A layout only holds positions of characters, it can be drawn by
+   * SO::FontAtlas or by anything else rendering glyphs.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextLayout
+  {
+  public:
+
+    /** Horizontal alignment of the lines */
+    enum class Align
+    {
+      Left,
+      Center,
+      Right
+    };
+
+    /** A character placed on its line */
+    struct Glyph
+    {
+      Uint16 codepoint;
+      int    x;         // pen position
+      int    y;         // top of the line
+    };
+
+    /** Glyphs of one line */
+    struct Line
+    {
+      std::size_t first;
+      std::size_t count;
+      int         width;
+    };
+
+    /**
+     * @brief Text laid out, relative to its top left corner.
+     * @note Whitespace has no glyph.
+     */
+    struct Layout
+    {
+      std::vector<Glyph> glyphs;
+      std::vector<Line>  lines;
+      int                width;
+      int                height;
+    };
+
+    /**
+     * @brief Create an empty cache.
+     * @param capacity Number of layouts kept
+     */
+    explicit TextLayout(std::size_t capacity = 256);
+
+    TextLayout(const TextLayout& orig)            = delete;
+    TextLayout(TextLayout&& orig)                 = delete;
+    TextLayout& operator=(const TextLayout& orig) = delete;
+    TextLayout& operator=(TextLayout&& orig)      = delete;
+
+    ~TextLayout() = default;
+
+    /**
+     * @brief Lay out UTF-8 text.
+     * @param font Font of the text, in its current style, hinting,
+     * outline and kerning
+     * @param text Text to lay out, '\n' starts a new line
+     * @param wrapWidth Width lines are wrapped at, between words when
+     * possible, 0 to wrap only at '\n'
+     * @param align Alignment of the lines, within wrapWidth or within
+     * the widest line if 0
+     * @return std::shared_ptr<const Layout>
+     * @throw SO::Error if a glyph can't be measured
+     */
+    std::shared_ptr<const Layout> layout(TTF_Font* font,
+					 const std::string& text,
+					 int wrapWidth = 0,
+					 Align align = Align::Left);
+
+    /**
+     * @brief Measure UTF-8 text.
+     * @param font Font of the text, in its current style, hinting,
+     * outline and kerning
+     * @param text Text to measure
+     * @param wrapWidth Width lines are wrapped at, 0 to wrap only at '\n'
+     * @return Pair<int> width and height
+     * @throw SO::Error if a glyph can't be measured
+     */
+    Pair<int> measure(TTF_Font* font, const std::string& text, int wrapWidth = 0);
+
+    /**
+     * @brief Forget every layout and glyph metric.
+     * @return TextLayout&
+     * @note Must be called before a font is closed, another one could be
+     * opened at the same address.
+     */
+    TextLayout& clear();
+
+    /**
+     * @brief Get the number of layouts kept.
+     * @return std::size_t
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     * @brief Get the number of layouts found in cache.
+     * @return Uint32
+     */
+    Uint32 getHits() const;
+
+    /**
+     * @brief Get the number of layouts computed.
+     * @return Uint32
+     */
+    Uint32 getMisses() const;
+
+    /**
+     * @brief Set the number of layouts kept, evicting the least
+     * recently used ones.
+     * @param capacity Number of layouts
+     * @return TextLayout&
+     */
+    TextLayout& setCapacity(std::size_t capacity);
+
+  private:
+
+    // Font settings are part of the key, changing them gives new layouts
+    struct Key
+    {
+      const TTF_Font* font;
+      int             style;
+      int             hinting;
+      int             outline;
+      int             kerning;
+      int             wrapWidth;
+      Align           align;
+      std::string     text;
+
+      bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash
+    {
+      std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+      std::shared_ptr<const Layout> layout;
+      std::list<Key>::iterator      use;    // position in m_uses
+    };
+
+    // Lay out text without the cache
+    void compute(const Key& key, TTF_Font* font, Layout& layout);
+
+    // Advance of a glyph, from TTF_GlyphMetrics
+    int advance(TTF_Font* font, const Key& key, Uint16 codepoint);
+
+    // Evict the oldest entries while above the limit
+    void evict(std::size_t limit);
+
+    std::size_t                             m_capacity;
+
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    std::list<Key>                          m_uses;     // least recently used first
+
+    // advances by font, then by style, hinting, outline and codepoint
+    std::unordered_map<const TTF_Font*, std::unordered_map<Uint64, int>> m_advances;
+
+    Uint32                                  m_hits;
+    Uint32                                  m_misses;
+  };
+
+}
+
+#endif // _SDL_TTF_H
+
+#endif // TEXT_LAYOUT_HPP
@@ -37,6 +37,9 @@
 #include "Point.hpp"
 #include "Color.hpp"
 #include "Rect.hpp"
+#include "Surface.hpp"
+#include "BakedImage.hpp"
+#include "TextureMemory.hpp"
 
 namespace SO
 {
@@ -47,7 +50,8 @@ namespace SO
     Text
   } RendereredFrom;
   
-  class Renderer; // Forward declaration
+  class Renderer;  // Forward declaration
+  class AssetPack; // Forward declaration
 
   class Texture {
   public:
@@ -57,10 +61,40 @@ namespace SO
                      int height,
                      TextureAccess access=TextureAccess::Target,
                      PixelFormats format=PixelFormats::Unknown);
+
+    /**
+     * @brief Create a texture holding a copy of a surface.
+     * @param renderer renderer the texture is created with
+     * @param surface pixels to upload
+     * @throw SO::Error on failure.
+     */
+    explicit Texture(Renderer& renderer, Surface& surface);
+
+    /**
+     * @brief Create a static texture holding a baked image.
+     * @param renderer renderer the texture is created with
+     * @param image pixels to upload, without conversion
+     * @throw SO::Error on failure.
+     * @note Blending is enabled when the format has an alpha channel.
+     */
+    explicit Texture(Renderer& renderer, const BakedImage& image);
 #ifdef _SDL_IMAGE_H
     explicit Texture(Renderer& renderer,
                      const char* file,
 		     const Color& colorKeying = Color::Black);
+
+    /**
+     * @brief Create a texture from an image stored in an asset pack.
+     * @param renderer renderer the texture is created with
+     * @param pack pack of the image
+     * @param name name of the entry
+     * @param colorKeying color made transparent, black for none
+     * @throw SO::Error on failure.
+     */
+    explicit Texture(Renderer& renderer,
+		     const AssetPack& pack,
+		     const std::string& name,
+		     const Color& colorKeying = Color::Black);
 #endif
 
 #ifdef _SDL_TTF_H
@@ -72,9 +106,18 @@ namespace SO
     
     
     Texture(const Texture& orig)             = delete;
-    Texture(Texture&& orig)                  = delete;
     Texture& operator =(const Texture& orig) = delete;
-    Texture& operator =(Texture&& orig)      = delete;
+
+    /**
+     * @brief Take over the texture of orig, which is left empty.
+     */
+    Texture(Texture&& orig) noexcept;
+
+    /**
+     * @brief Destroy the texture and take over the one of orig, which
+     * is left empty.
+     */
+    Texture& operator =(Texture&& orig) noexcept;
     
     virtual ~Texture();
     
@@ -84,6 +127,19 @@ namespace SO
 
     BlendModes getBlendMode() const;
 
+    /**
+     * @brief Get the estimated memory held by the texture.
+     * @return std::size_t
+     * @sa SO::TextureMemory
+     */
+    std::size_t getBytes() const;
+
+    /**
+     * @brief Get the memory accounting category of the texture.
+     * @return std::string
+     */
+    std::string getCategory() const;
+
     Color getColorMod() const;
 
     PixelFormats getFormat() const;
@@ -102,6 +158,13 @@ namespace SO
      */
     Texture& setBlendMode(BlendModes blendMode);
 
+    /**
+     * @brief Move the texture to another memory accounting category.
+     * @param category Name of the category
+     * @return SO::Texture&
+     */
+    Texture& setCategory(const std::string& category);
+
     Texture& setColorMod(const Color& color);
     
 
@@ -109,6 +172,11 @@ namespace SO
     Texture& loadFromFile(Renderer& renderer,
 			  const char* str,
 			  const Color& color = Color::Black);
+
+    Texture& loadFromPack(Renderer& renderer,
+			  const AssetPack& pack,
+			  const std::string& name,
+			  const Color& color = Color::Black);
 #endif
 
 #ifdef _SDL_TTF_H
@@ -118,19 +186,47 @@ namespace SO
 				  TTF_Font* font);
 #endif
 
-    //bool lock(const CRectangle& rect, void** pixels, int* pitch);
+    /**
+     * @brief Lock an area of a streaming texture for write-only access.
+     * @param rect area to lock, or NULL for the whole texture
+     * @param pixels set to the locked pixels
+     * @param pitch set to the length of a row in bytes
+     * @return SO::Texture&
+     * @throw SO::Error if the texture isn't streaming or on failure.
+     * @note Pending deferred copies from the texture are drawn first.
+     * @sa SO::TextureLock
+     */
+    Texture& lock(const Rect* rect, void** pixels, int* pitch);
 
     const SDL_Texture* toSDL() const;
 
     SDL_Texture* toSDL();
 
-    //bool unlock();
+    /**
+     * @brief Unlock the texture, uploading the changes.
+     * @return SO::Texture&
+     */
+    Texture& unlock();
 
   protected:    
     void free();
     
   private:
+    // Properties fixed at creation, cached to spare SDL_QueryTexture
+    void query();
+
+    // Replace the texture by a copy of loaded, which is freed
+    void loadFromSurface(Renderer& renderer, SDL_Surface* loaded, const Color& colorKeying);
+
     SDL_Texture*  m_texture;
+    int           m_width  = 0;
+    int           m_height = 0;
+    PixelFormats  m_format = PixelFormats::Unknown;
+    TextureAccess m_access = TextureAccess::Static;
+
+    // Accounted in SO::TextureMemory
+    std::size_t             m_bytes    = 0;
+    TextureMemory::Category m_category = 0;
     
   };
 
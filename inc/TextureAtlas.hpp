@@ -0,0 +1,186 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXTURE_ATLAS_HPP
+#define TEXTURE_ATLAS_HPP
+
+#include <deque>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Rect.hpp"
+#include "Surface.hpp"
+#include "Texture.hpp"
+#include "SkylinePacker.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Where an image of a SO::TextureAtlas lives.
+   *
+   * Plugs into SO::Renderer::copy as `renderer.copy(*region.page,
+   * &region.src, &dst)`.
+   */
+  struct AtlasRegion
+  {
+    /** Page holding the image */
+    Texture* page;
+    /** Area of the page covered by the image */
+    Rect     src;
+  };
+
+  /**
+   * @brief Many images packed into a few large textures.
+   *
+   * Images are added one at a time and packed into render target pages
+   * with a SO::SkylinePacker. Handles stay valid across
+   * SO::TextureAtlas::rebuild, which repacks the live images to reclaim
+   * the room left by removed ones.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextureAtlas
+  {
+  public:
+
+    /** Stable identifier of an image in the atlas */
+    using Handle = Uint32;
+
+    /**
+     * @brief Create an empty atlas.
+     * @param renderer Renderer the pages are created with, it must
+     * support render targets
+     * @param pageWidth Width of each page
+     * @param pageHeight Height of each page
+     * @param padding Empty pixels kept around each image against
+     * bleeding when filtering
+     */
+    explicit TextureAtlas(Renderer& renderer,
+			  int pageWidth = 1024,
+			  int pageHeight = 1024,
+			  int padding = 1);
+
+    TextureAtlas(const TextureAtlas& orig)            = delete;
+    TextureAtlas(TextureAtlas&& orig)                 = delete;
+    TextureAtlas& operator=(const TextureAtlas& orig) = delete;
+    TextureAtlas& operator=(TextureAtlas&& orig)      = delete;
+
+    ~TextureAtlas() = default;
+
+    /**
+     * @brief Add the content of a surface to the atlas.
+     * @param surface Image to add
+     * @return Handle
+     * @throw SO::Error if the image is larger than a page or on failure
+     */
+    Handle insert(Surface& surface);
+
+#ifdef _SDL_IMAGE_H
+    /**
+     * @brief Add an image file to the atlas.
+     * @param path Path of the image
+     * @return Handle
+     * @throw SO::Error if the image is larger than a page or on failure
+     */
+    Handle insert(const char* path);
+#endif
+
+    /**
+     * @brief Remove an image, its room is reclaimed by the next rebuild.
+     * @param handle Image to remove
+     * @return TextureAtlas&
+     * @throw SO::Error if the handle is invalid
+     */
+    TextureAtlas& remove(Handle handle);
+
+    /**
+     * @brief Get where an image lives.
+     * @param handle Image to look up
+     * @return AtlasRegion
+     * @throw SO::Error if the handle is invalid
+     * @note The region is valid until the next insert or rebuild.
+     */
+    AtlasRegion get(Handle handle) const;
+
+    /**
+     * @brief Repack the live images into as few pages as possible.
+     * @return TextureAtlas&
+     * @throw SO::Error on failure
+     * @note The content is copied on the GPU, through render targets.
+     */
+    TextureAtlas& rebuild();
+
+    /**
+     * @brief Get the fraction of the pages covered by live images.
+     * @return float
+     * @note A low occupancy is a hint to SO::TextureAtlas::rebuild.
+     */
+    float getOccupancy() const;
+
+    /**
+     * @brief Get a page of the atlas.
+     * @param index Index of the page
+     * @return Texture&
+     */
+    Texture& getPage(std::size_t index);
+
+    /**
+     * @brief Get the number of pages.
+     * @return std::size_t
+     */
+    std::size_t getPageCount() const;
+
+  private:
+
+    struct Entry
+    {
+      Uint32 page;
+      Rect   src;
+      bool   live;
+    };
+
+    const Entry& entry(Handle handle) const;
+
+    // Reserve room for an image in pages, adding one if needed
+    Entry place(std::deque<Texture>& pages,
+		std::vector<SkylinePacker>& packers,
+		int width, int height);
+
+    Renderer&                  m_renderer;
+    int                        m_pageWidth;
+    int                        m_pageHeight;
+    int                        m_padding;
+
+    std::deque<Texture>        m_pages;   // a deque keeps pages in place
+    std::vector<SkylinePacker> m_packers; // one per page
+    std::vector<Entry>         m_entries; // indexed by Handle
+    Uint64                     m_liveArea;
+  };
+
+}
+
+#endif // TEXTURE_ATLAS_HPP
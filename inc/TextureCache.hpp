@@ -0,0 +1,166 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXTURE_CACHE_HPP
+#define TEXTURE_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Color.hpp"
+#include "Texture.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Textures loaded from files, shared by path and color key.
+   *
+   * Loading a file already resident returns the same texture. Once the
+   * bytes of the resident textures exceed the budget, the least recently
+   * used ones that nobody holds anymore are destroyed. They are also
+   * destroyed when SO::TextureMemory runs over its global budget.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextureCache
+  {
+  public:
+
+    /**
+     * @brief Create an empty cache.
+     * @param renderer Renderer the textures are created with
+     * @param budget Bytes of texture memory to stay under
+     */
+    explicit TextureCache(Renderer& renderer, std::size_t budget = 256 << 20);
+
+    TextureCache(const TextureCache& orig)            = delete;
+    TextureCache(TextureCache&& orig)                 = delete;
+    TextureCache& operator=(const TextureCache& orig) = delete;
+    TextureCache& operator=(TextureCache&& orig)      = delete;
+
+    ~TextureCache();
+
+#ifdef _SDL_IMAGE_H
+    /**
+     * @brief Get the texture of a file, loading it if not resident.
+     * @param path Path of the image
+     * @param colorKeying Color made transparent, as in the
+     * SO::Texture constructor
+     * @return std::shared_ptr<Texture>
+     * @throw SO::Error if the file can't be loaded
+     * @note Evicts unused textures if the budget is exceeded.
+     */
+    std::shared_ptr<Texture> load(const std::string& path,
+				  const Color& colorKeying = Color::Black);
+#endif
+
+    /**
+     * @brief Evict unused textures, least recently used first, until
+     * the budget is met.
+     * @return TextureCache&
+     */
+    TextureCache& trim();
+
+    /**
+     * @brief Evict every unused texture.
+     * @return TextureCache&
+     */
+    TextureCache& clear();
+
+    /**
+     * @brief Get the bytes of texture memory held by the cache.
+     * @return std::size_t
+     * @note Estimated from the size and format of each texture.
+     */
+    std::size_t getBytes() const;
+
+    /**
+     * @brief Get the budget in bytes.
+     * @return std::size_t
+     */
+    std::size_t getBudget() const;
+
+    /**
+     * @brief Get the number of loads served from the cache.
+     * @return Uint32
+     */
+    Uint32 getHits() const;
+
+    /**
+     * @brief Get the number of loads which read a file.
+     * @return Uint32
+     */
+    Uint32 getMisses() const;
+
+    /**
+     * @brief Get the number of textures evicted.
+     * @return Uint32
+     */
+    Uint32 getEvictions() const;
+
+    /**
+     * @brief Set the budget, evicting unused textures if needed.
+     * @param budget Bytes of texture memory to stay under
+     * @return TextureCache&
+     */
+    TextureCache& setBudget(std::size_t budget);
+
+  private:
+
+    using Key = std::pair<std::string, Uint32>; // path, RGBA color key
+
+    struct Entry
+    {
+      std::shared_ptr<Texture>  texture;
+      std::size_t               bytes;
+      std::list<Key>::iterator  use;   // position in m_uses
+    };
+
+    // Evict unused entries, oldest first, while above the limit
+    void evict(std::size_t limit);
+
+    Renderer&            m_renderer;
+    std::size_t          m_budget;
+    std::size_t          m_bytes;
+
+    std::map<Key, Entry> m_entries;
+    std::list<Key>       m_uses;     // least recently used first
+
+    Uint32               m_hits;
+    Uint32               m_misses;
+    Uint32               m_evictions;
+
+    TextureMemory::Handle m_budgetCallback;
+  };
+
+}
+
+#endif // TEXTURE_CACHE_HPP
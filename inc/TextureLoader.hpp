@@ -0,0 +1,208 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXTURE_LOADER_HPP
+#define TEXTURE_LOADER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Color.hpp"
+#include "Surface.hpp"
+#include "Texture.hpp"
+
+#ifdef _SDL_IMAGE_H
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Load image files without stalling the render thread.
+   *
+   * Files are decoded by IMG_Load on a pool of worker threads. The
+   * decoded surfaces are uploaded to textures by
+   * SO::TextureLoader::upload, called once per frame on the render
+   * thread, within a time and byte budget.
+   *
+   * SDL_image must be initialized for the formats to load before the
+   * first call to SO::TextureLoader::load.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextureLoader
+  {
+  private:
+
+    struct State;
+
+  public:
+
+    /**
+     * @brief Pollable result of a load, to be used on the render thread.
+     */
+    class Handle
+    {
+    public:
+
+      Handle() = default;
+
+      /**
+       * @brief Return whether the texture was uploaded.
+       * @return bool
+       */
+      bool isReady() const;
+
+      /**
+       * @brief Return whether the file couldn't be loaded.
+       * @return bool
+       * @sa SO::TextureLoader::Handle::getError
+       */
+      bool hasFailed() const;
+
+      /**
+       * @brief Get the texture, or the placeholder until it is ready.
+       * @return Texture&
+       */
+      Texture& get() const;
+
+      /**
+       * @brief Get the texture once ready.
+       * @return std::shared_ptr<Texture> empty until ready
+       */
+      std::shared_ptr<Texture> getTexture() const;
+
+      /**
+       * @brief Get why the load failed.
+       * @return const std::string& empty unless it failed
+       */
+      const std::string& getError() const;
+
+    private:
+
+      friend class TextureLoader;
+
+      explicit Handle(std::shared_ptr<State> state);
+
+      std::shared_ptr<State> m_state;
+    };
+
+    /**
+     * @brief Start the worker threads.
+     * @param renderer Renderer the textures are created with
+     * @param threads Number of decoding threads
+     * @param placeholder Texture returned by handles until ready, a
+     * transparent 1x1 texture if none
+     * @throw SO::Error if the placeholder can't be created
+     */
+    explicit TextureLoader(Renderer& renderer,
+			   std::size_t threads = 2,
+			   std::shared_ptr<Texture> placeholder = nullptr);
+
+    TextureLoader(const TextureLoader& orig)            = delete;
+    TextureLoader(TextureLoader&& orig)                 = delete;
+    TextureLoader& operator=(const TextureLoader& orig) = delete;
+    TextureLoader& operator=(TextureLoader&& orig)      = delete;
+
+    /**
+     * @brief Stop the workers, pending loads are abandoned.
+     * @note Handles still refer to the placeholder, which stays alive.
+     */
+    ~TextureLoader();
+
+    /**
+     * @brief Queue a file to be decoded.
+     * @param path Path of the image
+     * @param colorKeying Color made transparent, as in the
+     * SO::Texture constructor
+     * @return Handle
+     */
+    Handle load(const std::string& path, const Color& colorKeying = Color::Black);
+
+    /**
+     * @brief Upload decoded images to textures, on the render thread.
+     * @param milliseconds Time after which no new upload is started
+     * @param bytes Bytes after which no new upload is started, or 0 for
+     * no limit
+     * @return TextureLoader&
+     * @note At least one image is uploaded per call if one is decoded,
+     * so loading always progresses.
+     */
+    TextureLoader& upload(double milliseconds = 2.0, std::size_t bytes = 0);
+
+    /**
+     * @brief Get the number of loads not yet uploaded or failed.
+     * @return std::size_t
+     */
+    std::size_t getPending() const;
+
+  private:
+
+    // Workers only read the path and color key, their result is handed
+    // over in a Decoded and published by upload on the rendering thread
+    struct State
+    {
+      std::string              path;
+      Color                    colorKeying;
+      std::string              error;       // set by upload
+      std::shared_ptr<Texture> texture;     // set by upload
+      std::shared_ptr<Texture> placeholder;
+      bool                     done = false;
+    };
+
+    struct Decoded
+    {
+      std::shared_ptr<State>   state;
+      std::unique_ptr<Surface> surface;
+      std::string              error;
+    };
+
+    void run();
+
+    Renderer&                          m_renderer;
+    std::shared_ptr<Texture>           m_placeholder;
+
+    std::deque<std::shared_ptr<State>> m_requests; // waiting for a worker
+    std::deque<Decoded>                m_decoded;  // waiting for upload
+    std::size_t                        m_pending;
+
+    mutable std::mutex                 m_mutex;
+    std::condition_variable            m_requested;
+    bool                               m_stop;
+
+    std::vector<std::thread>           m_workers;
+  };
+
+}
+
+#endif // _SDL_IMAGE_H
+
+#endif // TEXTURE_LOADER_HPP
@@ -0,0 +1,207 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXTURE_LOCK_HPP
+#define TEXTURE_LOCK_HPP
+
+#include "Utils.hpp"
+#include "Error.hpp"
+#include "Rect.hpp"
+#include "Texture.hpp"
+
+namespace SO
+{
+
+  class Renderer; // Forward declaration
+
+  /**
+   * @brief Scoped write access to the pixels of a streaming texture.
+   *
+   * The texture is locked on construction and unlocked, which uploads
+   * the changes, on destruction. Locked pixels are write-only, their
+   * initial content is undefined.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextureLock
+  {
+  public:
+
+    /**
+     * @brief Lock a whole texture.
+     * @param texture Texture created with SO::TextureAccess::Streaming
+     * @throw SO::Error on failure
+     */
+    explicit TextureLock(Texture& texture);
+
+    /**
+     * @brief Lock an area of a texture.
+     * @param texture Texture created with SO::TextureAccess::Streaming
+     * @param rect Area to lock
+     * @throw SO::Error on failure
+     */
+    TextureLock(Texture& texture, const Rect& rect);
+
+    TextureLock(const TextureLock& orig)            = delete;
+    TextureLock& operator=(const TextureLock& orig) = delete;
+    TextureLock& operator=(TextureLock&& orig)      = delete;
+
+    TextureLock(TextureLock&& orig);
+
+    ~TextureLock();
+
+    /**
+     * @brief Get the format of the pixels.
+     * @return PixelFormats
+     */
+    PixelFormats getFormat() const { return m_format; }
+
+    /**
+     * @brief Get the height of the locked area.
+     * @return int
+     */
+    int getHeight() const { return m_height; }
+
+    /**
+     * @brief Get the length of a row in bytes.
+     * @return int
+     */
+    int getPitch() const { return m_pitch; }
+
+    /**
+     * @brief Get the first pixel of the locked area.
+     * @return void*
+     */
+    void* getPixels() const { return m_pixels; }
+
+    /**
+     * @brief Get the width of the locked area.
+     * @return int
+     */
+    int getWidth() const { return m_width; }
+
+    /**
+     * @brief Get a row of pixels.
+     * @param y Row, relative to the locked area
+     * @return T* where T matches the size of a pixel, e.g. Uint32 for
+     * SO::PixelFormats::ARGB8888
+     */
+    template<typename T>
+    T* getRow(int y) const
+    {
+      return reinterpret_cast<T*>(static_cast<Uint8*>(m_pixels) + y * m_pitch);
+    }
+
+    /**
+     * @brief Get a pixel.
+     * @param x Column, relative to the locked area
+     * @param y Row, relative to the locked area
+     * @return T& where T matches the size of a pixel
+     */
+    template<typename T>
+    T& at(int x, int y) const
+    {
+      return this->getRow<T>(y)[x];
+    }
+
+  private:
+
+    Texture*     m_texture;
+    void*        m_pixels;
+    int          m_pitch;
+    int          m_width;
+    int          m_height;
+    PixelFormats m_format;
+  };
+
+  /**
+   * @brief Pair of streaming textures written and drawn in turn.
+   *
+   * The CPU fills the back texture while the front one, written the
+   * frame before, is drawn. Swapping exchanges them, so the driver
+   * never has to wait on a texture still in use to hand out a lock.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class StreamingTexture
+  {
+  public:
+
+    /**
+     * @brief Create both textures.
+     * @param renderer Renderer the textures are created with
+     * @param width Width of the textures
+     * @param height Height of the textures
+     * @param format Pixel format of the textures
+     * @throw SO::Error on failure
+     */
+    StreamingTexture(Renderer& renderer,
+		     int width,
+		     int height,
+		     PixelFormats format = PixelFormats::ARGB8888);
+
+    /**
+     * @brief Lock the back texture, to write the next frame.
+     * @return TextureLock
+     * @throw SO::Error on failure
+     * @warning The lock must be released before SO::StreamingTexture::swap.
+     */
+    TextureLock lock();
+
+    /**
+     * @brief Lock an area of the back texture.
+     * @param rect Area to lock
+     * @return TextureLock
+     * @throw SO::Error on failure
+     * @note The rest of the back texture keeps the frame before last.
+     */
+    TextureLock lock(const Rect& rect);
+
+    /**
+     * @brief Make the back texture the front one, and conversely.
+     * @return StreamingTexture&
+     */
+    StreamingTexture& swap();
+
+    /**
+     * @brief Get the texture being written.
+     * @return Texture&
+     */
+    Texture& getBack();
+
+    /**
+     * @brief Get the texture to draw.
+     * @return Texture&
+     */
+    Texture& getFront();
+
+  private:
+
+    Texture m_textures[2];
+    int     m_front;
+  };
+
+}
+
+#endif // TEXTURE_LOCK_HPP
@@ -0,0 +1,215 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef TEXTURE_MEMORY_HPP
+#define TEXTURE_MEMORY_HPP
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include "Utils.hpp"
+#include "Error.hpp"
+
+namespace SO
+{
+
+  /**
+   * @brief Global accounting of the memory held by textures.
+   *
+   * Every SO::Texture adds its size, computed from its width, height and
+   * pixel format, to the live total and to the total of its category.
+   * Textures are tagged with the category of the innermost
+   * SO::TextureMemory::Scope of the thread creating them, "default"
+   * outside of any.
+   *
+   * When a budget is set, textures about to be created check it first.
+   * If they would exceed it, the budget callbacks are called, in the
+   * order they were added, until enough memory is released. Caches such
+   * as SO::TextureCache and SO::RenderTargetPool register one to evict
+   * what they don't need. Creation goes on even if the budget can't be
+   * met, the budget is a soft limit.
+   *
+   * Sizes are estimates, drivers may pad or compress textures.
+   *
+   * **SDL 2.0.0**
+   */
+
+  class TextureMemory
+  {
+  public:
+
+    /** Index of a category */
+    using Category = Uint16;
+
+    /** Identifier of a budget callback */
+    using Handle = Uint32;
+
+    /**
+     * @brief Called with the number of bytes to release to stay within
+     * the budget.
+     */
+    using Callback = std::function<void(std::size_t excess)>;
+
+    /**
+     * @brief Tag the textures created by this thread while it lives.
+     */
+    class Scope
+    {
+    public:
+
+      /**
+       * @brief Enter a category.
+       * @param category Name of the category
+       */
+      explicit Scope(const std::string& category);
+
+      Scope(const Scope& orig)            = delete;
+      Scope& operator=(const Scope& orig) = delete;
+
+      /**
+       * @brief Go back to the enclosing category.
+       */
+      ~Scope();
+
+    private:
+
+      Category m_previous;
+    };
+
+    TextureMemory() = delete;
+
+    /**
+     * @brief Get the size of a texture.
+     * @param width Width of the texture
+     * @param height Height of the texture
+     * @param format Pixel format, 4 bytes per pixel are assumed for
+     * PixelFormats::Unknown
+     * @return std::size_t
+     */
+    static std::size_t getBytes(int width, int height, PixelFormats format);
+
+    /**
+     * @brief Get the bytes held by every texture.
+     * @return std::size_t
+     */
+    static std::size_t getLive();
+
+    /**
+     * @brief Get the bytes held by the textures of a category.
+     * @param category Name of the category
+     * @return std::size_t
+     */
+    static std::size_t getLive(const std::string& category);
+
+    /**
+     * @brief Get the highest live total reached.
+     * @return std::size_t
+     * @sa SO::TextureMemory::resetPeak
+     */
+    static std::size_t getPeak();
+
+    /**
+     * @brief Get the number of live textures.
+     * @return std::size_t
+     */
+    static std::size_t getCount();
+
+    /**
+     * @brief Get the live total of every category.
+     * @return std::map<std::string, std::size_t>
+     */
+    static std::map<std::string, std::size_t> getCategories();
+
+    /**
+     * @brief Get the budget.
+     * @return std::size_t, 0 when there's none
+     */
+    static std::size_t getBudget();
+
+    /**
+     * @brief Set the budget.
+     * @param bytes Budget in bytes, 0 for none
+     */
+    static void setBudget(std::size_t bytes);
+
+    /**
+     * @brief Start the peak over from the live total.
+     */
+    static void resetPeak();
+
+    /**
+     * @brief Add a callback releasing memory when over budget.
+     * @param callback Callback to add
+     * @return Handle to remove it with
+     * @warning It's called by the thread creating the texture and may
+     * destroy textures, but must not create any.
+     */
+    static Handle addBudgetCallback(Callback callback);
+
+    /**
+     * @brief Remove a budget callback.
+     * @param handle Handle returned by SO::TextureMemory::addBudgetCallback
+     */
+    static void removeBudgetCallback(Handle handle);
+
+    /**
+     * @brief Make room for an allocation, calling the budget callbacks
+     * if it would exceed the budget.
+     * @param bytes Size of the allocation
+     * @note SO::Texture calls it before creating a texture.
+     */
+    static void reserve(std::size_t bytes);
+
+    /**
+     * @brief Get the index of a category, adding it if needed.
+     * @param name Name of the category
+     * @return Category
+     */
+    static Category getCategory(const std::string& name);
+
+    /**
+     * @brief Get the name of a category.
+     * @param category Index of the category
+     * @return std::string
+     */
+    static std::string getCategoryName(Category category);
+
+    /**
+     * @brief Get the category textures created by this thread are tagged
+     * with.
+     * @return Category
+     */
+    static Category getCurrent();
+
+  private:
+
+    friend class Texture;
+
+    // Account for a texture created or destroyed
+    static void acquire(std::size_t bytes, Category category);
+    static void release(std::size_t bytes, Category category);
+  };
+
+}
+
+#endif // TEXTURE_MEMORY_HPP
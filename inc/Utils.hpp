@@ -158,6 +158,16 @@ namespace SO
     Vertical   = SDL_FLIP_VERTICAL
   };
 
+  __ENUM_CLASS_OR_OVERLOAD__(Flip, int)
+  __ENUM_CLASS_AND_OVERLOAD__(Flip, int)
+
+  enum class ScaleFilters : int
+  {
+    Nearest, /**< Nearest pixel, as SDL_BlitScaled */
+    Linear,  /**< Bilinear interpolation, for magnification */
+    Box      /**< Average of the covered pixels, for minification */
+  };
+
   void init(Init flags);
 
   /**
@@ -189,8 +199,27 @@ namespace SO
   void initTTF();
   
   void quitTTF();
+
+  /**
+   * @brief Get the kerning between two glyphs of a font.
+   * @param font Font of the glyphs
+   * @param previous Character before
+   * @param codepoint Character after
+   * @return pixels to add to the advance of previous, always 0 before
+   * SDL_ttf 2.0.14 or when kerning is disabled for font
+   */
+  int getKerning(TTF_Font* font, Uint16 previous, Uint16 codepoint);
 #endif
 
+  /**
+   * @brief Decode the next character of an UTF-8 string.
+   * @param text position in the string, moved past the character
+   * @param end end of the string
+   * @return the character, or '?' if it is malformed or outside of the
+   * Basic Multilingual Plane, the only one SDL_ttf takes glyphs from
+   */
+  Uint16 nextCodepoint(const char*& text, const char* end);
+
   /**
    * @brief Pause the application for a specified number of milliseconds.
    * @param ms the number of milliseconds to delay
@@ -32,12 +32,14 @@
 
 // std imports
 #include <string>
+#include <vector>
 // C SDL imports
 #include <SDL2/SDL_syswm.h>
 // lib imports
 #include "Utils.hpp"
 
 #include "Point.hpp"
+#include "Rect.hpp"
 
 namespace SO
 {
@@ -344,6 +346,23 @@ namespace SO
      */
     Window& update();
 
+    /**
+     * @brief Copy some areas of the window surface to the screen.
+     * @param rects areas to copy
+     * @param count number of areas
+     * @return SO::Window&
+     * @throw SO::Error on failure.
+     */
+    Window& update(const Rect* rects, std::size_t count);
+
+    /**
+     * @brief Copy some areas of the window surface to the screen.
+     * @param rects areas to copy
+     * @return SO::Window&
+     * @throw SO::Error on failure.
+     */
+    Window& update(const std::vector<Rect>& rects);
+
   private:    
     SDL_Window*   m_window;  // wrapped object
 
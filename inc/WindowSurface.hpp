@@ -3,6 +3,7 @@
 
 #include "Surface.hpp"
 #include "Window.hpp"
+#include "DamageTracker.hpp"
 
 namespace SO
 {
@@ -13,10 +14,65 @@ namespace SO
   public:
 
     explicit WindowSurface(Window& window)
-      : Surface(SDL_GetWindowSurface(window.toSDL())) {}
+      : Surface(SDL_GetWindowSurface(window.toSDL())),
+	m_window(window)
+    {
+      m_damage.setBounds({0, 0,
+			  static_cast<Uint16>(m_surface->w),
+			  static_cast<Uint16>(m_surface->h)});
+    }
 
     virtual ~WindowSurface() { m_surface = nullptr; }
 
+    /**
+     * @brief Mark an area of the surface as modified.
+     * @param rect modified area
+     * @return SO::WindowSurface&
+     * @note Fills and blits onto the surface are marked already, this
+     * is only needed after writing pixels directly.
+     * @sa SO::WindowSurface::update
+     */
+    WindowSurface& damage(const Rect& rect)
+    {
+      m_damage.add(rect);
+      return *this;
+    }
+
+    /**
+     * @brief Return the areas modified since the last update.
+     * @return const SO::DamageTracker&
+     */
+    const DamageTracker& getDamage() const { return m_damage; }
+
+    /**
+     * @brief Copy the areas modified since the last update to the screen.
+     * @return SO::WindowSurface&
+     * @throw SO::Error on failure.
+     * @note Nothing is copied if no area was marked.
+     */
+    WindowSurface& update()
+    {
+      m_window.update(m_damage.getRects());
+      m_damage.clear();
+
+      // The window may have been resized since
+      m_damage.setBounds({0, 0,
+			  static_cast<Uint16>(m_surface->w),
+			  static_cast<Uint16>(m_surface->h)});
+      return *this;
+    }
+
+  protected:
+
+    virtual void modified(const SDL_Rect& area)
+    {
+      m_damage.add(area);
+    }
+
+  private:
+
+    Window&       m_window;
+    DamageTracker m_damage;
 
   };
 
@@ -0,0 +1,295 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SO
+{
+
+  namespace
+  {
+    Uint32 readLE32(const Uint8* data)
+    {
+      Uint32 value;
+
+      std::memcpy(&value, data, sizeof(value));
+
+      return SDL_SwapLE32(value);
+    }
+
+    Uint64 readLE64(const Uint8* data)
+    {
+      Uint64 value;
+
+      std::memcpy(&value, data, sizeof(value));
+
+      return SDL_SwapLE64(value);
+    }
+
+    Uint64 align(Uint64 offset, Uint64 alignment)
+    {
+      return (offset + alignment - 1) / alignment * alignment;
+    }
+  }
+
+  // Public methods of class AssetPack
+
+  /* Constructor/destructor */
+
+  AssetPack::AssetPack(const char* path)
+    : m_file(path),
+      m_index(nullptr),
+      m_count(0)
+  {
+    const Uint8*      data = m_file.getData();
+    const std::size_t size = m_file.getSize();
+
+    if (size < HeaderSize || readLE32(data) != Magic || readLE32(data + 4) != Version)
+      throw Error("AssetPack: not an asset pack");
+
+    const Uint64 count = readLE32(data + 8);
+
+    if (HeaderSize + count * RecordSize > size)
+      throw Error("AssetPack: truncated index");
+
+    // Check the records once, lookups trust them
+    for (Uint64 i = 0; i < count; ++i)
+    {
+      const Uint8* record = data + HeaderSize + i * RecordSize;
+
+      const Uint64 nameEnd = static_cast<Uint64>(readLE32(record)) + readLE32(record + 4);
+      const Uint64 offset  = readLE64(record + 8);
+      const Uint64 length  = readLE64(record + 16);
+
+      if (nameEnd > size || offset > size || length > size - offset)
+	throw Error("AssetPack: entry out of the pack");
+    }
+
+    m_index = data + HeaderSize;
+    m_count = count;
+  }
+
+  /* Methods */
+
+  void AssetPack::pack(const char* path, std::vector<std::string> names, const char* root)
+  {
+    std::sort(names.begin(), names.end());
+
+    if (std::adjacent_find(names.begin(), names.end()) != names.end())
+      throw Error("AssetPack: duplicated name");
+
+    const std::string prefix = root != nullptr ? std::string(root) + "/" : std::string();
+
+    // Place every name and blob before writing anything
+    std::vector<Uint64> sizes;
+    std::vector<Uint64> offsets;
+
+    sizes.reserve(names.size());
+    offsets.reserve(names.size());
+
+    Uint64 namesEnd = HeaderSize + static_cast<Uint64>(names.size()) * RecordSize;
+
+    for (const std::string& name : names)
+    {
+      SDL_RWops* file = SDL_RWFromFile((prefix + name).c_str(), "rb");
+
+      if (file == nullptr)
+	throw Error(SDL_GetError());
+
+      const Sint64 size = SDL_RWsize(file);
+
+      SDL_RWclose(file);
+
+      if (size < 0)
+	throw Error(SDL_GetError());
+
+      sizes.push_back(size);
+      namesEnd += name.size();
+    }
+
+    Uint64 cursor = align(namesEnd, Alignment);
+
+    for (Uint64 size : sizes)
+    {
+      offsets.push_back(cursor);
+      cursor = align(cursor + size, Alignment);
+    }
+
+    SDL_RWops* pack = SDL_RWFromFile(path, "wb");
+
+    if (pack == nullptr)
+      throw Error(SDL_GetError());
+
+    bool written = SDL_WriteLE32(pack, Magic) == 1
+      &&           SDL_WriteLE32(pack, Version) == 1
+      &&           SDL_WriteLE32(pack, names.size()) == 1
+      &&           SDL_WriteLE32(pack, 0) == 1;
+
+    Uint64 nameOffset = HeaderSize + static_cast<Uint64>(names.size()) * RecordSize;
+
+    for (std::size_t i = 0; i < names.size() && written; ++i)
+    {
+      written = SDL_WriteLE32(pack, nameOffset) == 1
+	&&      SDL_WriteLE32(pack, names[i].size()) == 1
+	&&      SDL_WriteLE64(pack, offsets[i]) == 1
+	&&      SDL_WriteLE64(pack, sizes[i]) == 1;
+
+      nameOffset += names[i].size();
+    }
+
+    for (const std::string& name : names)
+      written = written && SDL_RWwrite(pack, name.data(), 1, name.size()) == name.size();
+
+    static const Uint8 padding[Alignment] = {};
+    std::vector<Uint8> buffer(1 << 16);
+
+    Uint64 position = namesEnd;
+
+    for (std::size_t i = 0; i < names.size() && written; ++i)
+    {
+      written = SDL_RWwrite(pack, padding, 1, offsets[i] - position) == offsets[i] - position;
+
+      SDL_RWops* file = SDL_RWFromFile((prefix + names[i]).c_str(), "rb");
+
+      Uint64 left = sizes[i];
+
+      while (written && file != nullptr && left > 0)
+      {
+	const std::size_t chunk = std::min<Uint64>(left, buffer.size());
+
+	written = SDL_RWread(file, buffer.data(), 1, chunk) == chunk
+	  &&      SDL_RWwrite(pack, buffer.data(), 1, chunk) == chunk;
+
+	left -= chunk;
+      }
+
+      if (file != nullptr)
+	SDL_RWclose(file);
+
+      written = written && file != nullptr;
+      position = offsets[i] + sizes[i];
+    }
+
+    if (SDL_RWclose(pack) != 0 || !written)
+      throw Error("AssetPack: writing the pack failed");
+  }
+
+  bool AssetPack::contains(const std::string& name) const
+  {
+    return this->find(name) != nullptr;
+  }
+
+  AssetPack::Entry AssetPack::get(const std::string& name) const
+  {
+    const Uint8* record = this->find(name);
+
+    if (record == nullptr)
+      throw Error("AssetPack: no such entry");
+
+    return Entry {m_file.getData() + readLE64(record + 8),
+		  static_cast<std::size_t>(readLE64(record + 16))};
+  }
+
+  SDL_RWops* AssetPack::open(const std::string& name) const
+  {
+    const Entry entry = this->get(name);
+
+    if (entry.size > static_cast<std::size_t>(SDL_MAX_SINT32))
+      throw Error("AssetPack: entry too large for SDL_RWops");
+
+    SDL_RWops* source = SDL_RWFromConstMem(entry.data, static_cast<int>(entry.size));
+
+    if (source == nullptr)
+      throw Error(SDL_GetError());
+
+    return source;
+  }
+
+#ifdef _SDL_TTF_H
+  TTF_Font* AssetPack::openFont(const std::string& name, int size) const
+  {
+    TTF_Font* font = TTF_OpenFontRW(this->open(name), 1, size);
+
+    if (font == nullptr)
+      throw Error(TTF_GetError());
+
+    return font;
+  }
+#endif
+
+  std::size_t AssetPack::getCount() const
+  {
+    return m_count;
+  }
+
+  std::string AssetPack::getName(std::size_t index) const
+  {
+    const Uint8* record = m_index + index * RecordSize;
+
+    return std::string(reinterpret_cast<const char*>(m_file.getData() + readLE32(record)),
+		       readLE32(record + 4));
+  }
+
+  // Private methods of class AssetPack
+
+  const Uint8* AssetPack::find(const std::string& name) const
+  {
+    const Uint8* data = m_file.getData();
+
+    // Same order as std::string::compare, which sorted the names
+    auto compare = [&](const Uint8* record) -> int
+      {
+	const char*       other  = reinterpret_cast<const char*>(data + readLE32(record));
+	const std::size_t length = readLE32(record + 4);
+
+	const int common = std::memcmp(other, name.data(), std::min(length, name.size()));
+
+	if (common != 0)
+	  return common;
+
+	return length < name.size() ? -1 : (length > name.size() ? 1 : 0);
+      };
+
+    std::size_t first = 0;
+    std::size_t last  = m_count;
+
+    while (first < last)
+    {
+      const std::size_t middle = first + (last - first) / 2;
+      const int         order  = compare(m_index + middle * RecordSize);
+
+      if (order == 0)
+	return m_index + middle * RecordSize;
+
+      if (order < 0)
+	first = middle + 1;
+      else
+	last = middle;
+    }
+
+    return nullptr;
+  }
+
+}
@@ -0,0 +1,165 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "BakedImage.hpp"
+#include "AssetPack.hpp"
+
+#include <cstring>
+
+namespace SO
+{
+
+  namespace
+  {
+    Uint32 readLE32(const Uint8* data)
+    {
+      Uint32 value;
+
+      std::memcpy(&value, data, sizeof(value));
+
+      return SDL_SwapLE32(value);
+    }
+  }
+
+  // Public methods of class BakedImage
+
+  /* Constructor/destructor */
+
+  BakedImage::BakedImage(const char* path)
+    : m_file(path)
+  {
+    this->parse(m_file.getData(), m_file.getSize());
+  }
+
+  BakedImage::BakedImage(const AssetPack& pack, const std::string& name)
+  {
+    const AssetPack::Entry entry = pack.get(name);
+
+    this->parse(static_cast<const Uint8*>(entry.data), entry.size);
+  }
+
+  /* Methods */
+
+  void BakedImage::bake(Surface& surface, const char* path, PixelFormats format)
+  {
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface.toSDL(),
+						      static_cast<Uint32>(format), 0);
+
+    if (converted == nullptr)
+      throw Error(SDL_GetError());
+
+    Surface pixels(converted);
+
+    SDL_RWops* file = SDL_RWFromFile(path, "wb");
+
+    if (file == nullptr)
+      throw Error(SDL_GetError());
+
+    const Uint32 header[] = {Magic,
+			     Version,
+			     static_cast<Uint32>(format),
+			     static_cast<Uint32>(converted->w),
+			     static_cast<Uint32>(converted->h),
+			     static_cast<Uint32>(converted->pitch),
+			     Alignment};
+
+    static_assert(sizeof(header) == HeaderSize, "Header size mismatch");
+    static_assert(HeaderSize <= Alignment, "Pixels overlap the header");
+
+    bool written = true;
+
+    for (Uint32 field : header)
+      written = written && SDL_WriteLE32(file, field) == 1;
+
+    const Uint8 padding[Alignment - HeaderSize] = {};
+
+    written = written && SDL_RWwrite(file, padding, sizeof(padding), 1) == 1;
+
+    if (SDL_MUSTLOCK(converted))
+      SDL_LockSurface(converted);
+
+    const std::size_t bytes = static_cast<std::size_t>(converted->pitch) * converted->h;
+
+    written = written && SDL_RWwrite(file, converted->pixels, bytes, 1) == 1;
+
+    if (SDL_MUSTLOCK(converted))
+      SDL_UnlockSurface(converted);
+
+    if (SDL_RWclose(file) != 0 || !written)
+      throw Error("BakedImage: writing the file failed");
+  }
+
+  PixelFormats BakedImage::getFormat() const
+  {
+    return m_format;
+  }
+
+  int BakedImage::getWidth() const
+  {
+    return m_width;
+  }
+
+  int BakedImage::getHeight() const
+  {
+    return m_height;
+  }
+
+  int BakedImage::getPitch() const
+  {
+    return m_pitch;
+  }
+
+  const void* BakedImage::getPixels() const
+  {
+    return m_pixels;
+  }
+
+  // Private methods of class BakedImage
+
+  void BakedImage::parse(const Uint8* data, std::size_t size)
+  {
+    if (size < HeaderSize || readLE32(data) != Magic || readLE32(data + 4) != Version)
+      throw Error("BakedImage: not a baked image");
+
+    const Uint32 format = readLE32(data + 8);
+    const Sint32 width  = readLE32(data + 12);
+    const Sint32 height = readLE32(data + 16);
+    const Sint32 pitch  = readLE32(data + 20);
+    const Uint32 offset = readLE32(data + 24);
+
+    // Packed pixels only. Sizes are computed in 64 bits, the header
+    // can't be trusted not to overflow.
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_BYTESPERPIXEL(format) == 0
+	|| width <= 0 || height <= 0 || pitch <= 0
+	|| static_cast<Uint64>(pitch) < static_cast<Uint64>(width) * SDL_BYTESPERPIXEL(format)
+	|| offset < HeaderSize
+	|| offset + static_cast<Uint64>(pitch) * height > size)
+      throw Error("BakedImage: not a baked image");
+
+    m_format = static_cast<PixelFormats>(format);
+    m_width  = width;
+    m_height = height;
+    m_pitch  = pitch;
+    m_pixels = data + offset;
+  }
+
+}
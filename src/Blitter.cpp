@@ -0,0 +1,1046 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Blitter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) \
+  && SDL_VERSION_ATLEAST(2, 0, 4)
+#include <immintrin.h>
+#define SO_BLITTER_AVX2
+#endif
+
+namespace
+{
+
+  using Row = void (*)(const Uint32* src, Uint32* dst, std::size_t count);
+
+  // x / 255 rounded, exact for x <= 255 * 255
+  inline Uint32 div255(Uint32 x)
+  {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+  }
+
+  inline Uint32 blendPixel(Uint32 s, Uint32 d)
+  {
+    const Uint32 a  = s >> 24;
+    const Uint32 na = 255 - a;
+
+    const Uint32 b = div255((s & 0xFF) * a + (d & 0xFF) * na);
+    const Uint32 g = div255((s >> 8 & 0xFF) * a + (d >> 8 & 0xFF) * na);
+    const Uint32 r = div255((s >> 16 & 0xFF) * a + (d >> 16 & 0xFF) * na);
+    const Uint32 o = div255(255 * a + (d >> 24) * na);
+
+    return o << 24 | r << 16 | g << 8 | b;
+  }
+
+  void blendScalar(const Uint32* src, Uint32* dst, std::size_t count)
+  {
+    for (std::size_t x = 0; x < count; ++x)
+    {
+      const Uint32 a = src[x] >> 24;
+
+      if (a == 0xFF)
+	dst[x] = src[x];
+      else if (a != 0)
+	dst[x] = blendPixel(src[x], dst[x]);
+    }
+  }
+
+#ifdef __SSE2__
+  // Blend 2 pixels unpacked to 16 bits, the source alpha lanes set to 255
+  inline __m128i blend2(__m128i s, __m128i d, __m128i a)
+  {
+    const __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a),
+						  _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a))),
+				    _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+  }
+
+  // Alpha of both pixels in every lane
+  inline __m128i alpha2(__m128i p)
+  {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+  }
+
+  void blendSSE2(const Uint32* src, Uint32* dst, std::size_t count)
+  {
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(0xFF);
+    const __m128i lanes  = _mm_setr_epi16(0, 0, 0, 0xFF, 0, 0, 0, 0xFF);
+
+    std::size_t x = 0;
+
+    for (; x + 4 <= count; x += 4)
+    {
+      const __m128i s = _mm_loadu_si128((const __m128i*)(src + x));
+      const __m128i a = _mm_srli_epi32(s, 24);
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF)
+	continue;
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, opaque)) == 0xFFFF)
+      {
+	_mm_storeu_si128((__m128i*)(dst + x), s);
+	continue;
+      }
+
+      const __m128i d = _mm_loadu_si128((const __m128i*)(dst + x));
+
+      const __m128i slo = _mm_unpacklo_epi8(s, zero);
+      const __m128i shi = _mm_unpackhi_epi8(s, zero);
+
+      const __m128i lo = blend2(_mm_or_si128(slo, lanes), _mm_unpacklo_epi8(d, zero), alpha2(slo));
+      const __m128i hi = blend2(_mm_or_si128(shi, lanes), _mm_unpackhi_epi8(d, zero), alpha2(shi));
+
+      _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(lo, hi));
+    }
+
+    blendScalar(src + x, dst + x, count - x);
+  }
+#endif
+
+#ifdef SO_BLITTER_AVX2
+  __attribute__((target("avx2")))
+  inline __m256i blend4(__m256i s, __m256i d, __m256i a)
+  {
+    const __m256i t = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, a),
+							_mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a))),
+				       _mm256_set1_epi16(128));
+
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+  }
+
+  __attribute__((target("avx2")))
+  inline __m256i alpha4(__m256i p)
+  {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+  }
+
+  // Same as the SSE2 kernel, 8 pixels at a time
+  __attribute__((target("avx2")))
+  void blendAVX2(const Uint32* src, Uint32* dst, std::size_t count)
+  {
+    const __m256i zero   = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32(0xFF);
+    const __m256i lanes  = _mm256_setr_epi16(0, 0, 0, 0xFF, 0, 0, 0, 0xFF,
+					     0, 0, 0, 0xFF, 0, 0, 0, 0xFF);
+
+    std::size_t x = 0;
+
+    for (; x + 8 <= count; x += 8)
+    {
+      const __m256i s = _mm256_loadu_si256((const __m256i*)(src + x));
+      const __m256i a = _mm256_srli_epi32(s, 24);
+
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, zero)) == -1)
+	continue;
+
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, opaque)) == -1)
+      {
+	_mm256_storeu_si256((__m256i*)(dst + x), s);
+	continue;
+      }
+
+      const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + x));
+
+      // Unpacking and packing stay within 128 bits lanes, the order is kept
+      const __m256i slo = _mm256_unpacklo_epi8(s, zero);
+      const __m256i shi = _mm256_unpackhi_epi8(s, zero);
+
+      const __m256i lo = blend4(_mm256_or_si256(slo, lanes), _mm256_unpacklo_epi8(d, zero), alpha4(slo));
+      const __m256i hi = blend4(_mm256_or_si256(shi, lanes), _mm256_unpackhi_epi8(d, zero), alpha4(shi));
+
+      _mm256_storeu_si256((__m256i*)(dst + x), _mm256_packus_epi16(lo, hi));
+    }
+
+    blendScalar(src + x, dst + x, count - x);
+  }
+#endif
+
+  Row rowOf(SO::Blitter::Kernel kernel)
+  {
+    switch (kernel)
+    {
+#ifdef SO_BLITTER_AVX2
+    case SO::Blitter::Kernel::AVX2:
+      return blendAVX2;
+#endif
+#ifdef __SSE2__
+    case SO::Blitter::Kernel::SSE2:
+      return blendSSE2;
+#endif
+    default:
+      return blendScalar;
+    }
+  }
+
+  SO::Blitter::Kernel best()
+  {
+    if (SO::Blitter::isSupported(SO::Blitter::Kernel::AVX2))
+      return SO::Blitter::Kernel::AVX2;
+
+    if (SO::Blitter::isSupported(SO::Blitter::Kernel::SSE2))
+      return SO::Blitter::Kernel::SSE2;
+
+    return SO::Blitter::Kernel::Scalar;
+  }
+
+  // Picked on first use, or forced by SO::Blitter::setKernel
+  std::atomic<int> current(-1);
+
+  SO::Blitter::Kernel selected()
+  {
+    int kernel = current.load(std::memory_order_relaxed);
+
+    if (kernel == -1)
+    {
+      kernel = static_cast<int>(best());
+      current.store(kernel, std::memory_order_relaxed);
+    }
+
+    return static_cast<SO::Blitter::Kernel>(kernel);
+  }
+
+  // Rows of a band fill about the L2 cache of a core
+  const std::size_t BandBytes = 256 * 1024;
+
+  std::atomic<int>         threads(0);
+  std::atomic<std::size_t> threshold(512 * 512);
+
+  // Call band(first, last) over bands of rows, in parallel when large
+  template <typename Band>
+  void split(int width, int height, std::size_t rowBytes, const Band& band)
+  {
+    if (!SO::Blitter::isParallel(width, height))
+    {
+      band(0, height);
+      return;
+    }
+
+    const int workers = SO::Blitter::getThreads();
+
+    // At least a band per thread, even for few long rows
+    const int rows  = std::min<int>(std::max<std::size_t>(BandBytes / std::max<std::size_t>(rowBytes, 1), 1),
+				    (height + workers - 1) / workers);
+    const int count = (height + rows - 1) / rows;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(workers)
+#endif
+    for (int i = 0; i < count; ++i)
+      band(i * rows, std::min(height, (i + 1) * rows));
+  }
+
+  void fillRow(Uint8* row, int bytesPerPixel, int width, Uint32 color)
+  {
+    switch (bytesPerPixel)
+    {
+    case 1:
+      std::memset(row, color, width);
+      break;
+
+    case 2:
+      std::fill_n(reinterpret_cast<Uint16*>(row), width, static_cast<Uint16>(color));
+      break;
+
+    case 3:
+      {
+	// Byte order of SDL_FillRect
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	const Uint8 bytes[3] = {Uint8(color), Uint8(color >> 8), Uint8(color >> 16)};
+#else
+	const Uint8 bytes[3] = {Uint8(color >> 16), Uint8(color >> 8), Uint8(color)};
+#endif
+
+	for (int x = 0; x < width; ++x, row += 3)
+	  std::memcpy(row, bytes, 3);
+      }
+      break;
+
+    default:
+      std::fill_n(reinterpret_cast<Uint32*>(row), width, color);
+      break;
+    }
+  }
+
+  /*
+   * Filters work on the 4 bytes of a pixel independently, with 16 bits
+   * intermediate values. Linear weights are in 1/128, the two passes
+   * leave 14 bits to round off. Box weights are in 1/16384, the
+   * horizontal pass rounds 7 bits off and the vertical one 21.
+   */
+
+  // Two source pixels and the weight of the second one
+  struct Tap
+  {
+    int first;
+    int second;
+    int weight;
+  };
+
+  // Source pixels covered by a destination pixel, and their weights
+  struct Span
+  {
+    int first;
+    int count;
+    int weights;
+  };
+
+  // Pixel centers mapped back, clamped to the edges
+  std::vector<Tap> linearTaps(int src, int dst)
+  {
+    std::vector<Tap> taps(dst);
+
+    for (int i = 0; i < dst; ++i)
+    {
+      const Sint64 position = (Sint64(2 * i + 1) * src * 128) / (2 * dst) - 64;
+      const Sint64 clamped  = std::min<Sint64>(std::max<Sint64>(position, 0), Sint64(src - 1) * 128);
+
+      taps[i].first  = clamped >> 7;
+      taps[i].second = std::min(taps[i].first + 1, src - 1);
+      taps[i].weight = clamped & 127;
+    }
+
+    return taps;
+  }
+
+  // Destination pixel i covers [i * src, (i + 1) * src) in units of a
+  // source pixel over dst, the weights of a span sum up to 16384
+  std::vector<Span> boxSpans(int src, int dst, std::vector<Sint16>& weights)
+  {
+    std::vector<Span> spans(dst);
+
+    for (int i = 0; i < dst; ++i)
+    {
+      const Sint64 begin = Sint64(i) * src;
+      const Sint64 end   = Sint64(i + 1) * src;
+
+      spans[i].first   = begin / dst;
+      spans[i].count   = (end + dst - 1) / dst - spans[i].first;
+      spans[i].weights = weights.size();
+
+      int total   = 0;
+      int largest = spans[i].weights;
+
+      for (int j = spans[i].first; j < spans[i].first + spans[i].count; ++j)
+      {
+	const Sint64 overlap = std::min<Sint64>(Sint64(j + 1) * dst, end) - std::max<Sint64>(Sint64(j) * dst, begin);
+	const Sint16 weight  = (overlap * 16384 + src / 2) / src;
+
+	if (largest == int(weights.size()) || weight > weights[largest])
+	  largest = weights.size();
+
+	weights.push_back(weight);
+	total += weight;
+      }
+
+      // Rounding errors go to the largest weight
+      weights[largest] += 16384 - total;
+    }
+
+    return spans;
+  }
+
+  // out = a * (128 - weight) + b * weight, for count bytes
+  void lerpRows(const Uint8* a, const Uint8* b, int weight, Sint16* out, int count, bool simd)
+  {
+    int i = 0;
+
+#ifdef __SSE2__
+    if (simd)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i wa   = _mm_set1_epi16(128 - weight);
+      const __m128i wb   = _mm_set1_epi16(weight);
+
+      for (; i + 16 <= count; i += 16)
+      {
+	const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+	const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+
+	_mm_storeu_si128((__m128i*)(out + i),
+			 _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), wa),
+				       _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb)));
+	_mm_storeu_si128((__m128i*)(out + i + 8),
+			 _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), wa),
+				       _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb)));
+      }
+    }
+#endif
+
+    for (; i < count; ++i)
+      out[i] = a[i] * (128 - weight) + b[i] * weight;
+  }
+
+  // Horizontal pass of Linear, from the output of lerpRows
+  void lerpColumns(const Sint16* rows, const Tap* taps, Uint32* out, int width, bool simd)
+  {
+    int x = 0;
+
+#ifdef __SSE2__
+    if (simd)
+    {
+      const __m128i round = _mm_set1_epi32(8192);
+
+      // Pairs of lanes of both pixels, weighted by madd
+      auto pixel = [&](const Tap& tap)
+	{
+	  const __m128i a = _mm_loadl_epi64((const __m128i*)(rows + tap.first * 4));
+	  const __m128i b = _mm_loadl_epi64((const __m128i*)(rows + tap.second * 4));
+
+	  const __m128i sum = _mm_madd_epi16(_mm_unpacklo_epi16(a, b),
+					     _mm_set1_epi32(tap.weight << 16 | (128 - tap.weight)));
+
+	  return _mm_srai_epi32(_mm_add_epi32(sum, round), 14);
+	};
+
+      for (; x + 4 <= width; x += 4)
+      {
+	const __m128i lo = _mm_packs_epi32(pixel(taps[x]), pixel(taps[x + 1]));
+	const __m128i hi = _mm_packs_epi32(pixel(taps[x + 2]), pixel(taps[x + 3]));
+
+	_mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+      }
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+      const Sint16* a = rows + taps[x].first * 4;
+      const Sint16* b = rows + taps[x].second * 4;
+      const int     w = taps[x].weight;
+
+      Uint32 pixel = 0;
+
+      for (int c = 0; c < 4; ++c)
+	pixel |= Uint32((a[c] * (128 - w) + b[c] * w + 8192) >> 14) << (8 * c);
+
+      out[x] = pixel;
+    }
+  }
+
+  // Horizontal pass of Box, weighted sums of the covered pixels of a row
+  void boxColumns(const Uint32* row, const Span* spans, const Sint16* weights,
+		  Sint16* out, int width, bool simd)
+  {
+#ifdef __SSE2__
+    if (simd)
+    {
+      const __m128i zero  = _mm_setzero_si128();
+      const __m128i round = _mm_set1_epi32(64);
+
+      for (int x = 0; x < width; ++x)
+      {
+	const Uint32* p = row + spans[x].first;
+	const Sint16* w = weights + spans[x].weights;
+
+	__m128i sum = round;
+
+	// Bytes of two pixels interleaved, weighted by madd
+	for (int i = 0; i < spans[x].count; i += 2)
+	{
+	  const bool   pair = i + 1 < spans[x].count;
+	  const __m128i a   = _mm_cvtsi32_si128(p[i]);
+	  const __m128i b   = _mm_cvtsi32_si128(pair ? p[i + 1] : 0);
+
+	  const Uint32 both = Uint32(pair ? w[i + 1] : 0) << 16 | Uint16(w[i]);
+
+	  sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(a, b), zero),
+						  _mm_set1_epi32(both)));
+	}
+
+	sum = _mm_srai_epi32(sum, 7);
+	_mm_storel_epi64((__m128i*)(out + x * 4), _mm_packs_epi32(sum, sum));
+      }
+
+      return;
+    }
+#endif
+
+    for (int x = 0; x < width; ++x)
+    {
+      const Uint32* p = row + spans[x].first;
+      const Sint16* w = weights + spans[x].weights;
+
+      for (int c = 0; c < 4; ++c)
+      {
+	int sum = 64;
+
+	for (int i = 0; i < spans[x].count; ++i)
+	  sum += (p[i] >> (8 * c) & 0xFF) * w[i];
+
+	out[x * 4 + c] = sum >> 7;
+      }
+    }
+  }
+
+  // Vertical pass of Box, sums += rows * weight
+  void boxAccumulate(const Sint16* rows, int weight, Sint32* sums, int count, bool simd)
+  {
+    int i = 0;
+
+#ifdef __SSE2__
+    if (simd)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i w    = _mm_set1_epi32(weight);
+
+      for (; i + 8 <= count; i += 8)
+      {
+	const __m128i v = _mm_loadu_si128((const __m128i*)(rows + i));
+
+	_mm_storeu_si128((__m128i*)(sums + i),
+			 _mm_add_epi32(_mm_loadu_si128((const __m128i*)(sums + i)),
+				       _mm_madd_epi16(_mm_unpacklo_epi16(v, zero), w)));
+	_mm_storeu_si128((__m128i*)(sums + i + 4),
+			 _mm_add_epi32(_mm_loadu_si128((const __m128i*)(sums + i + 4)),
+				       _mm_madd_epi16(_mm_unpackhi_epi16(v, zero), w)));
+      }
+    }
+#endif
+
+    for (; i < count; ++i)
+      sums[i] += rows[i] * weight;
+  }
+
+  // Round the sums of boxAccumulate off to pixels
+  void boxResolve(const Sint32* sums, Uint32* out, int width, bool simd)
+  {
+    int x = 0;
+
+#ifdef __SSE2__
+    if (simd)
+    {
+      const __m128i round = _mm_set1_epi32(1 << 20);
+
+      auto load = [&](int i)
+	{
+	  return _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(sums + i)), round), 21);
+	};
+
+      for (; x + 4 <= width; x += 4)
+      {
+	const __m128i lo = _mm_packs_epi32(load(x * 4), load(x * 4 + 4));
+	const __m128i hi = _mm_packs_epi32(load(x * 4 + 8), load(x * 4 + 12));
+
+	_mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+      }
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+      Uint32 pixel = 0;
+
+      for (int c = 0; c < 4; ++c)
+	pixel |= Uint32((sums[x * 4 + c] + (1 << 20)) >> 21) << (8 * c);
+
+      out[x] = pixel;
+    }
+  }
+
+  // Shifts of red, green, blue and alpha in the value of a pixel, -1
+  // for a missing channel. 24 bits values are read byte after byte.
+  struct Layout
+  {
+    int bytes;
+    int shifts[4];
+  };
+
+  bool layoutOf(SO::PixelFormats format, Layout& layout)
+  {
+    switch (format)
+    {
+    case SO::PixelFormats::RGB24:    layout = {3, {0, 8, 16, -1}};   return true;
+    case SO::PixelFormats::BGR24:    layout = {3, {16, 8, 0, -1}};   return true;
+    case SO::PixelFormats::RGB888:   layout = {4, {16, 8, 0, -1}};   return true;
+    case SO::PixelFormats::RGBX8888: layout = {4, {24, 16, 8, -1}};  return true;
+    case SO::PixelFormats::BGR888:   layout = {4, {0, 8, 16, -1}};   return true;
+    case SO::PixelFormats::BGRX8888: layout = {4, {8, 16, 24, -1}};  return true;
+    case SO::PixelFormats::ARGB8888: layout = {4, {16, 8, 0, 24}};   return true;
+    case SO::PixelFormats::RGBA8888: layout = {4, {24, 16, 8, 0}};   return true;
+    case SO::PixelFormats::ABGR8888: layout = {4, {0, 8, 16, 24}};   return true;
+    case SO::PixelFormats::BGRA8888: layout = {4, {8, 16, 24, 0}};   return true;
+    default:                                                         return false;
+    }
+  }
+
+  struct Conversion
+  {
+    Layout from;
+    Layout to;
+    Uint32 fill;        // opaque alpha of sources without one
+    Uint8  shuffle[16]; // destination bytes of 4 pixels, from source bytes
+  };
+
+  Conversion conversionOf(const Layout& from, const Layout& to)
+  {
+    Conversion conversion = {from, to, 0, {}};
+
+    if (from.shifts[3] < 0 && to.shifts[3] >= 0)
+      conversion.fill = 0xFFu << to.shifts[3];
+
+    // Source bytes are little endian, as on every CPU with the kernels
+    for (int pixel = 0; pixel < 4; ++pixel)
+      for (int byte = 0; byte < 4; ++byte)
+      {
+	Uint8 index = 0x80;
+
+	for (int channel = 0; channel < 4; ++channel)
+	  if (to.shifts[channel] == 8 * byte && from.shifts[channel] >= 0)
+	    index = pixel * from.bytes + from.shifts[channel] / 8;
+
+	conversion.shuffle[pixel * 4 + byte] = index;
+      }
+
+    return conversion;
+  }
+
+  inline Uint32 loadPixel(const Uint8* pixel, int bytes)
+  {
+    if (bytes == 3)
+      return pixel[0] | pixel[1] << 8 | pixel[2] << 16;
+
+    Uint32 value;
+
+    std::memcpy(&value, pixel, 4);
+
+    return value;
+  }
+
+  inline void storePixel(Uint8* pixel, int bytes, Uint32 value)
+  {
+    if (bytes == 3)
+    {
+      pixel[0] = value;
+      pixel[1] = value >> 8;
+      pixel[2] = value >> 16;
+    }
+    else
+      std::memcpy(pixel, &value, 4);
+  }
+
+  using Convert = void (*)(const Uint8* src, Uint8* dst, int count, const Conversion& conversion);
+
+  void convertScalar(const Uint8* src, Uint8* dst, int count, const Conversion& conversion)
+  {
+    const Layout& from = conversion.from;
+    const Layout& to   = conversion.to;
+
+    for (int x = 0; x < count; ++x, src += from.bytes, dst += to.bytes)
+    {
+      const Uint32 value = loadPixel(src, from.bytes);
+
+      Uint32 pixel = conversion.fill;
+
+      for (int channel = 0; channel < 4; ++channel)
+	if (from.shifts[channel] >= 0 && to.shifts[channel] >= 0)
+	  pixel |= (value >> from.shifts[channel] & 0xFF) << to.shifts[channel];
+
+      storePixel(dst, to.bytes, pixel);
+    }
+  }
+
+#ifdef __SSE2__
+  // 24 or 32 to 32 bits, channels moved with shifts and masks
+  void convertSSE2(const Uint8* src, Uint8* dst, int count, const Conversion& conversion)
+  {
+    const int     bytes = conversion.from.bytes;
+    const __m128i mask  = _mm_set1_epi32(0xFF);
+    const __m128i fill  = _mm_set1_epi32(conversion.fill);
+
+    __m128i right[4], left[4];
+    int     channels = 0;
+
+    for (int channel = 0; channel < 4; ++channel)
+      if (conversion.from.shifts[channel] >= 0 && conversion.to.shifts[channel] >= 0)
+      {
+	right[channels] = _mm_cvtsi32_si128(conversion.from.shifts[channel]);
+	left[channels]  = _mm_cvtsi32_si128(conversion.to.shifts[channel]);
+	++channels;
+      }
+
+    int x = 0;
+
+    // 24 bits pixels are loaded 4 bytes at a time, reading one past them
+    for (; x + 4 + (bytes == 3 ? 1 : 0) <= count; x += 4)
+    {
+      const Uint8* s = src + x * bytes;
+
+      const __m128i value = bytes == 4 ? _mm_loadu_si128((const __m128i*)s)
+	: _mm_setr_epi32(loadPixel(s, 4), loadPixel(s + 3, 4), loadPixel(s + 6, 4), loadPixel(s + 9, 4));
+
+      __m128i pixel = fill;
+
+      for (int i = 0; i < channels; ++i)
+	pixel = _mm_or_si128(pixel, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(value, right[i]), mask), left[i]));
+
+      _mm_storeu_si128((__m128i*)(dst + x * 4), pixel);
+    }
+
+    convertScalar(src + x * bytes, dst + x * 4, count - x, conversion);
+  }
+#endif
+
+#ifdef SO_BLITTER_AVX2
+  // 24 or 32 to 32 bits, a byte shuffle per 128 bits lane of 4 pixels
+  __attribute__((target("avx2")))
+  void convertAVX2(const Uint8* src, Uint8* dst, int count, const Conversion& conversion)
+  {
+    const int     bytes   = conversion.from.bytes;
+    const __m128i lane    = _mm_loadu_si128((const __m128i*)conversion.shuffle);
+    const __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(lane), lane, 1);
+    const __m256i fill    = _mm256_set1_epi32(conversion.fill);
+
+    int x = 0;
+
+    // The second load of 24 bits pixels reads 4 bytes past them
+    for (; x + 8 + (bytes == 3 ? 2 : 0) <= count; x += 8)
+    {
+      const Uint8* s = src + x * bytes;
+
+      const __m256i value = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)s)),
+						    _mm_loadu_si128((const __m128i*)(s + 4 * bytes)), 1);
+
+      _mm256_storeu_si256((__m256i*)(dst + x * 4), _mm256_or_si256(_mm256_shuffle_epi8(value, shuffle), fill));
+    }
+
+    convertScalar(src + x * bytes, dst + x * 4, count - x, conversion);
+  }
+#endif
+
+  Convert convertOf(SO::Blitter::Kernel kernel, const Conversion& conversion)
+  {
+    if (conversion.to.bytes != 4)
+      return convertScalar;
+
+    switch (kernel)
+    {
+#ifdef SO_BLITTER_AVX2
+    case SO::Blitter::Kernel::AVX2:
+      return convertAVX2;
+#endif
+#ifdef __SSE2__
+    case SO::Blitter::Kernel::SSE2:
+      return convertSSE2;
+#endif
+    default:
+      return convertScalar;
+    }
+  }
+
+}
+
+namespace SO
+{
+
+  // Public methods of class Blitter
+
+  /* Methods */
+
+  bool Blitter::isSupported(Kernel kernel)
+  {
+    switch (kernel)
+    {
+    case Kernel::Scalar:
+      return true;
+
+#ifdef __SSE2__
+    case Kernel::SSE2:
+      return SDL_HasSSE2();
+#endif
+
+#ifdef SO_BLITTER_AVX2
+    case Kernel::AVX2:
+      return SDL_HasAVX2();
+#endif
+
+    default:
+      return false;
+    }
+  }
+
+  Blitter::Kernel Blitter::getKernel()
+  {
+    return selected();
+  }
+
+  void Blitter::setKernel(Kernel kernel)
+  {
+    if (!isSupported(kernel))
+      throw Error("Blitter: kernel not supported by this CPU");
+
+    current.store(static_cast<int>(kernel), std::memory_order_relaxed);
+  }
+
+  void Blitter::blendRow(const Uint32* src, Uint32* dst, std::size_t count)
+  {
+    rowOf(selected())(src, dst, count);
+  }
+
+  void Blitter::blend(const void* src, int srcPitch,
+		      void* dst, int dstPitch,
+		      int width, int height)
+  {
+    const Row row = rowOf(selected());
+
+    split(width, height, std::size_t(width) * 4, [&](int first, int last)
+	  {
+	    const Uint8* s = static_cast<const Uint8*>(src) + first * srcPitch;
+	    Uint8*       d = static_cast<Uint8*>(dst) + first * dstPitch;
+
+	    for (int y = first; y < last; ++y, s += srcPitch, d += dstPitch)
+	      row(reinterpret_cast<const Uint32*>(s), reinterpret_cast<Uint32*>(d), width);
+	  });
+  }
+
+  void Blitter::copy(const void* src, int srcPitch,
+		     void* dst, int dstPitch,
+		     int width, int height)
+  {
+    // Parallel from the same number of bytes as 32 bits pixels
+    split(width / 4, height, width, [&](int first, int last)
+	  {
+	    const Uint8* s = static_cast<const Uint8*>(src) + first * srcPitch;
+	    Uint8*       d = static_cast<Uint8*>(dst) + first * dstPitch;
+
+	    for (int y = first; y < last; ++y, s += srcPitch, d += dstPitch)
+	      std::memcpy(d, s, width);
+	  });
+  }
+
+  void Blitter::fill(void* dst, int pitch, int bytesPerPixel,
+		     int width, int height, Uint32 color)
+  {
+    if (bytesPerPixel < 1 || bytesPerPixel > 4)
+      throw Error("Blitter: unsupported pixel size");
+
+    split(width, height, std::size_t(width) * bytesPerPixel, [&](int first, int last)
+	  {
+	    Uint8* d = static_cast<Uint8*>(dst) + first * pitch;
+
+	    for (int y = first; y < last; ++y, d += pitch)
+	      fillRow(d, bytesPerPixel, width, color);
+	  });
+  }
+
+  void Blitter::scale(const void* src, int srcPitch, int srcWidth, int srcHeight,
+		      void* dst, int dstPitch, int dstWidth, int dstHeight,
+		      bool blend, ScaleFilters filter)
+  {
+    if (dstWidth <= 0 || dstHeight <= 0 || srcWidth <= 0 || srcHeight <= 0)
+      return;
+
+    const Row  row  = rowOf(selected());
+    const bool simd = selected() != Kernel::Scalar;
+
+    auto source = [&](int y)
+      {
+	return reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(src) + y * srcPitch);
+      };
+
+    // Rows are made in out, then blended onto or copied to the destination
+    auto output = [&](const std::function<void(int, Uint32*)>& make)
+      {
+	split(dstWidth, dstHeight, std::size_t(dstWidth) * 4, [&](int first, int last)
+	      {
+		std::vector<Uint32> buffer(blend ? dstWidth : 0);
+
+		for (int y = first; y < last; ++y)
+		  {
+		    Uint32* d = reinterpret_cast<Uint32*>(static_cast<Uint8*>(dst) + y * dstPitch);
+
+		    make(y, blend ? buffer.data() : d);
+
+		    if (blend)
+		      row(buffer.data(), d, dstWidth);
+		  }
+	      });
+      };
+
+    switch (filter)
+    {
+    case ScaleFilters::Linear:
+      {
+	const std::vector<Tap> columns = linearTaps(srcWidth, dstWidth);
+	const std::vector<Tap> rows    = linearTaps(srcHeight, dstHeight);
+
+	output([&](int y, Uint32* out)
+	       {
+		 thread_local std::vector<Sint16> lerped;
+
+		 lerped.resize(std::size_t(srcWidth) * 4);
+
+		 lerpRows(reinterpret_cast<const Uint8*>(source(rows[y].first)),
+			  reinterpret_cast<const Uint8*>(source(rows[y].second)),
+			  rows[y].weight, lerped.data(), srcWidth * 4, simd);
+		 lerpColumns(lerped.data(), columns.data(), out, dstWidth, simd);
+	       });
+      }
+      break;
+
+    case ScaleFilters::Box:
+      {
+	std::vector<Sint16> weights;
+
+	const std::vector<Span> columns = boxSpans(srcWidth, dstWidth, weights);
+	const std::vector<Span> rows    = boxSpans(srcHeight, dstHeight, weights);
+
+	output([&](int y, Uint32* out)
+	       {
+		 thread_local std::vector<Sint16> summed;
+		 thread_local std::vector<Sint32> sums;
+
+		 summed.resize(std::size_t(dstWidth) * 4);
+		 sums.assign(std::size_t(dstWidth) * 4, 0);
+
+		 for (int i = 0; i < rows[y].count; ++i)
+		   {
+		     boxColumns(source(rows[y].first + i), columns.data(), weights.data(),
+				summed.data(), dstWidth, simd);
+		     boxAccumulate(summed.data(), weights[rows[y].weights + i],
+				   sums.data(), dstWidth * 4, simd);
+		   }
+
+		 boxResolve(sums.data(), out, dstWidth, simd);
+	       });
+      }
+      break;
+
+    default:
+      {
+	// 16.16 fixed point steps, starting half a step in as SDL
+	const Uint32 stepX = (Uint32(srcWidth) << 16) / dstWidth;
+	const Uint32 stepY = (Uint32(srcHeight) << 16) / dstHeight;
+
+	std::vector<int> columns(dstWidth);
+
+	for (int x = 0; x < dstWidth; ++x)
+	  columns[x] = (stepX / 2 + Uint64(x) * stepX) >> 16;
+
+	output([&](int y, Uint32* out)
+	       {
+		 const Uint32* s = source((stepY / 2 + Uint64(y) * stepY) >> 16);
+
+		 for (int x = 0; x < dstWidth; ++x)
+		   out[x] = s[columns[x]];
+	       });
+      }
+      break;
+    }
+  }
+
+  bool Blitter::canConvert(PixelFormats from, PixelFormats to)
+  {
+    Layout unused;
+
+    return layoutOf(from, unused) && layoutOf(to, unused);
+  }
+
+  void Blitter::convert(const void* src, int srcPitch, PixelFormats srcFormat,
+			void* dst, int dstPitch, PixelFormats dstFormat,
+			int width, int height)
+  {
+    Layout from, to;
+
+    const bool native = layoutOf(srcFormat, from) && layoutOf(dstFormat, to);
+
+    // Each pixel is read before being written, rows too if pitches match
+    if (src == dst && (!native || from.bytes != to.bytes || srcPitch != dstPitch))
+      throw Error("Blitter: unsupported in-place conversion");
+
+    if (!native)
+      {
+	if (SDL_ConvertPixels(width, height,
+			      static_cast<Uint32>(srcFormat), src, srcPitch,
+			      static_cast<Uint32>(dstFormat), dst, dstPitch) != 0)
+	  throw Error(SDL_GetError());
+
+	return;
+      }
+
+    const Conversion conversion = conversionOf(from, to);
+    const Convert    row        = convertOf(selected(), conversion);
+
+    split(width, height, std::size_t(width) * 4, [&](int first, int last)
+	  {
+	    const Uint8* s = static_cast<const Uint8*>(src) + first * srcPitch;
+	    Uint8*       d = static_cast<Uint8*>(dst) + first * dstPitch;
+
+	    for (int y = first; y < last; ++y, s += srcPitch, d += dstPitch)
+	      row(s, d, width, conversion);
+	  });
+  }
+
+  int Blitter::getThreads()
+  {
+#ifdef _OPENMP
+    const int count = threads.load(std::memory_order_relaxed);
+
+    return count > 0 ? count : omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  void Blitter::setThreads(int count)
+  {
+    if (count < 0)
+      throw Error("Blitter: negative number of threads");
+
+    threads.store(count, std::memory_order_relaxed);
+  }
+
+  std::size_t Blitter::getThreshold()
+  {
+    return threshold.load(std::memory_order_relaxed);
+  }
+
+  void Blitter::setThreshold(std::size_t pixels)
+  {
+    threshold.store(pixels, std::memory_order_relaxed);
+  }
+
+  bool Blitter::isParallel(int width, int height)
+  {
+    return width > 0 && height > 1
+      && std::size_t(width) * height >= getThreshold()
+      && getThreads() > 1;
+  }
+
+}
@@ -0,0 +1,205 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "DamageTracker.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+  inline const SDL_Rect& sdl(const SO::Rect& rect)
+  {
+    return *(const SDL_Rect*)&rect;
+  }
+
+  inline Sint64 area(const SDL_Rect& rect)
+  {
+    return static_cast<Sint64>(rect.w) * rect.h;
+  }
+
+  inline SDL_Rect unite(const SDL_Rect& a, const SDL_Rect& b)
+  {
+    const int x = std::min(a.x, b.x);
+    const int y = std::min(a.y, b.y);
+
+    return {x, y,
+	    std::max(a.x + a.w, b.x + b.w) - x,
+	    std::max(a.y + a.h, b.y + b.h) - y};
+  }
+
+  // True if a and b overlap or are less than margin pixels apart
+  inline bool near(const SDL_Rect& a, const SDL_Rect& b, int margin)
+  {
+    return a.x < b.x + b.w + margin && b.x < a.x + a.w + margin &&
+      a.y < b.y + b.h + margin && b.y < a.y + a.h + margin;
+  }
+
+}
+
+namespace SO
+{
+
+  // Public methods of class DamageTracker
+
+  /* Constructor/destructor */
+
+  DamageTracker::DamageTracker(int margin, std::size_t maxRects)
+    : m_margin(margin),
+      m_maxRects(maxRects > 0 ? maxRects : 1),
+      m_bounds()
+  {
+
+  }
+
+  /* Methods */
+
+  DamageTracker& DamageTracker::add(const Rect& rect)
+  {
+    SDL_Rect damage = sdl(rect);
+
+    if (m_bounds.getWidth() != 0 && m_bounds.getHeight() != 0)
+    {
+      const SDL_Rect& bounds = sdl(m_bounds);
+
+      const int x0 = std::max(damage.x, bounds.x);
+      const int y0 = std::max(damage.y, bounds.y);
+      const int x1 = std::min(damage.x + damage.w, bounds.x + bounds.w);
+      const int y1 = std::min(damage.y + damage.h, bounds.y + bounds.h);
+
+      damage = {x0, y0, x1 - x0, y1 - y0};
+    }
+
+    if (damage.w <= 0 || damage.h <= 0)
+      return *this;
+
+    // Already covered, leave the set untouched
+    for (const Rect& rect : m_rects)
+    {
+      const SDL_Rect& r = sdl(rect);
+
+      if (damage.x >= r.x && damage.y >= r.y &&
+	  damage.x + damage.w <= r.x + r.w && damage.y + damage.h <= r.y + r.h)
+	return *this;
+    }
+
+    // Absorb every rect near the damage, growing it until none is left
+    for (std::size_t i = 0; i < m_rects.size();)
+    {
+      if (near(sdl(m_rects[i]), damage, m_margin))
+      {
+	damage = unite(sdl(m_rects[i]), damage);
+	m_rects[i] = m_rects.back();
+	m_rects.pop_back();
+	i = 0;
+      }
+      else
+	++i;
+    }
+
+    m_rects.push_back(damage);
+
+    while (m_rects.size() > m_maxRects)
+    {
+      std::size_t first = 0, second = 1;
+      Sint64      best  = -1;
+
+      for (std::size_t i = 0; i < m_rects.size(); ++i)
+	for (std::size_t j = i + 1; j < m_rects.size(); ++j)
+	{
+	  const SDL_Rect& a = sdl(m_rects[i]);
+	  const SDL_Rect& b = sdl(m_rects[j]);
+
+	  const Sint64 waste = area(unite(a, b)) - area(a) - area(b);
+
+	  if (best < 0 || waste < best)
+	  {
+	    best   = waste;
+	    first  = i;
+	    second = j;
+	  }
+	}
+
+      const SDL_Rect merged = unite(sdl(m_rects[first]), sdl(m_rects[second]));
+
+      m_rects[second] = m_rects.back();
+      m_rects.pop_back();
+      m_rects[first] = m_rects.back();
+      m_rects.pop_back();
+
+      // The union may now reach other rects
+      this->add(merged);
+    }
+
+    return *this;
+  }
+
+  DamageTracker& DamageTracker::addAll()
+  {
+    m_rects.clear();
+
+    if (m_bounds.getWidth() != 0 && m_bounds.getHeight() != 0)
+      m_rects.push_back(m_bounds);
+
+    return *this;
+  }
+
+  DamageTracker& DamageTracker::clear()
+  {
+    m_rects.clear();
+
+    return *this;
+  }
+
+  Rect DamageTracker::getBounds() const
+  {
+    return m_bounds;
+  }
+
+  Uint64 DamageTracker::getArea() const
+  {
+    Uint64 total = 0;
+
+    for (const Rect& rect : m_rects)
+      total += area(sdl(rect));
+
+    return total;
+  }
+
+  const std::vector<Rect>& DamageTracker::getRects() const
+  {
+    return m_rects;
+  }
+
+  bool DamageTracker::isEmpty() const
+  {
+    return m_rects.empty();
+  }
+
+  DamageTracker& DamageTracker::setBounds(const Rect& bounds)
+  {
+    m_bounds = bounds;
+
+    return *this;
+  }
+
+}
@@ -0,0 +1,204 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "FontAtlas.hpp"
+#include "Renderer.hpp"
+
+#include <algorithm>
+
+#ifdef _SDL_TTF_H
+
+namespace SO
+{
+
+  // Public methods of class FontAtlas
+
+  /* Constructor/destructor */
+
+  FontAtlas::FontAtlas(Renderer& renderer, int pageSize)
+    : m_renderer(renderer),
+      m_atlas(renderer, pageSize, pageSize)
+  {
+
+  }
+
+  /* Methods */
+
+  FontAtlas& FontAtlas::drawText(TTF_Font* font,
+				 const std::string& text,
+				 int x, int y,
+				 const Color& color)
+  {
+    const int lineSkip = TTF_FontLineSkip(font);
+
+    m_sprites.clear();
+    m_pages.clear();
+
+    const char* it  = text.data();
+    const char* end = text.data() + text.size();
+
+    int    penX     = x;
+    int    penY     = y;
+    Uint16 previous = 0;
+
+    while (it != end)
+    {
+      const Uint16 codepoint = nextCodepoint(it, end);
+
+      if (codepoint == '\n')
+      {
+	penX     = x;
+	penY    += lineSkip;
+	previous = 0;
+	continue;
+      }
+
+      if (previous != 0)
+	penX += getKerning(font, previous, codepoint);
+
+      m_sprites.emplace_back();
+      m_pages.push_back(this->place(font, codepoint, penX, penY, color, m_sprites.back()));
+
+      penX    += this->getGlyph(font, codepoint).advance;
+      previous = codepoint;
+    }
+
+    return this->drawGlyphs(m_sprites.data(), m_pages.data(), m_sprites.size());
+  }
+
+  FontAtlas& FontAtlas::drawText(TTF_Font* font,
+				 const TextLayout::Layout& layout,
+				 int x, int y,
+				 const Color& color)
+  {
+    m_sprites.resize(layout.glyphs.size());
+    m_pages.resize(layout.glyphs.size());
+
+    for (std::size_t i = 0; i < layout.glyphs.size(); ++i)
+    {
+      const TextLayout::Glyph& glyph = layout.glyphs[i];
+
+      m_pages[i] = this->place(font, glyph.codepoint, x + glyph.x, y + glyph.y, color, m_sprites[i]);
+    }
+
+    return this->drawGlyphs(m_sprites.data(), m_pages.data(), m_sprites.size());
+  }
+
+  FontAtlas& FontAtlas::drawGlyphs(const Sprite* sprites, const Uint32* pages, std::size_t count)
+  {
+    if (count == 0)
+      return *this;
+
+    // Glyphs usually share a page, skip the sort by page in that case
+    const bool onePage = std::all_of(pages, pages + count,
+				     [pages](Uint32 page) { return page == pages[0]; });
+
+    if (onePage)
+    {
+      m_renderer.drawSprites(m_atlas.getPage(pages[0]), sprites, count);
+      return *this;
+    }
+
+    m_batches.resize(m_atlas.getPageCount());
+
+    for (std::vector<Sprite>& batch : m_batches)
+      batch.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+      m_batches[pages[i]].push_back(sprites[i]);
+
+    for (std::size_t page = 0; page < m_batches.size(); ++page)
+      m_renderer.drawSprites(m_atlas.getPage(page), m_batches[page]);
+
+    return *this;
+  }
+
+  const FontAtlas::Glyph& FontAtlas::getGlyph(TTF_Font* font, Uint16 codepoint)
+  {
+    const Uint64 id = this->key(font, codepoint);
+
+    auto found = m_glyphs.find(id);
+
+    if (found != m_glyphs.end())
+      return found->second;
+
+    int minx, maxx, miny, maxy, advance;
+
+    if (TTF_GlyphMetrics(font, codepoint, &minx, &maxx, &miny, &maxy, &advance) != 0)
+      throw Error(TTF_GetError());
+
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, codepoint, SDL_Color {0xFF, 0xFF, 0xFF, 0xFF});
+
+    if (rendered == nullptr)
+      throw Error(TTF_GetError());
+
+    Surface surface(rendered);
+
+    // The image starts at the pen, or left of it for overhanging glyphs
+    const Glyph glyph {m_atlas.insert(surface), std::min(minx, 0), advance};
+
+    return m_glyphs.emplace(id, glyph).first->second;
+  }
+
+  Uint32 FontAtlas::place(TTF_Font* font, Uint16 codepoint, int x, int y,
+			  const Color& color, Sprite& sprite)
+  {
+    const Glyph&      glyph  = this->getGlyph(font, codepoint);
+    const AtlasRegion region = m_atlas.get(glyph.handle);
+
+    sprite.src      = region.src;
+    sprite.dst      = Rect(x + glyph.offset, y, region.src.getWidth(), region.src.getHeight());
+    sprite.colorMod = color;
+    sprite.angle    = 0;
+    sprite.flip     = Flip::Null;
+
+    // Pages are indexed in insertion order
+    for (Uint32 page = 0; page < m_atlas.getPageCount(); ++page)
+      if (&m_atlas.getPage(page) == region.page)
+	return page;
+
+    return 0;
+  }
+
+  TextureAtlas& FontAtlas::getAtlas()
+  {
+    return m_atlas;
+  }
+
+  // Private methods of class FontAtlas
+
+  Uint64 FontAtlas::key(TTF_Font* font, Uint16 codepoint)
+  {
+    auto found = std::find(m_fonts.begin(), m_fonts.end(), font);
+
+    if (found == m_fonts.end())
+      found = m_fonts.insert(m_fonts.end(), font);
+
+    const Uint64 index = found - m_fonts.begin();
+    const Uint64 style = static_cast<Uint32>(TTF_GetFontStyle(font));
+
+    return index << 48 | style << 16 | codepoint;
+  }
+
+}
+
+#endif // _SDL_TTF_H
@@ -0,0 +1,386 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "FrameRecorder.hpp"
+#include "Renderer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+  // BT.601 studio range, 8 bits of fixed point precision
+
+  inline Uint8 lumaOf(int r, int g, int b)
+  {
+    return ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+  }
+
+  inline Uint8 blueDiffOf(int r, int g, int b)
+  {
+    return ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+  }
+
+  inline Uint8 redDiffOf(int r, int g, int b)
+  {
+    return ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+  }
+
+  // Rounded like _mm_avg_epu8
+  inline int average(int a, int b)
+  {
+    return (a + b + 1) >> 1;
+  }
+
+#ifdef __SSE2__
+  // Weighted sum of the B, G, R channels of 4 ARGB8888 pixels, as 32 bits
+  inline __m128i dot4(__m128i pixels, __m128i weights)
+  {
+    const __m128i zero = _mm_setzero_si128();
+
+    const __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights));
+    const __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights));
+
+    return _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+			 _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+  }
+#endif
+
+  void lumaRow(const Uint32* src, int width, Uint8* dst)
+  {
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i weights = _mm_setr_epi16(25, 129, 66, 0, 25, 129, 66, 0);
+    const __m128i round   = _mm_set1_epi32(128);
+    const __m128i offset  = _mm_set1_epi16(16);
+
+    for (; x + 8 <= width; x += 8)
+    {
+      const __m128i p0 = _mm_loadu_si128((const __m128i*)(src + x));
+      const __m128i p1 = _mm_loadu_si128((const __m128i*)(src + x + 4));
+
+      const __m128i y0 = _mm_srai_epi32(_mm_add_epi32(dot4(p0, weights), round), 8);
+      const __m128i y1 = _mm_srai_epi32(_mm_add_epi32(dot4(p1, weights), round), 8);
+
+      const __m128i y  = _mm_add_epi16(_mm_packs_epi32(y0, y1), offset);
+
+      _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(y, y));
+    }
+#endif
+
+    for (; x < width; ++x)
+      dst[x] = lumaOf((src[x] >> 16) & 0xFF, (src[x] >> 8) & 0xFF, src[x] & 0xFF);
+  }
+
+  // Each chroma sample averages a 2x2 block, rows first then columns
+  void chromaRow(const Uint32* row0, const Uint32* row1, int width, Uint8* u, Uint8* v)
+  {
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i weightsU = _mm_setr_epi16(112, -74, -38, 0, 112, -74, -38, 0);
+    const __m128i weightsV = _mm_setr_epi16(-18, -94, 112, 0, -18, -94, 112, 0);
+    const __m128i round    = _mm_set1_epi32(128);
+    const __m128i offset   = _mm_set1_epi16(128);
+
+    for (; x + 8 <= width; x += 8)
+    {
+      const __m128i a = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(row0 + x)),
+				     _mm_loadu_si128((const __m128i*)(row1 + x)));
+      const __m128i b = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(row0 + x + 4)),
+				     _mm_loadu_si128((const __m128i*)(row1 + x + 4)));
+
+      const __m128 fa = _mm_castsi128_ps(a);
+      const __m128 fb = _mm_castsi128_ps(b);
+
+      const __m128i p = _mm_avg_epu8(_mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0))),
+				     _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1))));
+
+      const __m128i cb = _mm_srai_epi32(_mm_add_epi32(dot4(p, weightsU), round), 8);
+      const __m128i cr = _mm_srai_epi32(_mm_add_epi32(dot4(p, weightsV), round), 8);
+
+      const __m128i c  = _mm_add_epi16(_mm_packs_epi32(cb, cr), offset);
+      const __m128i uv = _mm_packus_epi16(c, c);
+
+      const Uint32 u4 = _mm_cvtsi128_si32(uv);
+      const Uint32 v4 = _mm_cvtsi128_si32(_mm_srli_si128(uv, 4));
+
+      std::memcpy(u + x / 2, &u4, 4);
+      std::memcpy(v + x / 2, &v4, 4);
+    }
+#endif
+
+    for (; x < width; x += 2)
+    {
+      const Uint32 p0 = row0[x];
+      const Uint32 p1 = row1[x];
+      const Uint32 p2 = row0[x + 1 < width ? x + 1 : x];
+      const Uint32 p3 = row1[x + 1 < width ? x + 1 : x];
+
+      int rgb[3];
+
+      for (int c = 0; c < 3; ++c)
+      {
+	const int shift = 16 - 8 * c;
+
+	rgb[c] = average(average((p0 >> shift) & 0xFF, (p1 >> shift) & 0xFF),
+			 average((p2 >> shift) & 0xFF, (p3 >> shift) & 0xFF));
+      }
+
+      u[x / 2] = blueDiffOf(rgb[0], rgb[1], rgb[2]);
+      v[x / 2] = redDiffOf(rgb[0], rgb[1], rgb[2]);
+    }
+  }
+
+}
+
+namespace SO
+{
+
+  // Public methods of class FrameRecorder
+
+  /* Constructor/destructor */
+
+  FrameRecorder::FrameRecorder(Renderer& renderer,
+			       const std::string& path,
+			       int width,
+			       int height,
+			       int fps,
+			       int interval,
+			       std::size_t buffers,
+			       DropPolicy policy)
+    : m_renderer(renderer),
+      m_file(nullptr),
+      m_width(width),
+      m_height(height),
+      m_interval(interval > 0 ? interval : 1),
+      m_policy(policy),
+      m_frame(0),
+      m_buffers(buffers > 0 ? buffers : 1),
+      m_captured(0),
+      m_dropped(0),
+      m_written(0),
+      m_failed(false),
+      m_stop(false)
+  {
+    m_file = SDL_RWFromFile(path.c_str(), "wb");
+
+    if (m_file == nullptr)
+      throw Error(SDL_GetError());
+
+    char header[64];
+    const int length = std::snprintf(header, sizeof(header),
+				     "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+				     width, height, fps);
+
+    if (SDL_RWwrite(m_file, header, length, 1) != 1)
+    {
+      SDL_RWclose(m_file);
+      throw Error(SDL_GetError());
+    }
+
+    // Everything is allocated up front, recording doesn't allocate
+    for (std::vector<Uint8>& buffer : m_buffers)
+    {
+      buffer.resize(static_cast<std::size_t>(width) * height * 4);
+      m_free.push_back(&buffer);
+    }
+
+    m_writer = std::thread(&FrameRecorder::run, this);
+  }
+
+  FrameRecorder::~FrameRecorder()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_filled.notify_one();
+    m_writer.join();
+
+    SDL_RWclose(m_file);
+  }
+
+  /* Methods */
+
+  FrameRecorder& FrameRecorder::capture()
+  {
+    if (m_frame++ % m_interval != 0)
+      return *this;
+
+    std::vector<Uint8>* buffer = nullptr;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      if (m_failed)
+	throw Error("FrameRecorder: writing the file failed");
+
+      if (m_free.empty())
+      {
+	if (m_policy == DropPolicy::Newest)
+	{
+	  ++m_dropped;
+	  return *this;
+	}
+
+	if (m_policy == DropPolicy::Oldest && !m_queue.empty())
+	{
+	  m_free.push_back(m_queue.front());
+	  m_queue.pop_front();
+	  ++m_dropped;
+	}
+
+	// The writer holds the only buffer left
+	m_released.wait(lock, [this] { return !m_free.empty(); });
+      }
+
+      buffer = m_free.back();
+      m_free.pop_back();
+    }
+
+    m_renderer.flush();
+
+    const Rect area(0, 0, m_width, m_height);
+
+    if (SDL_RenderReadPixels(m_renderer.toSDL(),
+			     (const SDL_Rect*)&area,
+			     SDL_PIXELFORMAT_ARGB8888,
+			     buffer->data(),
+			     m_width * 4) != 0)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_free.push_back(buffer);
+      throw Error(SDL_GetError());
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push_back(buffer);
+      ++m_captured;
+    }
+
+    m_filled.notify_one();
+
+    return *this;
+  }
+
+  Uint32 FrameRecorder::getCaptured() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_captured;
+  }
+
+  Uint32 FrameRecorder::getDropped() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_dropped;
+  }
+
+  Uint32 FrameRecorder::getWritten() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_written;
+  }
+
+  void FrameRecorder::toI420(const void* pixels, int pitch,
+			     int width, int height,
+			     Uint8* y, Uint8* u, Uint8* v)
+  {
+    const int chromaWidth = (width + 1) / 2;
+
+    for (int row = 0; row < height; row += 2)
+    {
+      const Uint32* row0 = (const Uint32*)((const Uint8*)pixels + row * pitch);
+      const Uint32* row1 = row + 1 < height ? (const Uint32*)((const Uint8*)row0 + pitch) : row0;
+
+      lumaRow(row0, width, y + row * width);
+
+      if (row1 != row0)
+	lumaRow(row1, width, y + (row + 1) * width);
+
+      chromaRow(row0, row1, width,
+		u + (row / 2) * chromaWidth,
+		v + (row / 2) * chromaWidth);
+    }
+  }
+
+  // Private methods of class FrameRecorder
+
+  void FrameRecorder::run()
+  {
+    const std::size_t lumaSize   = static_cast<std::size_t>(m_width) * m_height;
+    const std::size_t chromaSize = static_cast<std::size_t>((m_width + 1) / 2) * ((m_height + 1) / 2);
+
+    std::vector<Uint8> frame(lumaSize + 2 * chromaSize);
+
+    for (;;)
+    {
+      std::vector<Uint8>* buffer = nullptr;
+
+      {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_filled.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+
+	if (m_queue.empty())
+	  return;
+
+	buffer = m_queue.front();
+	m_queue.pop_front();
+      }
+
+      FrameRecorder::toI420(buffer->data(), m_width * 4, m_width, m_height,
+			    frame.data(),
+			    frame.data() + lumaSize,
+			    frame.data() + lumaSize + chromaSize);
+
+      const bool written =
+	SDL_RWwrite(m_file, "FRAME\n", 6, 1) == 1 &&
+	SDL_RWwrite(m_file, frame.data(), frame.size(), 1) == 1;
+
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_free.push_back(buffer);
+
+	if (written)
+	  ++m_written;
+	else
+	  m_failed = true;
+      }
+
+      m_released.notify_all();
+    }
+  }
+
+}
@@ -0,0 +1,161 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "MappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define SO_MMAP
+#endif
+
+namespace SO
+{
+
+  // Public methods of class MappedFile
+
+  /* Constructor/destructor */
+
+  MappedFile::MappedFile()
+    : m_data(nullptr),
+      m_size(0)
+  {
+
+  }
+
+  MappedFile::MappedFile(const char* path)
+    : m_data(nullptr),
+      m_size(0)
+  {
+#ifdef SO_MMAP
+    const int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+      throw Error(std::strerror(errno));
+
+    struct stat info;
+
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+      void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (mapped != MAP_FAILED)
+      {
+	m_data = static_cast<const Uint8*>(mapped);
+	m_size = info.st_size;
+      }
+    }
+
+    close(fd);
+
+    if (m_data == nullptr)
+      throw Error("MappedFile: mapping the file failed");
+#else
+    SDL_RWops* file = SDL_RWFromFile(path, "rb");
+
+    if (file == nullptr)
+      throw Error(SDL_GetError());
+
+    const Sint64 size = SDL_RWsize(file);
+
+    if (size > 0)
+    {
+      m_buffer.resize(size);
+
+      if (SDL_RWread(file, m_buffer.data(), 1, size) != static_cast<size_t>(size))
+	m_buffer.clear();
+    }
+
+    SDL_RWclose(file);
+
+    if (m_buffer.empty())
+      throw Error("MappedFile: reading the file failed");
+
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+  }
+
+  MappedFile::MappedFile(MappedFile&& orig) noexcept
+    : m_data(orig.m_data),
+      m_size(orig.m_size),
+      m_buffer(std::move(orig.m_buffer))
+  {
+    orig.m_data = nullptr;
+    orig.m_size = 0;
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& orig) noexcept
+  {
+    if (this != &orig)
+    {
+      this->unmap();
+
+      m_data   = orig.m_data;
+      m_size   = orig.m_size;
+      m_buffer = std::move(orig.m_buffer);
+
+      orig.m_data = nullptr;
+      orig.m_size = 0;
+    }
+
+    return *this;
+  }
+
+  MappedFile::~MappedFile()
+  {
+    this->unmap();
+  }
+
+  /* Methods */
+
+  const Uint8* MappedFile::getData() const
+  {
+    return m_data;
+  }
+
+  std::size_t MappedFile::getSize() const
+  {
+    return m_size;
+  }
+
+  // Private methods of class MappedFile
+
+  void MappedFile::unmap()
+  {
+#ifdef SO_MMAP
+    if (m_data != nullptr)
+      munmap(const_cast<Uint8*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+  }
+
+}
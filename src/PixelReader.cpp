@@ -0,0 +1,232 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "PixelReader.hpp"
+#include "Renderer.hpp"
+
+#include <cstring>
+
+namespace SO
+{
+
+  // Public methods of class PixelReader
+
+  /* Constructor/destructor */
+
+  PixelReader::PixelReader(Renderer& renderer,
+			   std::size_t buffers,
+			   int width,
+			   int height)
+    : m_renderer(renderer),
+      m_slots(buffers > 0 ? buffers : 1),
+      m_next(0),
+      m_busy(0),
+      m_stop(false)
+  {
+    // 4 bytes covers every packed format a target can have
+    for (Slot& slot : m_slots)
+      slot.raw.reserve(static_cast<std::size_t>(width) * height * 4);
+
+    m_worker = std::thread(&PixelReader::run, this);
+  }
+
+  PixelReader::~PixelReader()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_filled.notify_one();
+    m_worker.join();
+  }
+
+  /* Methods */
+
+  std::future<PixelReader::Frame> PixelReader::read(const Rect& rect, PixelFormats format)
+  {
+    Slot& slot = this->acquire();
+
+    slot.promise  = std::promise<Frame>();
+    slot.callback = nullptr;
+
+    std::future<Frame> future = slot.promise.get_future();
+
+    this->copy(rect, format);
+
+    return future;
+  }
+
+  PixelReader& PixelReader::read(const Rect& rect, PixelFormats format, Callback callback)
+  {
+    Slot& slot = this->acquire();
+
+    slot.callback = std::move(callback);
+
+    this->copy(rect, format);
+
+    return *this;
+  }
+
+  PixelReader& PixelReader::wait()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_released.wait(lock, [this] { return m_busy == 0; });
+
+    return *this;
+  }
+
+  std::size_t PixelReader::getPending() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_busy;
+  }
+
+  // Private methods of class PixelReader
+
+  PixelReader::Slot& PixelReader::acquire()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Slots are delivered in order, so the next one is free as soon as
+    // the ring isn't full
+    m_released.wait(lock, [this] { return m_busy < m_slots.size(); });
+
+    return m_slots[m_next];
+  }
+
+  void PixelReader::copy(const Rect& rect, PixelFormats format)
+  {
+    Slot&         slot     = m_slots[m_next];
+    SDL_Renderer* renderer = m_renderer.toSDL();
+    SDL_Texture*  target   = SDL_GetRenderTarget(renderer);
+
+    // Read in the format of the target, so SDL doesn't convert
+    Uint32 rawFormat = SDL_PIXELFORMAT_UNKNOWN;
+
+    if (target != nullptr)
+    {
+      if (SDL_QueryTexture(target, &rawFormat, nullptr, nullptr, nullptr) != 0)
+	throw Error(SDL_GetError());
+    }
+    else
+    {
+      SDL_RendererInfo info;
+
+      if (SDL_GetRendererInfo(renderer, &info) != 0)
+	throw Error(SDL_GetError());
+
+      rawFormat = info.num_texture_formats > 0 ?
+	info.texture_formats[0] : SDL_PIXELFORMAT_ARGB8888;
+    }
+
+    slot.width     = rect.getWidth();
+    slot.height    = rect.getHeight();
+    slot.pitch     = slot.width * SDL_BYTESPERPIXEL(rawFormat);
+    slot.rawFormat = rawFormat;
+    slot.format    = format;
+
+    // Only grows, the ring is reused frame after frame
+    const std::size_t size = static_cast<std::size_t>(slot.pitch) * slot.height;
+
+    if (slot.raw.size() < size)
+      slot.raw.resize(size);
+
+    m_renderer.flush();
+
+    if (SDL_RenderReadPixels(renderer,
+			     (const SDL_Rect*)&rect,
+			     rawFormat,
+			     slot.raw.data(),
+			     slot.pitch) != 0)
+      throw Error(SDL_GetError());
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_queue.push_back(&slot);
+      ++m_busy;
+      m_next = (m_next + 1) % m_slots.size();
+    }
+
+    m_filled.notify_one();
+  }
+
+  void PixelReader::run()
+  {
+    for (;;)
+    {
+      Slot* slot = nullptr;
+
+      {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_filled.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+
+	if (m_queue.empty())
+	  return;
+
+	slot = m_queue.front();
+	m_queue.pop_front();
+      }
+
+      Frame frame;
+
+      frame.width  = slot->width;
+      frame.height = slot->height;
+      frame.format = slot->format;
+      frame.pitch  = slot->width * SDL_BYTESPERPIXEL((Uint32)slot->format);
+      frame.pixels.resize(static_cast<std::size_t>(frame.pitch) * frame.height);
+
+      bool converted = true;
+
+      if (slot->format == static_cast<PixelFormats>(slot->rawFormat))
+	std::memcpy(frame.pixels.data(), slot->raw.data(), frame.pixels.size());
+      else
+	converted = SDL_ConvertPixels(slot->width, slot->height,
+				      slot->rawFormat,
+				      slot->raw.data(), slot->pitch,
+				      (Uint32)slot->format,
+				      frame.pixels.data(), frame.pitch) == 0;
+
+      if (slot->callback)
+      {
+	if (converted)
+	  slot->callback(frame);
+      }
+      else if (converted)
+	slot->promise.set_value(std::move(frame));
+      else
+	slot->promise.set_exception(std::make_exception_ptr(Error(SDL_GetError())));
+
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	--m_busy;
+      }
+
+      m_released.notify_all();
+    }
+  }
+
+}
@@ -0,0 +1,190 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "RenderTargetPool.hpp"
+#include "Renderer.hpp"
+
+namespace SO
+{
+
+  // Public methods of class RenderTargetPool::Lease
+
+  RenderTargetPool::Lease::Lease(RenderTargetPool* pool,
+				 const Key& key,
+				 std::unique_ptr<Texture> texture)
+    : m_pool(pool),
+      m_key(key),
+      m_texture(std::move(texture))
+  {
+
+  }
+
+  RenderTargetPool::Lease::Lease(Lease&& orig)
+    : m_pool(orig.m_pool),
+      m_key(orig.m_key),
+      m_texture(std::move(orig.m_texture))
+  {
+    orig.m_pool = nullptr;
+  }
+
+  RenderTargetPool::Lease& RenderTargetPool::Lease::operator=(Lease&& orig)
+  {
+    if (this != &orig)
+    {
+      this->release();
+
+      m_pool    = orig.m_pool;
+      m_key     = orig.m_key;
+      m_texture = std::move(orig.m_texture);
+
+      orig.m_pool = nullptr;
+    }
+
+    return *this;
+  }
+
+  RenderTargetPool::Lease::~Lease()
+  {
+    this->release();
+  }
+
+  void RenderTargetPool::Lease::release()
+  {
+    if (m_pool != nullptr && m_texture != nullptr)
+      m_pool->giveBack(m_key, std::move(m_texture));
+
+    m_pool = nullptr;
+  }
+
+  // Public methods of class RenderTargetPool
+
+  /* Constructor/destructor */
+
+  RenderTargetPool::RenderTargetPool(Renderer& renderer, Uint32 idleTimeout)
+    : m_renderer(renderer),
+      m_idleTimeout(idleTimeout),
+      m_idleCount(0),
+      m_leased(0)
+  {
+    m_budgetCallback = TextureMemory::addBudgetCallback([this](std::size_t)
+      {
+	this->clear();
+      });
+  }
+
+  RenderTargetPool::~RenderTargetPool()
+  {
+    TextureMemory::removeBudgetCallback(m_budgetCallback);
+  }
+
+  /* Methods */
+
+  RenderTargetPool::Lease RenderTargetPool::acquire(int width, int height, PixelFormats format)
+  {
+    this->trim();
+
+    const Key key(width, height, format);
+
+    std::unique_ptr<Texture> texture;
+
+    auto found = m_idle.find(key);
+
+    if (found != m_idle.end() && !found->second.empty())
+    {
+      // Most recently returned first, it's the likeliest to be warm
+      texture = std::move(found->second.back().texture);
+      found->second.pop_back();
+      --m_idleCount;
+    }
+    else
+      texture.reset(new Texture(m_renderer, width, height, TextureAccess::Target, format));
+
+    ++m_leased;
+
+    return Lease(this, key, std::move(texture));
+  }
+
+  RenderTargetPool& RenderTargetPool::trim()
+  {
+    if (m_idleCount == 0)
+      return *this;
+
+    const Uint32 now = SDL_GetTicks();
+
+    for (auto it = m_idle.begin(); it != m_idle.end();)
+    {
+      std::vector<Idle>& idle = it->second;
+
+      // Oldest first, as they are pushed when returned
+      std::size_t expired = 0;
+
+      while (expired < idle.size() && now - idle[expired].since >= m_idleTimeout)
+	++expired;
+
+      idle.erase(idle.begin(), idle.begin() + expired);
+      m_idleCount -= expired;
+
+      if (idle.empty())
+	it = m_idle.erase(it);
+      else
+	++it;
+    }
+
+    return *this;
+  }
+
+  RenderTargetPool& RenderTargetPool::clear()
+  {
+    m_idle.clear();
+    m_idleCount = 0;
+
+    return *this;
+  }
+
+  std::size_t RenderTargetPool::getIdle() const
+  {
+    return m_idleCount;
+  }
+
+  std::size_t RenderTargetPool::getLeased() const
+  {
+    return m_leased;
+  }
+
+  RenderTargetPool& RenderTargetPool::setIdleTimeout(Uint32 idleTimeout)
+  {
+    m_idleTimeout = idleTimeout;
+
+    return *this;
+  }
+
+  // Private methods of class RenderTargetPool
+
+  void RenderTargetPool::giveBack(const Key& key, std::unique_ptr<Texture> texture)
+  {
+    m_idle[key].push_back({std::move(texture), SDL_GetTicks()});
+
+    ++m_idleCount;
+    --m_leased;
+  }
+
+}
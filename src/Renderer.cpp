@@ -29,22 +29,278 @@
 
 #include "Renderer.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+// Statistics are compiled out when building with -DSO_NO_RENDERER_STATS
+#ifndef SO_NO_RENDERER_STATS
+#define SO_STAT(expr) (expr)
+#else
+#define SO_STAT(expr) ((void)0)
+#endif
+
+namespace
+{
+  // Stand-in for a NULL rect in the deferred payload buffers.
+  const SDL_Rect NullRect {0, 0, -1, -1};
+
+  inline const SDL_Rect* orNull(const SDL_Rect& rect)
+  {
+    return rect.w < 0 ? nullptr : &rect;
+  }
+
+  inline bool sameColor(const SDL_Color& a, const SDL_Color& b)
+  {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+  }
+
+  inline SDL_Color toSDLColor(const SO::Color& color)
+  {
+    return {color.getRed(), color.getGreen(), color.getBlue(), color.getAlpha()};
+  }
+
+  // Every live renderer, told by SO::Renderer::release when a texture
+  // goes away. Renderers and textures belong to the rendering thread.
+  std::vector<SO::Renderer*>& liveRenderers()
+  {
+    static std::vector<SO::Renderer*> renderers;
+
+    return renderers;
+  }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  // Append the textured quad of a sprite, rotated around the center of
+  // its destination.
+  void appendQuad(const SO::Sprite& sprite,
+		  float textureWidth,
+		  float textureHeight,
+		  std::vector<SDL_Vertex>& vertices,
+		  std::vector<int>& indices)
+  {
+    const SO::Rect& src = sprite.src;
+    const SO::Rect& dst = sprite.dst;
+
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+
+    if (src.getWidth() != 0 && src.getHeight() != 0)
+    {
+      u0 = src.getX() / textureWidth;
+      v0 = src.getY() / textureHeight;
+      u1 = (src.getX() + src.getWidth()) / textureWidth;
+      v1 = (src.getY() + src.getHeight()) / textureHeight;
+    }
+
+    if ((sprite.flip & SO::Flip::Horizontal) == SO::Flip::Horizontal)
+      std::swap(u0, u1);
+
+    if ((sprite.flip & SO::Flip::Vertical) == SO::Flip::Vertical)
+      std::swap(v0, v1);
+
+    const float halfW = dst.getWidth() / 2.0f;
+    const float halfH = dst.getHeight() / 2.0f;
+    const float cx    = dst.getX() + halfW;
+    const float cy    = dst.getY() + halfH;
+
+    float c = 1.0f, s = 0.0f;
+
+    if (sprite.angle != 0)
+    {
+      const double rad = sprite.angle * M_PI / 180.0;
+      c = static_cast<float>(std::cos(rad));
+      s = static_cast<float>(std::sin(rad));
+    }
+
+    const SDL_Color color {sprite.colorMod.getRed(),
+			   sprite.colorMod.getGreen(),
+			   sprite.colorMod.getBlue(),
+			   sprite.colorMod.getAlpha()};
+
+    const float corners[4][4] = {{-halfW, -halfH, u0, v0},
+				 { halfW, -halfH, u1, v0},
+				 { halfW,  halfH, u1, v1},
+				 {-halfW,  halfH, u0, v1}};
+
+    const int base = vertices.size();
+
+    for (const auto& corner : corners)
+      vertices.push_back({{cx + corner[0]*c - corner[1]*s,
+			   cy + corner[0]*s + corner[1]*c},
+			  color,
+			  {corner[2], corner[3]}});
+
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+
+    for (int i : quad)
+      indices.push_back(base + i);
+  }
+#endif
+
+  // Midpoint circle
+  // see : https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+  void rasterCircle(int x0, int y0, int r, std::vector<SDL_Point>& points)
+  {
+    int x = r - 1;
+    int y = 0;
+    int dx = 1;
+    int dy = 1;
+    int e = dx - (r << 1);
+
+    while (x >= y)
+    {
+      points.push_back({x0 + x, y0 + y});
+      points.push_back({x0 - x, y0 + y});
+      points.push_back({x0 + y, y0 + x});
+      points.push_back({x0 - y, y0 + x});
+      points.push_back({x0 - x, y0 - y});
+      points.push_back({x0 + x, y0 - y});
+      points.push_back({x0 - y, y0 - x});
+      points.push_back({x0 + y, y0 - x});
+
+      if (e <= 0)
+      {
+	y++;
+	e += dy;
+	dy += 2;
+      }
+
+      if (e > 0)
+      {
+	x--;
+	dx += 2;
+	e += (-r << 1) + dx;
+      }
+    }
+  }
+
+  // Same walk as rasterCircle, but only the widest half span of each row
+  // is kept so the disc is covered by exactly one rect per row.
+  void rasterDisc(int x0, int y0, int r,
+		  std::vector<int>& spans,
+		  std::vector<SDL_Rect>& rects)
+  {
+    if (r <= 0)
+      return;
+
+    spans.assign(r, -1);
+
+    int x  = r - 1;
+    int y  = 0;
+    int dx = 1;
+    int dy = 1;
+    int e  = dx - (r << 1);
+
+    while (x >= y)
+    {
+      spans[y] = std::max(spans[y], x);
+      spans[x] = std::max(spans[x], y);
+
+      if (e <= 0)
+      {
+	y++;
+	e += dy;
+	dy += 2;
+      }
+
+      if (e > 0)
+      {
+	x--;
+	dx += 2;
+	e += (-r << 1) + dx;
+      }
+    }
+
+    for (int row = 0; row < r; ++row)
+    {
+      const int half = spans[row];
+
+      if (half < 0)
+	continue;
+
+      rects.push_back({x0 - half, y0 + row, 2*half + 1, 1});
+
+      if (row != 0)
+	rects.push_back({x0 - half, y0 - row, 2*half + 1, 1});
+    }
+  }
+
+  // Bounds of dst rotated by angle degrees around center (relative to dst)
+  SDL_Rect rotatedBounds(const SDL_Rect& dst, double angle, const SDL_Point* center)
+  {
+    if (angle == 0)
+      return dst;
+
+    const double cx = dst.x + (center != nullptr ? center->x : dst.w / 2.0);
+    const double cy = dst.y + (center != nullptr ? center->y : dst.h / 2.0);
+
+    // Farthest corner from the center, any rotation stays within it
+    const double dx = std::max(cx - dst.x, dst.x + dst.w - cx);
+    const double dy = std::max(cy - dst.y, dst.y + dst.h - cy);
+    const double r  = std::sqrt(dx * dx + dy * dy);
+
+    const int x0 = static_cast<int>(std::floor(cx - r));
+    const int y0 = static_cast<int>(std::floor(cy - r));
+
+    return {x0, y0,
+	    static_cast<int>(std::ceil(cx + r)) - x0,
+	    static_cast<int>(std::ceil(cy + r)) - y0};
+  }
+
+}
+
 namespace SO
 {
 
   // constructors/destructor
 
   Renderer::Renderer(Window& window, Uint32 flags, int index)
-    : m_renderer(nullptr)
+    : m_renderer(nullptr),
+      m_deferred(false),
+      m_drawColor(),
+      m_drawBlendMode(SDL_BLENDMODE_NONE),
+      m_appliedColor {0, 0, 0, 0},
+      m_appliedBlendMode(SDL_BLENDMODE_NONE),
+      m_clipEnabled(false),
+      m_scale(1.0f, 1.0f),
+      m_target(nullptr),
+      m_targetSupported(false),
+      m_damageTracking(false),
+      m_backBuffer(nullptr),
+      m_boundTexture(nullptr)
   {
     m_renderer = SDL_CreateRenderer(window.toSDL(), index, flags);
 
-    if (m_renderer == nullptr)
-      throw Error(SDL_GetError());
+    this->init();
+  }
+
+  Renderer::Renderer(Surface& surface)
+    : m_renderer(nullptr),
+      m_deferred(false),
+      m_drawColor(),
+      m_drawBlendMode(SDL_BLENDMODE_NONE),
+      m_appliedColor {0, 0, 0, 0},
+      m_appliedBlendMode(SDL_BLENDMODE_NONE),
+      m_clipEnabled(false),
+      m_scale(1.0f, 1.0f),
+      m_target(nullptr),
+      m_targetSupported(false),
+      m_damageTracking(false),
+      m_backBuffer(nullptr),
+      m_boundTexture(nullptr)
+  {
+    m_renderer = SDL_CreateSoftwareRenderer(surface.toSDL());
+
+    this->init();
   }
 
   Renderer::~Renderer()
   {
+    std::vector<Renderer*>& renderers = liveRenderers();
+
+    renderers.erase(std::remove(renderers.begin(), renderers.end(), this), renderers.end());
+
+    if (m_backBuffer != nullptr)
+      SDL_DestroyTexture(m_backBuffer);
+
     if (m_renderer != nullptr)
       SDL_DestroyRenderer(m_renderer);
 
@@ -56,31 +312,17 @@ namespace SO
 
   Rect Renderer::getClipRect() const
   {
-    SDL_Rect rect;
-
-    SDL_RenderGetClipRect(m_renderer, &rect);
-
-    return rect;
+    return m_clipRect;
   }
 
   BlendModes Renderer::getDrawBlendMode() const
   {
-    SDL_BlendMode blendMode;
-
-    if (SDL_GetRenderDrawBlendMode(m_renderer, &blendMode) == 0)
-      throw Error(SDL_GetError());
-    
-    return static_cast<BlendModes>(blendMode);
+    return static_cast<BlendModes>(m_drawBlendMode);
   }
 
   Color Renderer::getDrawColor() const
   {
-    Uint8 r, g, b, a;
-
-    if (SDL_GetRenderDrawColor(m_renderer, &r, &g, &b, &a) != 0)
-      throw Error(SDL_GetError());
-
-    return {r, g, b, a};
+    return m_drawColor;
   }
 
   bool Renderer::getInfo(SDL_RendererInfo& info) const
@@ -117,34 +359,32 @@ namespace SO
 
   Pair<float> Renderer::getScale() const
   {
-    float x, y;
-
-    SDL_RenderGetScale(m_renderer, &x, &y);
-
-    return {x , y};
+    return m_scale;
   }
 #endif
 
+  Uint32 Renderer::getStateChanges() const
+  {
+    return m_stats.stateChanges;
+  }
+
   SDL_Texture* Renderer::getTarget() const
   {
-    return SDL_GetRenderTarget(m_renderer);
+    // The back buffer stands for the default target
+    return m_damageTracking && m_target == m_backBuffer ? nullptr : m_target;
   }
 
 #if SDL_VERSION_ATLEAST(2, 0, 0)
   Rect Renderer::getViewport() const
   {
-    SDL_Rect rect;
-    
-    SDL_RenderGetViewport(m_renderer, &rect);
-    
-    return {rect};
+    return m_viewport;
   }
 #endif
 
 #if SDL_VERSION_ATLEAST(2, 0, 4)
   bool Renderer::isClipEnabled() const
   {
-    return static_cast<bool>(SDL_RenderIsClipEnabled(m_renderer));
+    return m_clipEnabled;
   }
 #endif
 
@@ -155,23 +395,118 @@ namespace SO
   }
 #endif
 
+  const RendererStats& Renderer::stats() const
+  {
+    return m_frameStats;
+  }
+
+  const DamageTracker& Renderer::getDamage() const
+  {
+    return m_damage;
+  }
+
+  bool Renderer::isDamageTracking() const
+  {
+    return m_damageTracking;
+  }
+
+  bool Renderer::isDeferred() const
+  {
+    return m_deferred;
+  }
+
 // SET METHODS
   
   Renderer& Renderer::setClipRect(const Rect& rect)
   {
+    if (m_clipEnabled && rect == m_clipRect)
+      return *this;
+
+    this->flush();
+
     if (SDL_RenderSetClipRect(m_renderer, (const SDL_Rect*)&rect) != 0)
       throw Error(SDL_GetError());
 
+    SO_STAT(++m_stats.stateChanges);
+    m_clipRect    = rect;
+    m_clipEnabled = true;
+
+    return *this;
+  }
+
+  Renderer& Renderer::setDamageTracking(bool enable)
+  {
+    if (enable == m_damageTracking)
+      return *this;
+
+    this->flush();
+
+    if (enable)
+    {
+      if (!m_targetSupported)
+	throw Error("Render targets are not supported");
+
+      this->createBackBuffer();
+      m_damageTracking = true;
+
+      if (m_target == nullptr && SDL_SetRenderTarget(m_renderer, m_backBuffer) != 0)
+	throw Error(SDL_GetError());
+    }
+    else
+    {
+      if (m_target == m_backBuffer && SDL_SetRenderTarget(m_renderer, nullptr) != 0)
+	throw Error(SDL_GetError());
+
+      std::replace(m_targetStack.begin(), m_targetStack.end(), m_backBuffer, (SDL_Texture*)nullptr);
+
+      SDL_DestroyTexture(m_backBuffer);
+      m_backBuffer     = nullptr;
+      m_damageTracking = false;
+      m_damage.clear();
+    }
+
+    SO_STAT(++m_stats.stateChanges);
+    this->syncState();
+
+    return *this;
+  }
+
+  Renderer& Renderer::setDeferred(bool enable, std::size_t capacity)
+  {
+    if (enable)
+    {
+      m_commands.reserve(capacity);
+      m_points.reserve(capacity);
+      m_rects.reserve(capacity);
+    }
+    else
+    {
+      this->flush();
+    }
+
+    m_deferred = enable;
+
+    return *this;
+  }
+
+  Renderer& Renderer::setDrawBlendMode(BlendModes blendMode)
+  {
+    if (!m_deferred)
+      this->applyDrawState(toSDLColor(m_drawColor),
+			   static_cast<SDL_BlendMode>(blendMode));
+
+    m_drawBlendMode = static_cast<SDL_BlendMode>(blendMode);
+
     return *this;
   }
 
   Renderer& Renderer::setDrawColor(Color color)
   {
-    if (SDL_SetRenderDrawColor(m_renderer,
-                               color.getRed(),
-                               color.getGreen(),
-                               color.getBlue(),
-                               color.getAlpha()) != 0) throw Error(SDL_GetError());
+    if (!m_deferred)
+      this->applyDrawState(toSDLColor(color), m_drawBlendMode);
+
+    m_drawColor = color;
+
     return *this;
   }
 
@@ -179,8 +514,13 @@ namespace SO
 #if SDL_VERSION_ATLEAST(2, 0, 5)
   Renderer& Renderer::setIntegerScale(bool enable)
   {
+    this->flush();
+
     if (SDL_RenderSetIntegerScale(m_renderer, static_cast<SDL_bool>(enable)) != 0)
       throw Error(SDL_GetError());
+
+    SO_STAT(++m_stats.stateChanges);
+    this->syncState();
     
     return *this;
   }
@@ -189,53 +529,117 @@ namespace SO
 #if SDL_VERSION_ATLEAST(2, 0, 0)
   Renderer& Renderer::setLogicalSize(int w, int h)
   {
+    this->flush();
+
     if (SDL_RenderSetLogicalSize(m_renderer, w, h) != 0)
       throw Error(SDL_GetError());
 
+    // SDL recomputes the viewport and the scale from the logical size
+    SO_STAT(++m_stats.stateChanges);
+    this->syncState();
+
     return *this;
   }
 
   Renderer& Renderer::setScale(float scaleX, float scaleY)
   {
+    if (m_scale.first == scaleX && m_scale.second == scaleY)
+      return *this;
+
+    this->flush();
+
     if (SDL_RenderSetScale(m_renderer, scaleX, scaleY) != 0)
       throw Error(SDL_GetError());
 
+    // The viewport and clip rect are reported in scaled coordinates
+    SO_STAT(++m_stats.stateChanges);
+    this->syncState();
+
     return *this;
   }
 
   Renderer& Renderer::setViewport(const Rect& rect)
   {
+    if (rect == m_viewport)
+      return *this;
+
+    this->flush();
+
     if (SDL_RenderSetViewport(m_renderer, (const SDL_Rect*)&rect) != 0)
       throw Error(SDL_GetError());
 
+    SO_STAT(++m_stats.stateChanges);
+    m_viewport = rect;
+
     return *this;
   }
 
   bool Renderer::setTarget(Texture& texture)
   {
-    SDL_RendererInfo info;
-
-    if (this->getInfo(info) == 0)
-    {
-      if (info.flags & Renderer::TargetTexture)
-	if (SDL_SetRenderTarget(m_renderer, texture.toSDL()) != 0)
-	  throw Error(SDL_GetError());
-      return true;
-    }
+    return this->applyTarget(texture.toSDL());
+  }
 
-    return false;
+  bool Renderer::resetTarget()
+  {
+    return this->applyTarget(nullptr);
   }
 #endif
 
 
 // OTHER METHODS
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+  Renderer& Renderer::invalidate(const Rect& rect)
+  {
+    if (m_damageTracking)
+      m_damage.add(rect);
+
+    return *this;
+  }
+
+  Renderer& Renderer::pushTarget(Texture& texture)
+  {
+    if (!m_targetSupported)
+      throw Error("Render targets are not supported");
+
+    // The stack only changes once the target did
+    SDL_Texture* previous = m_target;
+
+    this->applyTarget(texture.toSDL());
+    m_targetStack.push_back(previous);
+
+    return *this;
+  }
+
+  Renderer& Renderer::popTarget()
+  {
+    if (m_targetStack.empty())
+      throw Error("Render target stack is empty");
+
+    this->applyTarget(m_targetStack.back());
+    m_targetStack.pop_back();
+
+    return *this;
+  }
+#endif
+
 #if SDL_VERSION_ATLEAST(2, 0, 0)
   Renderer& Renderer::clear()
   {
+    if (m_damageTracking && m_target == m_backBuffer)
+      m_damage.addAll();
+
+    if (m_deferred)
+    {
+      this->record(Command::Clear, nullptr, 0).count = 1;
+      return *this;
+    }
+
     if (SDL_RenderClear(m_renderer) != 0)
       throw Error(SDL_GetError());
 
+    SO_STAT(m_stats.clearCalls++);
+
     return *this;
   }
 #endif
@@ -244,12 +648,24 @@ namespace SO
 			   const Rect* src,
 			   const Rect* dst)
   {
+    if (m_damageTracking)
+      this->touch(dst != nullptr ? *(const SDL_Rect*)dst : SDL_Rect {0, 0, m_viewport.getWidth(), m_viewport.getHeight()});
+
+    if (m_deferred)
+    {
+      this->record(Command::Copy, texture.toSDL(), m_rects.size()).count++;
+      m_rects.push_back(src != nullptr ? *(const SDL_Rect*)src : NullRect);
+      m_rects.push_back(dst != nullptr ? *(const SDL_Rect*)dst : NullRect);
+      return *this;
+    }
 
     if (SDL_RenderCopy(m_renderer,
 		       texture.toSDL(),
 		       (const SDL_Rect*)src,
 		       (const SDL_Rect*)dst) != 0)
       throw Error(SDL_GetError());
+
+    SO_STAT(this->countCopy(texture.toSDL(), (const SDL_Rect*)dst, 1));
     
     return *this;
   }
@@ -261,6 +677,23 @@ namespace SO
 			     const Point* center,
 			     const Flip flip)
   {
+    if (m_damageTracking)
+      this->touch(rotatedBounds(dst != nullptr ? *(const SDL_Rect*)dst : SDL_Rect {0, 0, m_viewport.getWidth(), m_viewport.getHeight()},
+				angle,
+				(const SDL_Point*)center));
+
+    if (m_deferred)
+    {
+      this->record(Command::CopyEx, texture.toSDL(), m_copiesEx.size()).count++;
+      m_copiesEx.push_back({src != nullptr ? *(const SDL_Rect*)src : NullRect,
+			    dst != nullptr ? *(const SDL_Rect*)dst : NullRect,
+			    angle,
+			    center != nullptr ? *(const SDL_Point*)center : SDL_Point {0, 0},
+			    center != nullptr,
+			    static_cast<SDL_RendererFlip>(flip)});
+      return *this;
+    }
+
     if (SDL_RenderCopyEx(m_renderer,
 			 texture.toSDL(),
 			 (const SDL_Rect*)src,
@@ -269,94 +702,256 @@ namespace SO
 			 (const SDL_Point*)center,
 			 static_cast<SDL_RendererFlip>(flip)) != 0)
       throw Error(SDL_GetError());
+
+    SO_STAT(this->countCopy(texture.toSDL(), (const SDL_Rect*)dst, 1));
     
     return *this;
   }
 
   Renderer& Renderer::present()
   {
-    SDL_RenderPresent(m_renderer); 
-    return *this;
-  }
+#ifndef SO_NO_RENDERER_STATS
+    const Uint64 start = SDL_GetPerformanceCounter();
+#endif
 
-  Renderer& Renderer::drawCircle(int x0, int y0, int r)
-  {
-    // Midpoint circle
-    // see : https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
-    
-    int x = r - 1;
-    int y = 0;
-    int dx = 1;
-    int dy = 1;
-    int e = dx - (r << 1);
+    this->flush();
 
-    while (x >= y)
+    if (!m_damageTracking)
+      SDL_RenderPresent(m_renderer);
+    else if (!m_damage.isEmpty())
     {
-      this->drawPoint(x0 + x, y0 + y);
-      this->drawPoint(x0 - x, y0 + y);
-      this->drawPoint(x0 + y, y0 + x);
-      this->drawPoint(x0 - y, y0 + x);
-      this->drawPoint(x0 - x, y0 - y);
-      this->drawPoint(x0 + x, y0 - y);
-      this->drawPoint(x0 - y, y0 - x);
-      this->drawPoint(x0 + y, y0 - x);
+      // Previous frames aren't kept by the swap chain, the whole back
+      // buffer goes out in a single copy
+      if (SDL_SetRenderTarget(m_renderer, nullptr) != 0 ||
+	  SDL_RenderCopy(m_renderer, m_backBuffer, NULL, NULL) != 0)
+	throw Error(SDL_GetError());
 
-      if (e <= 0)
-      {
-	y++;
-	e += dy;
-	dy += 2;
-      }
+      SDL_RenderPresent(m_renderer);
 
-      if (e > 0)
-      {
-	x--;
-	dx += 2;
-	e += (-r << 1) + dx;
+      if (SDL_SetRenderTarget(m_renderer, m_target) != 0)
+	throw Error(SDL_GetError());
+    }
+
+#ifndef SO_NO_RENDERER_STATS
+    m_stats.presentTime = (SDL_GetPerformanceCounter() - start) * 1000.0
+      / SDL_GetPerformanceFrequency();
+    m_frameStats = m_stats;
+    m_stats      = RendererStats();
+#endif
+
+    if (m_damageTracking)
+    {
+      m_damage.clear();
+
+      // A resized output needs a new back buffer, to be drawn entirely
+      int w, h;
+
+      if (SDL_GetRendererOutputSize(m_renderer, &w, &h) != 0)
+	throw Error(SDL_GetError());
+
+      const Rect bounds = m_damage.getBounds();
+
+      if (w != bounds.getWidth() || h != bounds.getHeight())
+      {
+	SDL_Texture* old = m_backBuffer;
+
+	this->createBackBuffer();
+
+	if (m_target == old && SDL_SetRenderTarget(m_renderer, m_backBuffer) != 0)
+	  throw Error(SDL_GetError());
+
+	std::replace(m_targetStack.begin(), m_targetStack.end(), old, m_backBuffer);
+	SDL_DestroyTexture(old);
       }
     }
 
+    // Resizing the window moves the viewport behind our back
+    this->syncState();
+
+    return *this;
+  }
+
+  Renderer& Renderer::drawCircle(int x0, int y0, int r)
+  {
+    const Pair<Point, int> circle {{x0, y0}, r};
+
+    return this->drawCircles(&circle, 1);
+  }
+
+  Renderer& Renderer::drawCircles(const std::vector<Pair<Point, int>>& circles)
+  {
+    if (circles.empty())
+      return *this;
+
+    return this->drawCircles(&circles[0], circles.size());
+  }
+
+  Renderer& Renderer::drawCircles(const Pair<Point, int>* circles, std::size_t count)
+  {
+    m_scratchPoints.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+      rasterCircle(circles[i].first.getX(),
+		   circles[i].first.getY(),
+		   circles[i].second,
+		   m_scratchPoints);
+
+    this->submitPoints(Command::Points, m_scratchPoints.data(), m_scratchPoints.size());
+
     return *this;
   }
   
-  Renderer& Renderer::fillCircle(int x0, int y0, int r)
+  Renderer& Renderer::drawSprites(Texture& texture,
+				    const Sprite* sprites,
+				    std::size_t count)
   {
-    int x  = r - 1;
-    int y  = 0;
-    int dx = 1;
-    int dy = 1;
-    int e  = dx - (r << 1);
+    if (count == 0)
+      return *this;
 
-    while (x >= y)
-    {
-      this->drawLine(x0 + x, y0 + y, x0 - x, y0 + y);
-      this->drawLine(x0 + y, y0 + x, x0 - y, y0 + x);
-      this->drawLine(x0 - x, y0 - y, x0 + x, y0 - y);
-      this->drawLine(x0 - y, y0 - x, x0 + y, y0 - x);
+    // Recorded commands must land before the batch
+    this->flush();
 
-      if (e <= 0)
-      {
-	y++;
-	e += dy;
-	dy += 2;
-      }
+    if (m_damageTracking)
+      for (std::size_t i = 0; i < count; ++i)
+	this->touch(rotatedBounds(*(const SDL_Rect*)&sprites[i].dst, sprites[i].angle, nullptr));
 
-      if (e >0)
-      {
-	x--;
-	dx += 2;
-	e += (-r << 1) + dx;
-      }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    const int w = texture.getWidth();
+    const int h = texture.getHeight();
+
+    m_vertices.clear();
+    m_indices.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+      appendQuad(sprites[i], w, h, m_vertices, m_indices);
+
+    if (SDL_RenderGeometry(m_renderer,
+			   texture.toSDL(),
+			   m_vertices.data(), m_vertices.size(),
+			   m_indices.data(), m_indices.size()) != 0)
+      throw Error(SDL_GetError());
+
+    SO_STAT(m_stats.geometryCalls++);
+    SO_STAT(this->countCopy(texture.toSDL(), nullptr, 0));
+#else
+    Uint8 r, g, b, a;
+
+    SDL_GetTextureColorMod(texture.toSDL(), &r, &g, &b);
+    SDL_GetTextureAlphaMod(texture.toSDL(), &a);
+
+    int status = 0;
+
+    for (std::size_t i = 0; i < count && status == 0; ++i)
+    {
+      const Sprite& sprite = sprites[i];
+      const bool wholeTexture = sprite.src.getWidth() == 0 || sprite.src.getHeight() == 0;
+
+      SDL_SetTextureColorMod(texture.toSDL(),
+			     sprite.colorMod.getRed(),
+			     sprite.colorMod.getGreen(),
+			     sprite.colorMod.getBlue());
+      SDL_SetTextureAlphaMod(texture.toSDL(), sprite.colorMod.getAlpha());
+
+      status = SDL_RenderCopyEx(m_renderer,
+				texture.toSDL(),
+				wholeTexture ? NULL : (const SDL_Rect*)&sprite.src,
+				(const SDL_Rect*)&sprite.dst,
+				sprite.angle,
+				NULL,
+				static_cast<SDL_RendererFlip>(sprite.flip));
     }
 
+    SDL_SetTextureColorMod(texture.toSDL(), r, g, b);
+    SDL_SetTextureAlphaMod(texture.toSDL(), a);
+
+    if (status != 0)
+      throw Error(SDL_GetError());
+
+    // The area of each sprite is counted below
+    SO_STAT(this->countCopy(texture.toSDL(), nullptr, 0));
+    SO_STAT(m_stats.copyCalls += count);
+#endif
+
+#ifndef SO_NO_RENDERER_STATS
+    for (std::size_t i = 0; i < count; ++i)
+      m_stats.pixelsCopied += static_cast<Uint64>(sprites[i].dst.getWidth())
+	* sprites[i].dst.getHeight();
+#endif
+
+    return *this;
+  }
+
+  Renderer& Renderer::drawSprites(Texture& texture, const std::vector<Sprite>& sprites)
+  {
+    if (sprites.empty())
+      return *this;
+
+    return this->drawSprites(texture, &sprites[0], sprites.size());
+  }
+  
+  Renderer& Renderer::fillCircle(int x0, int y0, int r)
+  {
+    const Pair<Point, int> circle {{x0, y0}, r};
+
+    return this->fillCircles(&circle, 1);
+  }
+
+  Renderer& Renderer::fillCircles(const std::vector<Pair<Point, int>>& circles)
+  {
+    if (circles.empty())
+      return *this;
+
+    return this->fillCircles(&circles[0], circles.size());
+  }
+
+  Renderer& Renderer::fillCircles(const Pair<Point, int>* circles, std::size_t count)
+  {
+    m_scratchRects.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+      rasterDisc(circles[i].first.getX(),
+		 circles[i].first.getY(),
+		 circles[i].second,
+		 m_scratchSpans,
+		 m_scratchRects);
+
+    this->submitRects(Command::FillRects, m_scratchRects.data(), m_scratchRects.size());
+
     return *this;
   }
 
   Renderer& Renderer::drawLine(int x1, int y1, int x2, int y2)
   {
+    if (m_damageTracking)
+      this->touch({std::min(x1, x2), std::min(y1, y2),
+		   std::abs(x2 - x1) + 1, std::abs(y2 - y1) + 1});
+
+    if (m_deferred)
+    {
+      // Chain segments sharing an end point into a single polyline.
+      if (!m_commands.empty() &&
+	  m_commands.back().type == Command::Lines &&
+	  m_commands.back().blendMode == m_drawBlendMode &&
+	  sameColor(m_commands.back().color, toSDLColor(m_drawColor)) &&
+	  m_points.back().x == x1 && m_points.back().y == y1)
+      {
+	m_commands.back().count++;
+      }
+      else
+      {
+	this->record(Command::Lines, nullptr, m_points.size()).count = 2;
+	m_points.push_back({x1, y1});
+      }
+
+      m_points.push_back({x2, y2});
+      return *this;
+    }
+
     if (SDL_RenderDrawLine(m_renderer, x1, y1, x2, y2) != 0)
       throw SO::Error(SDL_GetError());
 
+    SO_STAT(m_stats.lineCalls++);
+
     return *this;
   }
 
@@ -372,18 +967,40 @@ namespace SO
 
   Renderer& Renderer::drawLines(const std::vector<Point>& points)
   {
+    return this->drawLines(points.data(), points.size());
+  }
 
-    if (SDL_RenderDrawLines(m_renderer, (const SDL_Point*)&points[0], points.size()) != 0)
-      throw Error(SDL_GetError());
-      
+  Renderer& Renderer::drawLines(const Point* points, std::size_t count)
+  {
+    this->submitPoints(Command::Lines, (const SDL_Point*)points, count);
+    return *this;
+  }
+
+  Renderer& Renderer::drawLines(const int* x, const int* y,
+				std::size_t count,
+				std::size_t stride)
+  {
+    this->submitPoints(Command::Lines, this->gatherPoints(x, y, count, stride), count);
     return *this;
   }
 
   Renderer& Renderer::drawPoint(int x, int y)
   {
+    if (m_damageTracking)
+      this->touch({x, y, 1, 1});
+
+    if (m_deferred)
+    {
+      this->record(Command::Points, nullptr, m_points.size()).count++;
+      m_points.push_back({x, y});
+      return *this;
+    }
+
     if (SDL_RenderDrawPoint(m_renderer, x, y) != 0)
       throw SO::Error(SDL_GetError());
 
+    SO_STAT(m_stats.pointCalls++);
+
     return *this;
   }
 
@@ -394,53 +1011,143 @@ namespace SO
 
   Renderer& Renderer::drawPoints(const std::vector<Point>& points)
   {
+    return this->drawPoints(points.data(), points.size());
+  }
 
-    if (SDL_RenderDrawPoints(m_renderer,
-			     (const SDL_Point*)&points[0],
-			     points.size()) != 0)
-      throw Error(SDL_GetError());
-    
+  Renderer& Renderer::drawPoints(const Point* points, std::size_t count)
+  {
+    this->submitPoints(Command::Points, (const SDL_Point*)points, count);
+    return *this;
+  }
+
+  Renderer& Renderer::drawPoints(const int* x, const int* y,
+				 std::size_t count,
+				 std::size_t stride)
+  {
+    this->submitPoints(Command::Points, this->gatherPoints(x, y, count, stride), count);
     return *this;
   }
 
   Renderer& Renderer::drawRect(const Rect& rect)
   {
+    if (m_damageTracking)
+      this->touch(*(const SDL_Rect*)&rect);
+
+    if (m_deferred)
+    {
+      this->record(Command::Rects, nullptr, m_rects.size()).count++;
+      m_rects.push_back(*(const SDL_Rect*)&rect);
+      return *this;
+    }
+
     if (SDL_RenderDrawRect(m_renderer, (const SDL_Rect*)&rect) != 0)
       throw SO::Error(SDL_GetError());
 
+    SO_STAT(m_stats.rectCalls++);
+
     return *this;
   }
 
   Renderer& Renderer::drawRects(const std::vector<Rect>& rects)
   {
-    if (SDL_RenderDrawRects(m_renderer,
-			    (const SDL_Rect*)&rects[0],
-			    rects.size()) != 0)
-      throw Error(SDL_GetError());
-    
+    return this->drawRects(rects.data(), rects.size());
+  }
+
+  Renderer& Renderer::drawRects(const Rect* rects, std::size_t count)
+  {
+    this->submitRects(Command::Rects, (const SDL_Rect*)rects, count);
+    return *this;
+  }
+
+  Renderer& Renderer::drawRects(const int* x, const int* y,
+				const int* w, const int* h,
+				std::size_t count,
+				std::size_t stride)
+  {
+    this->submitRects(Command::Rects, this->gatherRects(x, y, w, h, count, stride), count);
     return *this;
   }
 
   Renderer& Renderer::fillRect(const Rect& rect)
   {
+    if (m_damageTracking)
+      this->touch(*(const SDL_Rect*)&rect);
+
+    if (m_deferred)
+    {
+      this->record(Command::FillRects, nullptr, m_rects.size()).count++;
+      m_rects.push_back(*(const SDL_Rect*)&rect);
+      return *this;
+    }
+
     if (SDL_RenderFillRect(m_renderer, (const SDL_Rect*)&rect) != 0)
       throw SO::Error(SDL_GetError());
 
+    SO_STAT(this->countDraw(Command::FillRects, (const SDL_Rect*)&rect, 1));
+
     return *this;
   }
 
   Renderer& Renderer::fillRects(const std::vector<Rect>& rects)
   {
-    if (SDL_RenderFillRects(m_renderer,
-			    (const SDL_Rect*)&rects[0],
-			    rects.size()) != 0)
-      throw Error(SDL_GetError());
-    
+    return this->fillRects(rects.data(), rects.size());
+  }
+
+  Renderer& Renderer::fillRects(const Rect* rects, std::size_t count)
+  {
+    this->submitRects(Command::FillRects, (const SDL_Rect*)rects, count);
+    return *this;
+  }
+
+  Renderer& Renderer::fillRects(const int* x, const int* y,
+				const int* w, const int* h,
+				std::size_t count,
+				std::size_t stride)
+  {
+    this->submitRects(Command::FillRects, this->gatherRects(x, y, w, h, count, stride), count);
+    return *this;
+  }
+
+  Renderer& Renderer::flush()
+  {
+    if (!m_deferred)
+      return *this;
+
+    try
+    {
+      for (const DrawCommand& command : m_commands)
+      {
+	if (command.texture == nullptr)
+	  this->applyDrawState(command.color, command.blendMode);
+
+	this->submit(command);
+      }
+
+      // Leave SDL with the draw state the user last asked for
+      this->applyDrawState(toSDLColor(m_drawColor), m_drawBlendMode);
+    }
+    catch (...)
+    {
+      // Never replay a list that failed halfway
+      m_commands.clear();
+      m_points.clear();
+      m_rects.clear();
+      m_copiesEx.clear();
+      throw;
+    }
+
+    m_commands.clear();
+    m_points.clear();
+    m_rects.clear();
+    m_copiesEx.clear();
+
     return *this;
   }
 
   Renderer& Renderer::readPixels(const Rect& rect, PixelFormats format, void* pixels, int pitch)
   {
+    this->flush();
+
     if (SDL_RenderReadPixels(m_renderer,
 			     (const SDL_Rect*)&rect,
 			     (Uint32)format,
@@ -450,6 +1157,574 @@ namespace SO
     return *this;
   }
 
+  // Private methods of class Renderer
+
+  void Renderer::init()
+  {
+    if (m_renderer == nullptr)
+      throw Error(SDL_GetError());
+
+    if (SDL_GetRenderDrawColor(m_renderer,
+			       &m_appliedColor.r,
+			       &m_appliedColor.g,
+			       &m_appliedColor.b,
+			       &m_appliedColor.a) != 0 ||
+	SDL_GetRenderDrawBlendMode(m_renderer, &m_appliedBlendMode) != 0)
+      throw Error(SDL_GetError());
+
+    m_drawColor     = {m_appliedColor.r, m_appliedColor.g, m_appliedColor.b, m_appliedColor.a};
+    m_drawBlendMode = m_appliedBlendMode;
+
+    SDL_RendererInfo info;
+
+    if (SDL_GetRendererInfo(m_renderer, &info) != 0)
+      throw Error(SDL_GetError());
+
+    m_targetSupported = (info.flags & SDL_RENDERER_TARGETTEXTURE) != 0;
+
+    this->syncState();
+
+    liveRenderers().push_back(this);
+  }
+
+  void Renderer::release(SDL_Texture* texture) noexcept
+  {
+    for (Renderer* renderer : liveRenderers())
+    {
+      try
+      {
+	renderer->forget(texture);
+      }
+      catch (const Error&)
+      {
+	// A failed flush drops the whole list, texture included, and SDL
+	// resets the target itself when destroying it
+	if (renderer->m_target == texture)
+	  renderer->m_target = nullptr;
+      }
+    }
+  }
+
+  void Renderer::modifying(SDL_Texture* texture)
+  {
+    for (Renderer* renderer : liveRenderers())
+      renderer->flushCopiesFrom(texture);
+  }
+
+  void Renderer::forget(SDL_Texture* texture)
+  {
+    if (m_boundTexture == texture)
+      m_boundTexture = nullptr;
+
+    // Pending copies from the texture must reach SDL while it exists
+    this->flushCopiesFrom(texture);
+
+    // SDL falls back to the default target when the current one is
+    // destroyed. Do it first so that the shadow state never keeps a
+    // freed pointer, which a new texture could be allocated at.
+    std::replace(m_targetStack.begin(), m_targetStack.end(), texture, (SDL_Texture*)nullptr);
+
+    if (m_target == texture)
+      this->applyTarget(nullptr);
+  }
+
+  void Renderer::flushCopiesFrom(SDL_Texture* texture)
+  {
+    for (const DrawCommand& command : m_commands)
+      if (command.texture == texture)
+      {
+	this->flush();
+	break;
+      }
+  }
+
+  bool Renderer::applyTarget(SDL_Texture* texture)
+  {
+    // The back buffer stands for the default target
+    if (texture == nullptr && m_damageTracking)
+      texture = m_backBuffer;
+
+    if (texture == m_target)
+      return true;
+
+    if (!m_targetSupported)
+      return false;
+
+    this->flush();
+
+    if (SDL_SetRenderTarget(m_renderer, texture) != 0)
+      throw Error(SDL_GetError());
+
+    // A new target comes with its own viewport and clip rect
+    SO_STAT(++m_stats.stateChanges);
+    this->syncState();
+
+    return true;
+  }
+
+  void Renderer::applyDrawState(const SDL_Color& color, SDL_BlendMode blendMode)
+  {
+    if (!sameColor(color, m_appliedColor))
+    {
+      if (SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a) != 0)
+	throw Error(SDL_GetError());
+
+      SO_STAT(++m_stats.stateChanges);
+      m_appliedColor = color;
+    }
+
+    if (blendMode != m_appliedBlendMode)
+    {
+      if (SDL_SetRenderDrawBlendMode(m_renderer, blendMode) != 0)
+	throw Error(SDL_GetError());
+
+      SO_STAT(++m_stats.stateChanges);
+      m_appliedBlendMode = blendMode;
+    }
+  }
+
+  void Renderer::syncState()
+  {
+    SDL_Rect viewport, clipRect;
+
+    SDL_RenderGetViewport(m_renderer, &viewport);
+    SDL_RenderGetClipRect(m_renderer, &clipRect);
+    SDL_RenderGetScale(m_renderer, &m_scale.first, &m_scale.second);
+
+    m_viewport = viewport;
+    m_clipRect = clipRect;
+    m_target   = SDL_GetRenderTarget(m_renderer);
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+    m_clipEnabled = static_cast<bool>(SDL_RenderIsClipEnabled(m_renderer));
+#else
+    m_clipEnabled = clipRect.w != 0 && clipRect.h != 0;
+#endif
+  }
+
+  Renderer::DrawCommand& Renderer::record(Command type,
+					  SDL_Texture* texture,
+					  Uint32 first)
+  {
+    SDL_Color color = toSDLColor(m_drawColor);
+
+    // Adjacent compatible commands are merged, their payloads being
+    // contiguous. Lines are chained by Renderer::drawLine only.
+    if (!m_commands.empty() && type != Command::Lines)
+    {
+      DrawCommand& last = m_commands.back();
+
+      if (last.type == type &&
+	  last.texture == texture &&
+	  (texture != nullptr ||
+	   (last.blendMode == m_drawBlendMode && sameColor(last.color, color))))
+	return last;
+    }
+
+    m_commands.push_back({type, m_drawBlendMode, color, texture, first, 0});
+
+    return m_commands.back();
+  }
+
+  void Renderer::submit(const DrawCommand& command)
+  {
+    int  status  = 0;
+    bool batched = false;
+
+    switch (command.type)
+    {
+      case Command::Clear:
+	status = SDL_RenderClear(m_renderer);
+	break;
+      case Command::Points:
+	status = SDL_RenderDrawPoints(m_renderer,
+				      &m_points[command.first],
+				      command.count);
+	break;
+      case Command::Lines:
+	if (command.count == 2)
+	  status = SDL_RenderDrawLine(m_renderer,
+				      m_points[command.first].x,
+				      m_points[command.first].y,
+				      m_points[command.first + 1].x,
+				      m_points[command.first + 1].y);
+	else
+	  status = SDL_RenderDrawLines(m_renderer,
+				       &m_points[command.first],
+				       command.count);
+	break;
+      case Command::Rects:
+	status = SDL_RenderDrawRects(m_renderer,
+				     &m_rects[command.first],
+				     command.count);
+	break;
+      case Command::FillRects:
+	status = SDL_RenderFillRects(m_renderer,
+				     &m_rects[command.first],
+				     command.count);
+	break;
+      case Command::Copy:
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	// A run of copies goes out as one batch of quads
+	if (command.count > 1 && this->gatherCopies(command))
+	{
+	  status  = SDL_RenderGeometry(m_renderer,
+				       command.texture,
+				       m_vertices.data(), m_vertices.size(),
+				       m_indices.data(), m_indices.size());
+	  batched = true;
+	  break;
+	}
+#endif
+	for (Uint32 i = 0; i < command.count && status == 0; ++i)
+	{
+	  const SDL_Rect& src = m_rects[command.first + 2*i];
+	  const SDL_Rect& dst = m_rects[command.first + 2*i + 1];
+
+	  status = SDL_RenderCopy(m_renderer,
+				  command.texture,
+				  orNull(src),
+				  orNull(dst));
+	}
+	break;
+      case Command::CopyEx:
+	for (Uint32 i = 0; i < command.count && status == 0; ++i)
+	{
+	  const CopyExArgs& args = m_copiesEx[command.first + i];
+
+	  status = SDL_RenderCopyEx(m_renderer,
+				    command.texture,
+				    orNull(args.src),
+				    orNull(args.dst),
+				    args.angle,
+				    args.hasCenter ? &args.center : nullptr,
+				    args.flip);
+	}
+	break;
+    }
+
+    if (status != 0)
+      throw Error(SDL_GetError());
+
+#ifndef SO_NO_RENDERER_STATS
+    switch (command.type)
+    {
+      case Command::Clear:
+	m_stats.clearCalls++;
+	break;
+      case Command::Points:
+      case Command::Lines:
+	this->countDraw(command.type, nullptr, 0);
+	break;
+      case Command::Rects:
+      case Command::FillRects:
+	this->countDraw(command.type, &m_rects[command.first], command.count);
+	break;
+      case Command::Copy:
+	if (batched)
+	{
+	  m_stats.geometryCalls++;
+	  this->countCopy(command.texture, nullptr, 0);
+	}
+
+	for (Uint32 i = 0; i < command.count; ++i)
+	  if (batched)
+	    this->countPixels(orNull(m_rects[command.first + 2*i + 1]));
+	  else
+	    this->countCopy(command.texture, orNull(m_rects[command.first + 2*i + 1]), 1);
+	break;
+      case Command::CopyEx:
+	for (Uint32 i = 0; i < command.count; ++i)
+	  this->countCopy(command.texture, orNull(m_copiesEx[command.first + i].dst), 1);
+	break;
+    }
+#endif
+  }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  bool Renderer::gatherCopies(const DrawCommand& command)
+  {
+    int   w, h;
+    Uint8 r, g, b, a;
+
+    // Errors are left for SDL_RenderCopy to report
+    if (SDL_QueryTexture(command.texture, nullptr, nullptr, &w, &h) != 0 ||
+	SDL_GetTextureColorMod(command.texture, &r, &g, &b) != 0 ||
+	SDL_GetTextureAlphaMod(command.texture, &a) != 0)
+      return false;
+
+    // Quads ignore the texture modulation, it goes in the vertices
+    Sprite sprite;
+    sprite.colorMod = Color(r, g, b, a);
+
+    m_vertices.clear();
+    m_indices.clear();
+
+    for (Uint32 i = 0; i < command.count; ++i)
+    {
+      const SDL_Rect& src = m_rects[command.first + 2*i];
+      const SDL_Rect& dst = m_rects[command.first + 2*i + 1];
+
+      // SDL_RenderCopy clips the source to the texture and shrinks the
+      // destination with it, quads would stretch instead. SO::Rect
+      // coordinates are 16 bits.
+      if (src.w >= 0 &&
+	  (src.w == 0 || src.h == 0 || src.x < 0 || src.y < 0 ||
+	   src.x + src.w > w || src.y + src.h > h))
+	return false;
+
+      if (dst.w >= 0 &&
+	  (dst.w == 0 || dst.h <= 0 ||
+	   dst.x < SDL_MIN_SINT16 || dst.y < SDL_MIN_SINT16 ||
+	   dst.x + dst.w > SDL_MAX_SINT16 || dst.y + dst.h > SDL_MAX_SINT16))
+	return false;
+
+      sprite.src = src.w < 0 ? Rect() : Rect(src);
+      sprite.dst = dst.w < 0 ? Rect(0, 0, m_viewport.getWidth(), m_viewport.getHeight()) : Rect(dst);
+
+      appendQuad(sprite, w, h, m_vertices, m_indices);
+    }
+
+    return true;
+  }
+#endif
+
+  void Renderer::submitPoints(Command type, const SDL_Point* points, std::size_t count)
+  {
+    if (count == 0)
+      return;
+
+    // A batch is damaged as its bounding box
+    if (m_damageTracking)
+    {
+      int x0 = points[0].x, y0 = points[0].y, x1 = x0, y1 = y0;
+
+      for (std::size_t i = 1; i < count; ++i)
+      {
+	x0 = std::min(x0, points[i].x);
+	y0 = std::min(y0, points[i].y);
+	x1 = std::max(x1, points[i].x);
+	y1 = std::max(y1, points[i].y);
+      }
+
+      this->touch({x0, y0, x1 - x0 + 1, y1 - y0 + 1});
+    }
+
+    if (m_deferred)
+    {
+      this->record(type, nullptr, m_points.size()).count += count;
+      m_points.insert(m_points.end(), points, points + count);
+      return;
+    }
+
+    const int status = type == Command::Lines ?
+      SDL_RenderDrawLines(m_renderer, points, count) :
+      SDL_RenderDrawPoints(m_renderer, points, count);
+
+    if (status != 0)
+      throw Error(SDL_GetError());
+
+    SO_STAT(this->countDraw(type, nullptr, 0));
+  }
+
+  void Renderer::submitRects(Command type, const SDL_Rect* rects, std::size_t count)
+  {
+    if (count == 0)
+      return;
+
+    // A batch is damaged as its bounding box
+    if (m_damageTracking)
+    {
+      SDL_Rect bounds = rects[0];
+
+      for (std::size_t i = 1; i < count; ++i)
+      {
+	const int x1 = std::max(bounds.x + bounds.w, rects[i].x + rects[i].w);
+	const int y1 = std::max(bounds.y + bounds.h, rects[i].y + rects[i].h);
+
+	bounds.x = std::min(bounds.x, rects[i].x);
+	bounds.y = std::min(bounds.y, rects[i].y);
+	bounds.w = x1 - bounds.x;
+	bounds.h = y1 - bounds.y;
+      }
+
+      this->touch(bounds);
+    }
+
+    if (m_deferred)
+    {
+      this->record(type, nullptr, m_rects.size()).count += count;
+      m_rects.insert(m_rects.end(), rects, rects + count);
+      return;
+    }
+
+    const int status = type == Command::FillRects ?
+      SDL_RenderFillRects(m_renderer, rects, count) :
+      SDL_RenderDrawRects(m_renderer, rects, count);
+
+    if (status != 0)
+      throw Error(SDL_GetError());
+
+    SO_STAT(this->countDraw(type, rects, count));
+  }
+
+  void Renderer::createBackBuffer()
+  {
+    int w, h;
+    SDL_RendererInfo info;
+
+    if (SDL_GetRendererOutputSize(m_renderer, &w, &h) != 0 ||
+	SDL_GetRendererInfo(m_renderer, &info) != 0)
+      throw Error(SDL_GetError());
+
+    m_backBuffer = SDL_CreateTexture(m_renderer,
+				     info.num_texture_formats > 0 ?
+				     info.texture_formats[0] : SDL_PIXELFORMAT_ARGB8888,
+				     SDL_TEXTUREACCESS_TARGET,
+				     w, h);
+
+    if (m_backBuffer == nullptr)
+      throw Error(SDL_GetError());
+
+    // Copied opaque to the screen at present
+    SDL_SetTextureBlendMode(m_backBuffer, SDL_BLENDMODE_NONE);
+
+    // Its content is undefined, everything has to be drawn again
+    m_damage.setBounds({0, 0, static_cast<Uint16>(w), static_cast<Uint16>(h)});
+    m_damage.addAll();
+  }
+
+  void Renderer::touch(const SDL_Rect& area)
+  {
+    // Only drawing on the back buffer is tracked
+    if (m_target != m_backBuffer)
+      return;
+
+    int x0 = area.x, y0 = area.y;
+    int x1 = area.x + area.w, y1 = area.y + area.h;
+
+    if (m_clipEnabled)
+    {
+      x0 = std::max(x0, (int)m_clipRect.getX());
+      y0 = std::max(y0, (int)m_clipRect.getY());
+      x1 = std::min(x1, m_clipRect.getX() + m_clipRect.getWidth());
+      y1 = std::min(y1, m_clipRect.getY() + m_clipRect.getHeight());
+    }
+
+    // From viewport coordinates to back buffer pixels
+    const float sx = m_scale.first, sy = m_scale.second;
+
+    const Rect bounds = m_damage.getBounds();
+
+    // Clamped to the back buffer before being narrowed to a SO::Rect,
+    // far off screen coordinates would wrap around otherwise
+    auto clamp = [](double value, int high)
+      {
+	return static_cast<int>(std::min(std::max(value, 0.0), (double)high));
+      };
+
+    const int px0 = clamp(std::floor((m_viewport.getX() + (double)x0) * sx), bounds.getWidth());
+    const int py0 = clamp(std::floor((m_viewport.getY() + (double)y0) * sy), bounds.getHeight());
+    const int px1 = clamp(std::ceil((m_viewport.getX() + (double)x1) * sx), bounds.getWidth());
+    const int py1 = clamp(std::ceil((m_viewport.getY() + (double)y1) * sy), bounds.getHeight());
+
+    if (px1 > px0 && py1 > py0)
+      m_damage.add({static_cast<Sint16>(px0), static_cast<Sint16>(py0),
+		    static_cast<Uint16>(px1 - px0), static_cast<Uint16>(py1 - py0)});
+  }
+
+  void Renderer::countDraw(Command type, const SDL_Rect* rects, std::size_t count)
+  {
+    switch (type)
+    {
+      case Command::Points:
+	m_stats.pointCalls++;
+	break;
+      case Command::Lines:
+	m_stats.lineCalls++;
+	break;
+      case Command::Rects:
+	m_stats.rectCalls++;
+	break;
+      case Command::FillRects:
+	m_stats.fillRectCalls++;
+	for (std::size_t i = 0; i < count; ++i)
+	  m_stats.pixelsFilled += static_cast<Uint64>(rects[i].w) * rects[i].h;
+	break;
+      default:
+	break;
+    }
+  }
+
+  void Renderer::countCopy(SDL_Texture* texture, const SDL_Rect* dst, Uint32 calls)
+  {
+    if (texture != m_boundTexture)
+    {
+      m_stats.textureBinds++;
+      m_boundTexture = texture;
+    }
+
+    m_stats.copyCalls += calls;
+
+    if (calls != 0)
+      this->countPixels(dst);
+  }
+
+  void Renderer::countPixels(const SDL_Rect* dst)
+  {
+    // A NULL destination covers the whole viewport
+    m_stats.pixelsCopied += dst != nullptr ?
+      static_cast<Uint64>(dst->w) * dst->h :
+      static_cast<Uint64>(m_viewport.getWidth()) * m_viewport.getHeight();
+  }
+
+  const SDL_Point* Renderer::gatherPoints(const int* x, const int* y,
+					  std::size_t count,
+					  std::size_t stride)
+  {
+    // Interleaved x, y already are SDL_Point
+    if (y == x + 1 && stride == sizeof(SDL_Point))
+      return (const SDL_Point*)x;
+
+    const Uint8* px = (const Uint8*)x;
+    const Uint8* py = (const Uint8*)y;
+
+    m_scratchPoints.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i, px += stride, py += stride)
+      m_scratchPoints[i] = {*(const int*)px, *(const int*)py};
+
+    return m_scratchPoints.data();
+  }
+
+  const SDL_Rect* Renderer::gatherRects(const int* x, const int* y,
+					const int* w, const int* h,
+					std::size_t count,
+					std::size_t stride)
+  {
+    // Interleaved x, y, w, h already are SDL_Rect
+    if (y == x + 1 && w == x + 2 && h == x + 3 && stride == sizeof(SDL_Rect))
+      return (const SDL_Rect*)x;
+
+    const Uint8* px = (const Uint8*)x;
+    const Uint8* py = (const Uint8*)y;
+    const Uint8* pw = (const Uint8*)w;
+    const Uint8* ph = (const Uint8*)h;
+
+    m_scratchRects.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      m_scratchRects[i] = {*(const int*)px, *(const int*)py,
+			   *(const int*)pw, *(const int*)ph};
+      px += stride;
+      py += stride;
+      pw += stride;
+      ph += stride;
+    }
+
+    return m_scratchRects.data();
+  }
+
   const SDL_Renderer* Renderer::toSDL() const
   {
     return m_renderer;
@@ -0,0 +1,164 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "SkylinePacker.hpp"
+
+#include <algorithm>
+
+namespace SO
+{
+
+  // Public methods of class SkylinePacker
+
+  /* Constructor/destructor */
+
+  SkylinePacker::SkylinePacker(int width, int height)
+    : m_width(width),
+      m_height(height),
+      m_used(0)
+  {
+    this->clear();
+  }
+
+  /* Methods */
+
+  bool SkylinePacker::insert(int width, int height, Rect& rect)
+  {
+    if (width <= 0 || height <= 0)
+      return false;
+
+    std::size_t best      = m_skyline.size();
+    int         bestY     = m_height;
+    int         bestWaste = m_width;
+
+    for (std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+      const int y = this->fit(i, width, height);
+
+      if (y < 0)
+	continue;
+
+      // Width of the segments under the rect left above their skyline
+      int waste = 0;
+
+      for (std::size_t j = i; j < m_skyline.size() && m_skyline[j].x < m_skyline[i].x + width; ++j)
+      {
+	const int right = std::min(m_skyline[j].x + m_skyline[j].width, m_skyline[i].x + width);
+
+	waste += (right - m_skyline[j].x) * (y - m_skyline[j].y);
+      }
+
+      if (best == m_skyline.size() || y < bestY || (y == bestY && waste < bestWaste))
+      {
+	best      = i;
+	bestY     = y;
+	bestWaste = waste;
+      }
+    }
+
+    if (best == m_skyline.size())
+      return false;
+
+    const int x = m_skyline[best].x;
+
+    rect = Rect(x, bestY, width, height);
+    m_used += static_cast<Uint64>(width) * height;
+
+    // Raise the skyline over the rect, cutting the segments it covers
+    m_skyline.insert(m_skyline.begin() + best, Segment {x, bestY + height, width});
+
+    for (std::size_t i = best + 1; i < m_skyline.size();)
+    {
+      Segment& segment = m_skyline[i];
+      const int shrink = x + width - segment.x;
+
+      if (shrink <= 0)
+	break;
+
+      if (shrink < segment.width)
+      {
+	segment.x     += shrink;
+	segment.width -= shrink;
+	break;
+      }
+
+      m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (std::size_t i = 0; i + 1 < m_skyline.size();)
+    {
+      if (m_skyline[i].y == m_skyline[i + 1].y)
+      {
+	m_skyline[i].width += m_skyline[i + 1].width;
+	m_skyline.erase(m_skyline.begin() + i + 1);
+      }
+      else
+	++i;
+    }
+
+    return true;
+  }
+
+  SkylinePacker& SkylinePacker::clear()
+  {
+    m_skyline.assign(1, Segment {0, 0, m_width});
+    m_used = 0;
+
+    return *this;
+  }
+
+  float SkylinePacker::getOccupancy() const
+  {
+    const Uint64 area = static_cast<Uint64>(m_width) * m_height;
+
+    return area != 0 ? static_cast<float>(m_used) / area : 0.0f;
+  }
+
+  int SkylinePacker::getHeight() const
+  {
+    return m_height;
+  }
+
+  int SkylinePacker::getWidth() const
+  {
+    return m_width;
+  }
+
+  // Private methods of class SkylinePacker
+
+  int SkylinePacker::fit(std::size_t segment, int width, int height) const
+  {
+    const int x = m_skyline[segment].x;
+
+    if (x + width > m_width)
+      return -1;
+
+    int y = 0;
+
+    for (std::size_t i = segment; i < m_skyline.size() && m_skyline[i].x < x + width; ++i)
+      y = std::max(y, m_skyline[i].y);
+
+    return y + height <= m_height ? y : -1;
+  }
+
+}
@@ -1,4 +1,41 @@
 #include "Surface.hpp"
+#include "AssetPack.hpp"
+#include "Blitter.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+  // Blended with mode, without modulation nor color key, and unlocked
+  bool isPlain(const SDL_Surface* surface, SDL_BlendMode mode)
+  {
+    SDL_BlendMode current;
+    Uint8 r, g, b, a;
+    Uint32 key;
+
+    SDL_Surface* self = const_cast<SDL_Surface*>(surface);
+
+    return SDL_GetSurfaceBlendMode(self, &current) == 0 && current == mode
+      && SDL_GetSurfaceColorMod(self, &r, &g, &b) == 0 && (r & g & b) == 0xFF
+      && SDL_GetSurfaceAlphaMod(self, &a) == 0 && a == 0xFF
+      && SDL_GetColorKey(self, &key) != 0
+      && !SDL_MUSTLOCK(surface) && !surface->locked;
+  }
+
+  // SDL_CreateRGBSurfaceWithFormat, which needs SDL 2.0.5
+  SDL_Surface* createSurface(int width, int height, Uint32 format)
+  {
+    int    bpp;
+    Uint32 r, g, b, a;
+
+    if (!SDL_PixelFormatEnumToMasks(format, &bpp, &r, &g, &b, &a))
+      return nullptr;
+
+    return SDL_CreateRGBSurface(0, width, height, bpp, r, g, b, a);
+  }
+
+}
 
 namespace SO
 {
@@ -27,21 +64,28 @@ namespace SO
 #endif
       }
 
-    if (stretch == nullptr)
-      {
-        m_surface = loadedSurface;
-      }
-    else
-      {
-        m_surface = SDL_ConvertSurface(loadedSurface, stretch->toSDL()->format, 0);
+    this->adopt(loadedSurface, stretch);
+  }
 
-        SDL_FreeSurface(loadedSurface);
+  Surface::Surface(const AssetPack& pack, const std::string& name,
+		   const Surface* const stretch) : m_surface(nullptr)
+  {
+#ifndef _SDL_IMAGE_H
+    SDL_Surface* loadedSurface = SDL_LoadBMP_RW(pack.open(name), 1);
+#else
+    SDL_Surface* loadedSurface = IMG_Load_RW(pack.open(name), 1);
+#endif
 
-        if (m_surface == nullptr)
-	  {
-            throw Error(SDL_GetError());
-	  }
+    if (loadedSurface == nullptr)
+      {
+#ifndef _SDL_IMAGE_H
+        throw Error(SDL_GetError());
+#else
+        throw Error(IMG_GetError());
+#endif
       }
+
+    this->adopt(loadedSurface, stretch);
   }
 
 
@@ -75,102 +119,111 @@ namespace SO
 
   Surface& Surface::blit(const Rect& srcRect, Surface& dst, Rect& dstRect)
   {
-    if (SDL_BlitSurface(m_surface,
-			(const SDL_Rect*)&srcRect,
-			dst.toSDL(),
-			(SDL_Rect*)&dstRect) != 0)
-      throw Error(SDL_GetError());
+    this->blitTo((const SDL_Rect*)&srcRect, dst, (SDL_Rect*)&dstRect);
     
     return *this;
   }
 
   Surface& Surface::blit(Surface& dst, Rect& dstRect)
   {
-    if (SDL_BlitSurface(m_surface, NULL, dst.toSDL(), (SDL_Rect*)&dstRect) != 0)
-      throw Error(SDL_GetError());
+    this->blitTo(NULL, dst, (SDL_Rect*)&dstRect);
     
     return *this;
   }
 
   Surface& Surface::blit(const Rect& srcRect, Surface& dst)
   {
-    if (SDL_BlitSurface(m_surface, (const SDL_Rect*)&srcRect, dst.toSDL(), NULL) != 0)
-      throw Error(SDL_GetError());
+    this->blitTo((const SDL_Rect*)&srcRect, dst, NULL);
     
     return *this;
   }
 
   Surface& Surface::blit(Surface& dst)
   {
-    if (SDL_BlitSurface(m_surface,
-			NULL,
-			dst.toSDL(),
-			NULL) != 0)
-      throw Error(SDL_GetError());
+    this->blitTo(NULL, dst, NULL);
     
     return *this;
   }
 
-  Surface& Surface::blitScaled(const Rect& srcRect, Surface& dst, Rect& dstRect)
+  Surface& Surface::blitScaled(const Rect& srcRect, Surface& dst, Rect& dstRect, ScaleFilters filter)
   {
-    if (SDL_BlitScaled(m_surface,
-		       (const SDL_Rect*)&srcRect,
-		       dst.toSDL(),
-		       (SDL_Rect*)&dstRect) != 0)
-      throw Error(SDL_GetError());
+    this->blitScaledTo((const SDL_Rect*)&srcRect, dst, (SDL_Rect*)&dstRect, filter);
     
     return *this;
   }
 
-  Surface& Surface::blitScaled(Surface& dst, Rect& dstRect)
+  Surface& Surface::blitScaled(Surface& dst, Rect& dstRect, ScaleFilters filter)
   {
-    if (SDL_BlitScaled(m_surface,
-		       NULL,
-		       dst.toSDL(),
-		       (SDL_Rect*)&dstRect) != 0)
-      throw Error(SDL_GetError());
+    this->blitScaledTo(NULL, dst, (SDL_Rect*)&dstRect, filter);
     
     return *this;
   }
 
-  Surface& Surface::blitScaled(const Rect& srcRect, Surface& dst)
+  Surface& Surface::blitScaled(const Rect& srcRect, Surface& dst, ScaleFilters filter)
   {
-    if (SDL_BlitScaled(m_surface,
-		       (const SDL_Rect*)&srcRect,
-		       dst.toSDL(),
-		       NULL) != 0)
-      throw Error(SDL_GetError());
+    this->blitScaledTo((const SDL_Rect*)&srcRect, dst, NULL, filter);
     
     return *this;
   }
 
-  Surface& Surface::blitScaled(Surface& dst)
+  Surface& Surface::blitScaled(Surface& dst, ScaleFilters filter)
   {
-    if (SDL_BlitScaled(m_surface,
-		       NULL,
-		       dst.toSDL(),
-		       NULL) != 0)
-      throw Error(SDL_GetError());
+    this->blitScaledTo(NULL, dst, NULL, filter);
     
     return *this;
   }
 
-  Surface& Surface::fillRect(const Rect& rect, Uint32 color)
+  Surface& Surface::convertTo(Surface& dst)
   {
-    if (SDL_FillRect(m_surface,
-		     (const SDL_Rect*)&rect,
-		     color) != 0)
+    SDL_Surface* target = dst.toSDL();
+
+    if (m_surface->w != target->w || m_surface->h != target->h)
+      throw Error("Surface: sizes differ");
+
+    if (SDL_LockSurface(m_surface) != 0)
       throw Error(SDL_GetError());
+
+    if (target != m_surface && SDL_LockSurface(target) != 0)
+      {
+	SDL_UnlockSurface(m_surface);
+	throw Error(SDL_GetError());
+      }
+
+    try
+      {
+	Blitter::convert(m_surface->pixels, m_surface->pitch,
+			 static_cast<PixelFormats>(m_surface->format->format),
+			 target->pixels, target->pitch,
+			 static_cast<PixelFormats>(target->format->format),
+			 m_surface->w, m_surface->h);
+      }
+    catch (...)
+      {
+	if (target != m_surface)
+	  SDL_UnlockSurface(target);
+
+	SDL_UnlockSurface(m_surface);
+	throw;
+      }
+
+    if (target != m_surface)
+      SDL_UnlockSurface(target);
+
+    SDL_UnlockSurface(m_surface);
+
+    return *this;
+  }
+
+  Surface& Surface::fillRect(const Rect& rect, Uint32 color)
+  {
+    this->fillTo((const SDL_Rect*)&rect, color);
     
     return *this;
   }
 
   Surface& Surface::fillRect(Uint32 color)
   {
-    if (SDL_FillRect(m_surface,
-		     NULL,
-		     color) != 0)
-      throw Error(SDL_GetError());
+    this->fillTo(NULL, color);
     
     return *this;
   }
@@ -187,6 +240,21 @@ namespace SO
     return *this;
   }
 
+  Surface& Surface::lock()
+  {
+    if (SDL_LockSurface(m_surface) != 0)
+      throw Error(SDL_GetError());
+
+    return *this;
+  }
+
+  Surface& Surface::unlock()
+  {
+    SDL_UnlockSurface(m_surface);
+
+    return *this;
+  }
+
   const SDL_Surface* Surface::toSDL() const
   {
     return m_surface;
@@ -208,4 +276,374 @@ namespace SO
       }
   }
 
+  void Surface::blitTo(const SDL_Rect* srcRect, Surface& dst, SDL_Rect* dstRect)
+  {
+    SDL_Surface* target = dst.toSDL();
+
+    const bool blend = this->isBlendableOnto(dst);
+
+    SDL_Rect area = {0, 0, target->w, target->h};
+
+    if (dstRect != NULL)
+      area = *dstRect;
+
+    if (!blend && !this->isCopyableOnto(dst))
+      {
+	if (SDL_BlitSurface(m_surface, srcRect, target, &area) != 0)
+	  throw Error(SDL_GetError());
+
+	if (dstRect != NULL)
+	  *dstRect = area;
+
+	dst.modified(area);
+	return;
+      }
+
+    // Clipped as SDL_UpperBlit does, dstRect gets the final area
+    int srcX = 0, srcY = 0, w = m_surface->w, h = m_surface->h;
+
+    if (srcRect != NULL)
+      {
+	srcX = srcRect->x;
+	srcY = srcRect->y;
+	w    = srcRect->w;
+	h    = srcRect->h;
+
+	if (srcX < 0)
+	  {
+	    w      += srcX;
+	    area.x -= srcX;
+	    srcX    = 0;
+	  }
+
+	if (srcY < 0)
+	  {
+	    h      += srcY;
+	    area.y -= srcY;
+	    srcY    = 0;
+	  }
+
+	w = std::min(w, m_surface->w - srcX);
+	h = std::min(h, m_surface->h - srcY);
+      }
+
+    const SDL_Rect& clip = target->clip_rect;
+
+    int dx = clip.x - area.x;
+
+    if (dx > 0)
+      {
+	w      -= dx;
+	area.x += dx;
+	srcX   += dx;
+      }
+
+    dx = area.x + w - clip.x - clip.w;
+
+    if (dx > 0)
+      w -= dx;
+
+    int dy = clip.y - area.y;
+
+    if (dy > 0)
+      {
+	h      -= dy;
+	area.y += dy;
+	srcY   += dy;
+      }
+
+    dy = area.y + h - clip.y - clip.h;
+
+    if (dy > 0)
+      h -= dy;
+
+    area.w = std::max(w, 0);
+    area.h = std::max(h, 0);
+
+    // SDL copies as fast on a single thread
+    if (!blend && !Blitter::isParallel(area.w, area.h))
+      {
+	if (SDL_BlitSurface(m_surface, srcRect, target, dstRect) != 0)
+	  throw Error(SDL_GetError());
+
+	dst.modified(area);
+	return;
+      }
+
+    if (dstRect != NULL)
+      *dstRect = area;
+
+    if (area.w == 0 || area.h == 0)
+      return;
+
+    const int bytes = m_surface->format->BytesPerPixel;
+
+    const Uint8* from = static_cast<const Uint8*>(m_surface->pixels) + srcY * m_surface->pitch + srcX * bytes;
+    Uint8*       to   = static_cast<Uint8*>(target->pixels) + area.y * target->pitch + area.x * bytes;
+
+    // Neither needs locking, isBlendableOnto and isCopyableOnto checked it
+    if (blend)
+      Blitter::blend(from, m_surface->pitch, to, target->pitch, area.w, area.h);
+    else
+      Blitter::copy(from, m_surface->pitch, to, target->pitch, area.w * bytes, area.h);
+
+    dst.modified(area);
+  }
+
+  void Surface::blitScaledTo(const SDL_Rect* srcRect, Surface& dst, SDL_Rect* dstRect,
+			     ScaleFilters filter)
+  {
+    SDL_Surface* target = dst.toSDL();
+
+    SDL_Rect from = {0, 0, m_surface->w, m_surface->h};
+    SDL_Rect to   = {0, 0, target->w, target->h};
+
+    if (srcRect != NULL)
+      from = *srcRect;
+
+    if (dstRect != NULL)
+      to = *dstRect;
+
+    if (filter != ScaleFilters::Nearest)
+      {
+	this->blitFiltered(from, dst, to, filter);
+
+	if (dstRect != NULL)
+	  *dstRect = to;
+
+	return;
+      }
+
+    const SDL_Rect& clip = target->clip_rect;
+
+    // Scaling after clipping is left to SDL
+    const bool inside = from.x >= 0 && from.y >= 0 && from.w > 0 && from.h > 0
+      && from.x + from.w <= m_surface->w && from.y + from.h <= m_surface->h
+      && to.x >= clip.x && to.y >= clip.y && to.w > 0 && to.h > 0
+      && to.x + to.w <= clip.x + clip.w && to.y + to.h <= clip.y + clip.h;
+
+    const bool blend = inside && this->isBlendableOnto(dst);
+    const bool copy  = inside && !blend && m_surface->format->BytesPerPixel == 4
+      && this->isCopyableOnto(dst) && Blitter::isParallel(to.w, to.h);
+
+    if (!blend && !copy)
+      {
+	if (SDL_BlitScaled(m_surface, srcRect, target, &to) != 0)
+	  throw Error(SDL_GetError());
+
+	if (dstRect != NULL)
+	  *dstRect = to;
+
+	dst.modified(to);
+	return;
+      }
+
+    Blitter::scale(static_cast<const Uint8*>(m_surface->pixels) + from.y * m_surface->pitch + from.x * 4,
+		   m_surface->pitch, from.w, from.h,
+		   static_cast<Uint8*>(target->pixels) + to.y * target->pitch + to.x * 4,
+		   target->pitch, to.w, to.h,
+		   blend);
+
+    dst.modified(to);
+  }
+
+  void Surface::blitFiltered(SDL_Rect from, Surface& dst, SDL_Rect& to, ScaleFilters filter)
+  {
+    SDL_Surface* target = dst.toSDL();
+
+    // Source clipped to the surface, the destination following in proportion
+    const SDL_Rect bounds = {0, 0, m_surface->w, m_surface->h};
+    SDL_Rect       inside;
+
+    if (from.w <= 0 || from.h <= 0 || to.w <= 0 || to.h <= 0
+	|| !SDL_IntersectRect(&from, &bounds, &inside))
+      {
+	to.w = to.h = 0;
+	return;
+      }
+
+    to.x += Sint64(inside.x - from.x) * to.w / from.w;
+    to.y += Sint64(inside.y - from.y) * to.h / from.h;
+    to.w  = std::max<Sint64>(Sint64(inside.w) * to.w / from.w, 1);
+    to.h  = std::max<Sint64>(Sint64(inside.h) * to.h / from.h, 1);
+    from  = inside;
+
+    const SDL_Rect& clip = target->clip_rect;
+
+    const bool unclipped = to.x >= clip.x && to.y >= clip.y
+      && to.x + to.w <= clip.x + clip.w && to.y + to.h <= clip.y + clip.h;
+
+    const bool blend = this->isBlendableOnto(dst);
+
+    if (unclipped && m_surface->format->BytesPerPixel == 4
+	&& (blend || this->isCopyableOnto(dst)))
+      {
+	Blitter::scale(static_cast<const Uint8*>(m_surface->pixels) + from.y * m_surface->pitch + from.x * 4,
+		       m_surface->pitch, from.w, from.h,
+		       static_cast<Uint8*>(target->pixels) + to.y * target->pitch + to.x * 4,
+		       target->pitch, to.w, to.h,
+		       blend, filter);
+
+	dst.modified(to);
+	return;
+      }
+
+    // Otherwise filtered to ARGB8888, which SDL blits as the surface would be
+    Uint32 key;
+
+    const bool keyed = SDL_GetColorKey(m_surface, &key) == 0;
+
+    SDL_Surface* source = m_surface;
+
+    // Converting turns the color key into transparent pixels, and
+    // decodes RLE surfaces whose pixels can't be read directly
+    if (keyed || SDL_MUSTLOCK(m_surface)
+	|| m_surface->format->format != SDL_PIXELFORMAT_ARGB8888)
+      source = SDL_ConvertSurfaceFormat(m_surface, SDL_PIXELFORMAT_ARGB8888, 0);
+
+    if (source == nullptr)
+      throw Error(SDL_GetError());
+
+    SDL_Surface* scaled = createSurface(to.w, to.h, SDL_PIXELFORMAT_ARGB8888);
+
+    if (scaled == nullptr)
+      {
+	if (source != m_surface)
+	  SDL_FreeSurface(source);
+
+	throw Error(SDL_GetError());
+      }
+
+    Blitter::scale(static_cast<const Uint8*>(source->pixels) + from.y * source->pitch + from.x * 4,
+		   source->pitch, from.w, from.h,
+		   scaled->pixels, scaled->pitch, to.w, to.h,
+		   false, filter);
+
+    if (source != m_surface)
+      SDL_FreeSurface(source);
+
+    SDL_BlendMode mode;
+    Uint8 r, g, b, a;
+
+    SDL_GetSurfaceBlendMode(m_surface, &mode);
+    SDL_GetSurfaceColorMod(m_surface, &r, &g, &b);
+    SDL_GetSurfaceAlphaMod(m_surface, &a);
+
+    SDL_SetSurfaceBlendMode(scaled, keyed ? SDL_BLENDMODE_BLEND : mode);
+    SDL_SetSurfaceColorMod(scaled, r, g, b);
+    SDL_SetSurfaceAlphaMod(scaled, a);
+
+    const int result = SDL_BlitSurface(scaled, NULL, target, &to);
+
+    SDL_FreeSurface(scaled);
+
+    if (result != 0)
+      throw Error(SDL_GetError());
+
+    dst.modified(to);
+  }
+
+  void Surface::fillTo(const SDL_Rect* rect, Uint32 color)
+  {
+    SDL_Rect area = m_surface->clip_rect;
+
+    if (rect != NULL && !SDL_IntersectRect(rect, &m_surface->clip_rect, &area))
+      return;
+
+    if (SDL_MUSTLOCK(m_surface) || m_surface->pixels == nullptr
+	|| !Blitter::isParallel(area.w, area.h))
+      {
+	if (SDL_FillRect(m_surface, rect, color) != 0)
+	  throw Error(SDL_GetError());
+
+	this->modified(area);
+	return;
+      }
+
+    const int bytes = m_surface->format->BytesPerPixel;
+
+    Blitter::fill(static_cast<Uint8*>(m_surface->pixels) + area.y * m_surface->pitch + area.x * bytes,
+		  m_surface->pitch, bytes, area.w, area.h, color);
+
+    this->modified(area);
+  }
+
+  void Surface::modified(const SDL_Rect&)
+  {
+  }
+
+  bool Surface::isBlendableOnto(const Surface& dst) const
+  {
+    const SDL_Surface* target = dst.toSDL();
+
+    if (m_surface == target
+	|| m_surface->format->format != SDL_PIXELFORMAT_ARGB8888
+	|| (target->format->format != SDL_PIXELFORMAT_ARGB8888
+	    && target->format->format != SDL_PIXELFORMAT_RGB888))
+      return false;
+
+    return isPlain(m_surface, SDL_BLENDMODE_BLEND)
+      && !SDL_MUSTLOCK(target) && !target->locked;
+  }
+
+  bool Surface::isCopyableOnto(const Surface& dst) const
+  {
+    const SDL_Surface* target = dst.toSDL();
+
+    // Indexed pixels would need their palettes mapped
+    if (m_surface == target
+	|| m_surface->format->format != target->format->format
+	|| m_surface->format->palette != nullptr)
+      return false;
+
+    return isPlain(m_surface, SDL_BLENDMODE_NONE)
+      && !SDL_MUSTLOCK(target) && !target->locked;
+  }
+
+  void Surface::adopt(SDL_Surface* loaded, const Surface* const stretch)
+  {
+    if (stretch == nullptr)
+      {
+	m_surface = loaded;
+	return;
+      }
+
+    const SDL_PixelFormat* format = stretch->toSDL()->format;
+
+    Uint32 key;
+
+    // SDL turns color keys into alpha, and converts the other formats
+    if (Blitter::canConvert(static_cast<PixelFormats>(loaded->format->format),
+			    static_cast<PixelFormats>(format->format))
+	&& SDL_GetColorKey(loaded, &key) != 0 && !SDL_MUSTLOCK(loaded))
+      {
+	m_surface = createSurface(loaded->w, loaded->h, format->format);
+
+	if (m_surface != nullptr)
+	  {
+	    Blitter::convert(loaded->pixels, loaded->pitch,
+			     static_cast<PixelFormats>(loaded->format->format),
+			     m_surface->pixels, m_surface->pitch,
+			     static_cast<PixelFormats>(format->format),
+			     loaded->w, loaded->h);
+
+	    // As SDL_ConvertSurface, blended only when both formats have alpha
+	    SDL_SetSurfaceBlendMode(m_surface,
+				    loaded->format->Amask != 0 && format->Amask != 0 ?
+				    SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+	  }
+      }
+    else
+      {
+	m_surface = SDL_ConvertSurface(loaded, stretch->toSDL()->format, 0);
+      }
+
+    SDL_FreeSurface(loaded);
+
+    if (m_surface == nullptr)
+      {
+	throw Error(SDL_GetError());
+      }
+  }
+
 }
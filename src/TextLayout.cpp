@@ -0,0 +1,334 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextLayout.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#ifdef _SDL_TTF_H
+
+namespace SO
+{
+
+  // Public methods of class TextLayout
+
+  /* Constructor/destructor */
+
+  TextLayout::TextLayout(std::size_t capacity)
+    : m_capacity(capacity),
+      m_hits(0),
+      m_misses(0)
+  {
+
+  }
+
+  /* Methods */
+
+  std::shared_ptr<const TextLayout::Layout> TextLayout::layout(TTF_Font* font,
+							       const std::string& text,
+							       int wrapWidth,
+							       Align align)
+  {
+    Key key {font,
+	     TTF_GetFontStyle(font),
+	     TTF_GetFontHinting(font),
+	     TTF_GetFontOutline(font),
+	     TTF_GetFontKerning(font),
+	     std::max(wrapWidth, 0),
+	     align,
+	     text};
+
+    auto found = m_entries.find(key);
+
+    if (found != m_entries.end())
+    {
+      ++m_hits;
+      m_uses.splice(m_uses.end(), m_uses, found->second.use);
+
+      return found->second.layout;
+    }
+
+    ++m_misses;
+
+    auto layout = std::make_shared<Layout>();
+
+    this->compute(key, font, *layout);
+
+    if (m_capacity == 0)
+      return layout;
+
+    this->evict(m_capacity - 1);
+
+    m_uses.push_back(key);
+    m_entries.emplace(std::move(key), Entry {layout, std::prev(m_uses.end())});
+
+    return layout;
+  }
+
+  Pair<int> TextLayout::measure(TTF_Font* font, const std::string& text, int wrapWidth)
+  {
+    const std::shared_ptr<const Layout> measured = this->layout(font, text, wrapWidth);
+
+    return Pair<int>(measured->width, measured->height);
+  }
+
+  TextLayout& TextLayout::clear()
+  {
+    m_entries.clear();
+    m_uses.clear();
+    m_advances.clear();
+
+    return *this;
+  }
+
+  std::size_t TextLayout::getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  Uint32 TextLayout::getHits() const
+  {
+    return m_hits;
+  }
+
+  Uint32 TextLayout::getMisses() const
+  {
+    return m_misses;
+  }
+
+  TextLayout& TextLayout::setCapacity(std::size_t capacity)
+  {
+    m_capacity = capacity;
+
+    this->evict(capacity);
+
+    return *this;
+  }
+
+  // Private methods of class TextLayout
+
+  bool TextLayout::Key::operator==(const Key& other) const
+  {
+    return font      == other.font
+      &&   style     == other.style
+      &&   hinting   == other.hinting
+      &&   outline   == other.outline
+      &&   kerning   == other.kerning
+      &&   wrapWidth == other.wrapWidth
+      &&   align     == other.align
+      &&   text      == other.text;
+  }
+
+  std::size_t TextLayout::KeyHash::operator()(const Key& key) const
+  {
+    std::size_t hash = std::hash<std::string>()(key.text);
+
+    const std::size_t fields[] = {std::hash<const TTF_Font*>()(key.font),
+				  static_cast<std::size_t>(key.style),
+				  static_cast<std::size_t>(key.hinting),
+				  static_cast<std::size_t>(key.outline),
+				  static_cast<std::size_t>(key.kerning),
+				  static_cast<std::size_t>(key.wrapWidth),
+				  static_cast<std::size_t>(key.align)};
+
+    // boost::hash_combine
+    for (std::size_t field : fields)
+      hash ^= field + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+
+    return hash;
+  }
+
+  void TextLayout::compute(const Key& key, TTF_Font* font, Layout& layout)
+  {
+    const std::size_t none = static_cast<std::size_t>(-1);
+
+    std::vector<Glyph>& glyphs = layout.glyphs;
+    std::vector<Line>&  lines  = layout.lines;
+
+    glyphs.reserve(key.text.size());
+
+    const char* it  = key.text.data();
+    const char* end = key.text.data() + key.text.size();
+
+    int         pen       = 0;
+    std::size_t lineStart = 0;
+
+    // Last place the line can be broken at, before a run of spaces
+    std::size_t breakAt  = none;
+    int         breakPen = 0;
+
+    Uint16 previous = 0;
+
+    // Ends the current line before glyph index last
+    auto endLine = [&](std::size_t last, int width)
+      {
+	lines.push_back(Line {lineStart, last - lineStart, width});
+
+	lineStart = last;
+	breakAt   = none;
+      };
+
+    // Width of the current line, trailing spaces excluded
+    auto lineWidth = [&]()
+      {
+	return previous == ' ' ? breakPen : pen;
+      };
+
+    while (it != end)
+    {
+      const Uint16 codepoint = nextCodepoint(it, end);
+
+      if (codepoint == '\n')
+      {
+	endLine(glyphs.size(), lineWidth());
+
+	pen      = 0;
+	previous = 0;
+	continue;
+      }
+
+      const int advance = this->advance(font, key, codepoint);
+      int       kerning = previous != 0 ? getKerning(font, previous, codepoint) : 0;
+
+      if (key.wrapWidth > 0 && codepoint != ' ' && pen + kerning + advance > key.wrapWidth)
+      {
+	// Leading spaces don't make a line of their own
+	if (breakAt != none && breakAt != lineStart)
+	{
+	  // Move the word being written to the next line
+	  const int shift = breakAt < glyphs.size() ? glyphs[breakAt].x : pen;
+
+	  endLine(breakAt, breakPen);
+
+	  for (std::size_t i = lineStart; i < glyphs.size(); ++i)
+	    glyphs[i].x -= shift;
+
+	  pen -= shift;
+
+	  if (lineStart == glyphs.size())
+	  {
+	    previous = 0;
+	    kerning  = 0;
+	  }
+	}
+
+	// A word wider than the line is broken between characters
+	if (pen + kerning + advance > key.wrapWidth && glyphs.size() > lineStart)
+	{
+	  endLine(glyphs.size(), pen);
+
+	  pen      = 0;
+	  previous = 0;
+	  kerning  = 0;
+	}
+      }
+
+      if (codepoint == ' ')
+      {
+	if (previous != ' ')
+	{
+	  breakAt  = glyphs.size();
+	  breakPen = pen;
+	}
+
+	pen     += kerning + advance;
+	previous = codepoint;
+	continue;
+      }
+
+      pen += kerning;
+
+      if (codepoint != '\t' && codepoint != '\r')
+	glyphs.push_back(Glyph {codepoint, pen, 0});
+
+      pen     += advance;
+      previous = codepoint;
+    }
+
+    endLine(glyphs.size(), lineWidth());
+
+    // Place the lines
+    layout.width = 0;
+
+    for (const Line& line : lines)
+      layout.width = std::max(layout.width, line.width);
+
+    const int box      = key.wrapWidth > 0 ? key.wrapWidth : layout.width;
+    const int lineSkip = TTF_FontLineSkip(font);
+
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+      int offset = 0;
+
+      if (key.align == Align::Center)
+	offset = (box - lines[i].width) / 2;
+      else if (key.align == Align::Right)
+	offset = box - lines[i].width;
+
+      for (std::size_t j = lines[i].first; j < lines[i].first + lines[i].count; ++j)
+      {
+	glyphs[j].x += offset;
+	glyphs[j].y  = static_cast<int>(i) * lineSkip;
+      }
+    }
+
+    layout.height = static_cast<int>(lines.size() - 1) * lineSkip + TTF_FontHeight(font);
+  }
+
+  int TextLayout::advance(TTF_Font* font, const Key& key, Uint16 codepoint)
+  {
+    std::unordered_map<Uint64, int>& advances = m_advances[font];
+
+    // Kerning doesn't change advances
+    const Uint64 id = static_cast<Uint64>(static_cast<Uint16>(key.outline)) << 40
+      | static_cast<Uint64>(key.hinting & 0xFF) << 32
+      | static_cast<Uint64>(key.style & 0xFFFF) << 16
+      | codepoint;
+
+    auto found = advances.find(id);
+
+    if (found != advances.end())
+      return found->second;
+
+    int advance;
+
+    if (TTF_GlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance) != 0)
+      throw Error(TTF_GetError());
+
+    advances.emplace(id, advance);
+
+    return advance;
+  }
+
+  void TextLayout::evict(std::size_t limit)
+  {
+    while (m_entries.size() > limit)
+    {
+      m_entries.erase(m_uses.front());
+      m_uses.pop_front();
+    }
+  }
+
+}
+
+#endif // _SDL_TTF_H
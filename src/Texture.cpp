@@ -29,6 +29,7 @@
 
 #include "Texture.hpp"
 #include "Renderer.hpp"
+#include "AssetPack.hpp"
 
 namespace SO
 {
@@ -45,6 +46,8 @@ namespace SO
 
     : m_texture(nullptr)
   {
+    TextureMemory::reserve(TextureMemory::getBytes(width, height, format));
+
     m_texture = SDL_CreateTexture(renderer.toSDL(),
                                   static_cast<Uint32>(format),
                                   static_cast<Uint32>(access),
@@ -52,8 +55,53 @@ namespace SO
 
     if (m_texture == nullptr)
       throw Error(SDL_GetError());
+
+    this->query();
   }
   
+  Texture::Texture(Renderer& renderer, Surface& surface)
+    : m_texture(nullptr)
+  {
+    TextureMemory::reserve(TextureMemory::getBytes(surface.toSDL()->w, surface.toSDL()->h,
+						   PixelFormats::Unknown));
+
+    m_texture = SDL_CreateTextureFromSurface(renderer.toSDL(), surface.toSDL());
+
+    if (m_texture == nullptr)
+      throw Error(SDL_GetError());
+
+    this->query();
+  }
+
+  Texture::Texture(Renderer& renderer, const BakedImage& image)
+    : m_texture(nullptr)
+  {
+    const Uint32 format = static_cast<Uint32>(image.getFormat());
+
+    TextureMemory::reserve(TextureMemory::getBytes(image.getWidth(), image.getHeight(),
+						   image.getFormat()));
+
+    m_texture = SDL_CreateTexture(renderer.toSDL(),
+				  format,
+				  SDL_TEXTUREACCESS_STATIC,
+				  image.getWidth(),
+				  image.getHeight());
+
+    if (m_texture == nullptr)
+      throw Error(SDL_GetError());
+
+    if (SDL_UpdateTexture(m_texture, nullptr, image.getPixels(), image.getPitch()) != 0)
+    {
+      SDL_DestroyTexture(m_texture);
+      throw Error(SDL_GetError());
+    }
+
+    if (SDL_ISPIXELFORMAT_ALPHA(format))
+      SDL_SetTextureBlendMode(m_texture, SDL_BLENDMODE_BLEND);
+
+    this->query();
+  }
+
 #ifdef _SDL_IMAGE_H
   Texture::Texture(Renderer& renderer,
 		   const char* file,
@@ -62,6 +110,15 @@ namespace SO
   {
     this->loadFromFile(renderer, file, colorKeying);
   }
+
+  Texture::Texture(Renderer& renderer,
+		   const AssetPack& pack,
+		   const std::string& name,
+		   const Color& colorKeying)
+    : m_texture(nullptr)
+  {
+    this->loadFromPack(renderer, pack, name, colorKeying);
+  }
 #endif
 
 #ifdef _SDL_TTF_H
@@ -75,20 +132,56 @@ namespace SO
   }
 #endif
   
+  Texture::Texture(Texture&& orig) noexcept
+    : m_texture(orig.m_texture),
+      m_width(orig.m_width),
+      m_height(orig.m_height),
+      m_format(orig.m_format),
+      m_access(orig.m_access),
+      m_bytes(orig.m_bytes),
+      m_category(orig.m_category)
+  {
+    orig.m_texture = nullptr;
+    orig.m_width   = 0;
+    orig.m_height  = 0;
+    orig.m_bytes   = 0;
+  }
+
   Texture::~Texture() 
   {
     free();
   }
 
+  /* operators */
+
+  Texture& Texture::operator =(Texture&& orig) noexcept
+  {
+    if (this != &orig)
+    {
+      this->free();
+
+      m_texture  = orig.m_texture;
+      m_width    = orig.m_width;
+      m_height   = orig.m_height;
+      m_format   = orig.m_format;
+      m_access   = orig.m_access;
+      m_bytes    = orig.m_bytes;
+      m_category = orig.m_category;
+
+      orig.m_texture = nullptr;
+      orig.m_width   = 0;
+      orig.m_height  = 0;
+      orig.m_bytes   = 0;
+    }
+
+    return *this;
+  }
+
   /* get methods */
 
   TextureAccess Texture::getAccess() const
   {
-    int access;
-
-    if (SDL_QueryTexture(m_texture, NULL, &access, NULL, NULL) != 0)
-      throw Error(SDL_GetError());
-    return static_cast<TextureAccess>(access);
+    return m_access;
   }
 
 
@@ -122,36 +215,31 @@ namespace SO
   }
 
 
-  PixelFormats Texture::getFormat() const
+  std::size_t Texture::getBytes() const
   {
-    Uint32 format = 0;
+    return m_bytes;
+  }
 
-    if (SDL_QueryTexture(m_texture, &format, NULL, NULL, NULL) != 0)
-      throw Error(SDL_GetError());
+  std::string Texture::getCategory() const
+  {
+    return TextureMemory::getCategoryName(m_category);
+  }
 
-    return static_cast<PixelFormats>(format);
+  PixelFormats Texture::getFormat() const
+  {
+    return m_format;
   }
 
 
   int Texture::getHeight() const 
   {
-    int height = 0;
-
-    if (SDL_QueryTexture(m_texture, NULL, NULL, NULL, &height) != 0)
-      throw Error(SDL_GetError());
-
-    return height;
+    return m_height;
   }
 
 
   int Texture::getWidth() const 
   {
-    int width = 0;
-
-    if (SDL_QueryTexture(m_texture, NULL, NULL, &width, NULL) != 0)
-      throw Error(SDL_GetError());
-
-    return width;
+    return m_width;
   }
 
 
@@ -169,6 +257,21 @@ namespace SO
     return *this;
   }
 
+  Texture& Texture::setCategory(const std::string& category)
+  {
+    const TextureMemory::Category index = TextureMemory::getCategory(category);
+
+    if (m_texture != nullptr && index != m_category)
+    {
+      TextureMemory::release(m_bytes, m_category);
+      TextureMemory::acquire(m_bytes, index);
+    }
+
+    m_category = index;
+
+    return *this;
+  }
+
   Texture& Texture::setColorMod(const Color& color)
   {
     if (SDL_SetTextureColorMod(m_texture, color.getRed(), color.getGreen(), color.getBlue()) != 0)
@@ -192,27 +295,23 @@ namespace SO
     {
       throw Error(IMG_GetError());
     }
-    else
-    {
-      this->free();
 
-      if (colorKeying != Color {0, 0, 0, 0})
-	SDL_SetColorKey(loadedSurface,
-			SDL_TRUE,
-			SDL_MapRGB(loadedSurface->format,
-				   colorKeying.getRed(),
-				   colorKeying.getGreen(), 
-				   colorKeying.getBlue()));
+    this->loadFromSurface(renderer, loadedSurface, colorKeying);
+
+    return *this;
+  }
 
-      m_texture = SDL_CreateTextureFromSurface(renderer.toSDL(),
-					       loadedSurface);
-      SDL_FreeSurface(loadedSurface);
+  Texture& Texture::loadFromPack(Renderer& renderer,
+				 const AssetPack& pack,
+				 const std::string& name,
+				 const Color& colorKeying)
+  {
+    SDL_Surface* loadedSurface = IMG_Load_RW(pack.open(name), 1);
 
-      if (m_texture == nullptr)
-      {
-	throw Error(SDL_GetError());
-      }
-    }
+    if (loadedSurface == nullptr)
+      throw Error(IMG_GetError());
+
+    this->loadFromSurface(renderer, loadedSurface, colorKeying);
 
     return *this;
   }
@@ -234,6 +333,9 @@ namespace SO
     {
       this->free();
 
+      TextureMemory::reserve(TextureMemory::getBytes(textSurface->w, textSurface->h,
+						     PixelFormats::Unknown));
+
       m_texture = SDL_CreateTextureFromSurface(render.toSDL(), textSurface);
       
       SDL_FreeSurface(textSurface);
@@ -242,12 +344,25 @@ namespace SO
       {
 	throw Error(SDL_GetError());
       }      
+
+      this->query();
     }
 
     return *this;
   }
 #endif
 
+  Texture& Texture::lock(const Rect* rect, void** pixels, int* pitch)
+  {
+    // Deferred copies from the texture sample it when flushed
+    Renderer::modifying(m_texture);
+
+    if (SDL_LockTexture(m_texture, (const SDL_Rect*)rect, pixels, pitch) != 0)
+      throw Error(SDL_GetError());
+
+    return *this;
+  }
+
   const SDL_Texture* Texture::toSDL() const
   {
     return m_texture;
@@ -258,15 +373,69 @@ namespace SO
     return m_texture;
   }
 
+  Texture& Texture::unlock()
+  {
+    SDL_UnlockTexture(m_texture);
+
+    return *this;
+  }
+
   // Private methods of class CTexture
 
   void Texture::free()
   {
     if (m_texture != nullptr)
     {
+      Renderer::release(m_texture);
       SDL_DestroyTexture(m_texture);
+      TextureMemory::release(m_bytes, m_category);
+
       m_texture = nullptr;
+      m_width   = 0;
+      m_height  = 0;
+      m_bytes   = 0;
     }
   }
 
+  void Texture::query()
+  {
+    Uint32 format = 0;
+    int    access = 0;
+
+    if (SDL_QueryTexture(m_texture, &format, &access, &m_width, &m_height) != 0)
+      throw Error(SDL_GetError());
+
+    m_format = static_cast<PixelFormats>(format);
+    m_access = static_cast<TextureAccess>(access);
+
+    // Called once per created texture, free() was called before if needed
+    m_bytes    = TextureMemory::getBytes(m_width, m_height, m_format);
+    m_category = TextureMemory::getCurrent();
+
+    TextureMemory::acquire(m_bytes, m_category);
+  }
+
+  void Texture::loadFromSurface(Renderer& renderer, SDL_Surface* loaded, const Color& colorKeying)
+  {
+    this->free();
+
+    TextureMemory::reserve(TextureMemory::getBytes(loaded->w, loaded->h, PixelFormats::Unknown));
+
+    if (colorKeying != Color {0, 0, 0, 0})
+      SDL_SetColorKey(loaded,
+		      SDL_TRUE,
+		      SDL_MapRGB(loaded->format,
+				 colorKeying.getRed(),
+				 colorKeying.getGreen(),
+				 colorKeying.getBlue()));
+
+    m_texture = SDL_CreateTextureFromSurface(renderer.toSDL(), loaded);
+    SDL_FreeSurface(loaded);
+
+    if (m_texture == nullptr)
+      throw Error(SDL_GetError());
+
+    this->query();
+  }
+
 }
@@ -0,0 +1,234 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextureAtlas.hpp"
+#include "Renderer.hpp"
+
+#include <algorithm>
+
+namespace SO
+{
+
+  // Public methods of class TextureAtlas
+
+  /* Constructor/destructor */
+
+  TextureAtlas::TextureAtlas(Renderer& renderer,
+			     int pageWidth,
+			     int pageHeight,
+			     int padding)
+    : m_renderer(renderer),
+      m_pageWidth(pageWidth),
+      m_pageHeight(pageHeight),
+      m_padding(padding > 0 ? padding : 0),
+      m_liveArea(0)
+  {
+
+  }
+
+  /* Methods */
+
+  TextureAtlas::Handle TextureAtlas::insert(Surface& surface)
+  {
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface.toSDL(),
+						      SDL_PIXELFORMAT_ARGB8888,
+						      0);
+
+    if (converted == nullptr)
+      throw Error(SDL_GetError());
+
+    Entry added;
+
+    try
+    {
+      added = this->place(m_pages, m_packers, converted->w, converted->h);
+    }
+    catch (...)
+    {
+      SDL_FreeSurface(converted);
+      throw;
+    }
+
+    SDL_LockSurface(converted);
+
+    const int status = SDL_UpdateTexture(m_pages[added.page].toSDL(),
+					 (const SDL_Rect*)&added.src,
+					 converted->pixels,
+					 converted->pitch);
+
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+
+    if (status != 0)
+      throw Error(SDL_GetError());
+
+    m_liveArea += static_cast<Uint64>(added.src.getWidth()) * added.src.getHeight();
+    m_entries.push_back(added);
+
+    return m_entries.size() - 1;
+  }
+
+#ifdef _SDL_IMAGE_H
+  TextureAtlas::Handle TextureAtlas::insert(const char* path)
+  {
+    Surface surface(path);
+
+    return this->insert(surface);
+  }
+#endif
+
+  TextureAtlas& TextureAtlas::remove(Handle handle)
+  {
+    const Entry& removed = this->entry(handle);
+
+    m_liveArea -= static_cast<Uint64>(removed.src.getWidth()) * removed.src.getHeight();
+    m_entries[handle].live = false;
+
+    return *this;
+  }
+
+  AtlasRegion TextureAtlas::get(Handle handle) const
+  {
+    const Entry& found = this->entry(handle);
+
+    return {const_cast<Texture*>(&m_pages[found.page]), found.src};
+  }
+
+  TextureAtlas& TextureAtlas::rebuild()
+  {
+    std::vector<Handle> live;
+
+    for (Handle i = 0; i < m_entries.size(); ++i)
+      if (m_entries[i].live)
+	live.push_back(i);
+
+    // Tallest first packs best on a skyline
+    std::sort(live.begin(), live.end(), [this](Handle a, Handle b)
+	      {
+		return m_entries[a].src.getHeight() > m_entries[b].src.getHeight();
+	      });
+
+    std::deque<Texture>        pages;
+    std::vector<SkylinePacker> packers;
+    std::vector<Entry>         moved(m_entries.size());
+
+    for (Handle handle : live)
+      moved[handle] = this->place(pages, packers,
+				  m_entries[handle].src.getWidth(),
+				  m_entries[handle].src.getHeight());
+
+    // Straight copies, alpha included
+    for (Texture& page : m_pages)
+      page.setBlendMode(BlendModes::Null);
+
+    for (Uint32 page = 0; page < pages.size(); ++page)
+    {
+      m_renderer.pushTarget(pages[page]);
+
+      for (Handle handle : live)
+	if (moved[handle].page == page)
+	  m_renderer.copy(m_pages[m_entries[handle].page],
+			  &m_entries[handle].src,
+			  &moved[handle].src);
+
+      m_renderer.popTarget();
+    }
+
+    for (Handle handle : live)
+      m_entries[handle] = moved[handle];
+
+    m_pages   = std::move(pages);
+    m_packers = std::move(packers);
+
+    return *this;
+  }
+
+  float TextureAtlas::getOccupancy() const
+  {
+    const Uint64 area = static_cast<Uint64>(m_pageWidth) * m_pageHeight * m_pages.size();
+
+    return area != 0 ? static_cast<float>(m_liveArea) / area : 0.0f;
+  }
+
+  Texture& TextureAtlas::getPage(std::size_t index)
+  {
+    return m_pages.at(index);
+  }
+
+  std::size_t TextureAtlas::getPageCount() const
+  {
+    return m_pages.size();
+  }
+
+  // Private methods of class TextureAtlas
+
+  const TextureAtlas::Entry& TextureAtlas::entry(Handle handle) const
+  {
+    if (handle >= m_entries.size() || !m_entries[handle].live)
+      throw Error("Invalid texture atlas handle");
+
+    return m_entries[handle];
+  }
+
+  TextureAtlas::Entry TextureAtlas::place(std::deque<Texture>& pages,
+					  std::vector<SkylinePacker>& packers,
+					  int width, int height)
+  {
+    const int paddedWidth  = width  + 2 * m_padding;
+    const int paddedHeight = height + 2 * m_padding;
+
+    if (paddedWidth > m_pageWidth || paddedHeight > m_pageHeight)
+      throw Error("Image is larger than a texture atlas page");
+
+    Rect room;
+    Uint32 page = 0;
+
+    while (page < packers.size() && !packers[page].insert(paddedWidth, paddedHeight, room))
+      ++page;
+
+    if (page == packers.size())
+    {
+      pages.emplace_back(m_renderer,
+			 m_pageWidth, m_pageHeight,
+			 TextureAccess::Target,
+			 PixelFormats::ARGB8888);
+      pages.back().setBlendMode(BlendModes::Blend);
+      packers.emplace_back(m_pageWidth, m_pageHeight);
+      packers.back().insert(paddedWidth, paddedHeight, room);
+
+      // Padding must be transparent, and a new target holds garbage
+      const Color color = m_renderer.getDrawColor();
+
+      m_renderer.pushTarget(pages.back())
+	.setDrawColor(Color(0, 0, 0, 0))
+	.clear()
+	.setDrawColor(color)
+	.popTarget();
+    }
+
+    return {page,
+	    Rect(room.getX() + m_padding, room.getY() + m_padding,
+		 width, height),
+	    true};
+  }
+
+}
@@ -0,0 +1,160 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextureCache.hpp"
+#include "Renderer.hpp"
+
+namespace SO
+{
+
+  // Public methods of class TextureCache
+
+  /* Constructor/destructor */
+
+  TextureCache::TextureCache(Renderer& renderer, std::size_t budget)
+    : m_renderer(renderer),
+      m_budget(budget),
+      m_bytes(0),
+      m_hits(0),
+      m_misses(0),
+      m_evictions(0)
+  {
+    m_budgetCallback = TextureMemory::addBudgetCallback([this](std::size_t excess)
+      {
+	this->evict(m_bytes > excess ? m_bytes - excess : 0);
+      });
+  }
+
+  TextureCache::~TextureCache()
+  {
+    TextureMemory::removeBudgetCallback(m_budgetCallback);
+  }
+
+  /* Methods */
+
+#ifdef _SDL_IMAGE_H
+  std::shared_ptr<Texture> TextureCache::load(const std::string& path,
+					      const Color& colorKeying)
+  {
+    const Key key(path,
+		  (Uint32)colorKeying.getRed() << 24 |
+		  (Uint32)colorKeying.getGreen() << 16 |
+		  (Uint32)colorKeying.getBlue() << 8 |
+		  (Uint32)colorKeying.getAlpha());
+
+    auto found = m_entries.find(key);
+
+    if (found != m_entries.end())
+    {
+      ++m_hits;
+      m_uses.splice(m_uses.end(), m_uses, found->second.use);
+
+      return found->second.texture;
+    }
+
+    ++m_misses;
+
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>(m_renderer, path.c_str(), colorKeying);
+
+    const std::size_t bytes = texture->getBytes();
+
+    m_uses.push_back(key);
+    m_entries.emplace(key, Entry {texture, bytes, std::prev(m_uses.end())});
+    m_bytes += bytes;
+
+    this->evict(m_budget);
+
+    return texture;
+  }
+#endif
+
+  TextureCache& TextureCache::trim()
+  {
+    this->evict(m_budget);
+
+    return *this;
+  }
+
+  TextureCache& TextureCache::clear()
+  {
+    this->evict(0);
+
+    return *this;
+  }
+
+  std::size_t TextureCache::getBytes() const
+  {
+    return m_bytes;
+  }
+
+  std::size_t TextureCache::getBudget() const
+  {
+    return m_budget;
+  }
+
+  Uint32 TextureCache::getHits() const
+  {
+    return m_hits;
+  }
+
+  Uint32 TextureCache::getMisses() const
+  {
+    return m_misses;
+  }
+
+  Uint32 TextureCache::getEvictions() const
+  {
+    return m_evictions;
+  }
+
+  TextureCache& TextureCache::setBudget(std::size_t budget)
+  {
+    m_budget = budget;
+    this->evict(m_budget);
+
+    return *this;
+  }
+
+  // Private methods of class TextureCache
+
+  void TextureCache::evict(std::size_t limit)
+  {
+    for (auto use = m_uses.begin(); use != m_uses.end() && m_bytes > limit;)
+    {
+      auto entry = m_entries.find(*use);
+
+      // Still held outside the cache
+      if (entry->second.texture.use_count() > 1)
+      {
+	++use;
+	continue;
+      }
+
+      m_bytes -= entry->second.bytes;
+      ++m_evictions;
+
+      m_entries.erase(entry);
+      use = m_uses.erase(use);
+    }
+  }
+
+}
@@ -0,0 +1,242 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextureLoader.hpp"
+#include "Renderer.hpp"
+
+#ifdef _SDL_IMAGE_H
+
+namespace SO
+{
+
+  // Public methods of class TextureLoader::Handle
+
+  TextureLoader::Handle::Handle(std::shared_ptr<State> state)
+    : m_state(std::move(state))
+  {
+
+  }
+
+  bool TextureLoader::Handle::isReady() const
+  {
+    return m_state != nullptr && m_state->texture != nullptr;
+  }
+
+  bool TextureLoader::Handle::hasFailed() const
+  {
+    return m_state != nullptr && m_state->done && m_state->texture == nullptr;
+  }
+
+  Texture& TextureLoader::Handle::get() const
+  {
+    if (m_state == nullptr)
+      throw Error("Empty texture loader handle");
+
+    return m_state->texture != nullptr ? *m_state->texture : *m_state->placeholder;
+  }
+
+  std::shared_ptr<Texture> TextureLoader::Handle::getTexture() const
+  {
+    return m_state != nullptr ? m_state->texture : nullptr;
+  }
+
+  const std::string& TextureLoader::Handle::getError() const
+  {
+    static const std::string none;
+
+    return m_state != nullptr ? m_state->error : none;
+  }
+
+  // Public methods of class TextureLoader
+
+  /* Constructor/destructor */
+
+  TextureLoader::TextureLoader(Renderer& renderer,
+			       std::size_t threads,
+			       std::shared_ptr<Texture> placeholder)
+    : m_renderer(renderer),
+      m_placeholder(std::move(placeholder)),
+      m_pending(0),
+      m_stop(false)
+  {
+    if (m_placeholder == nullptr)
+    {
+      const Uint32 transparent = 0;
+
+      m_placeholder = std::make_shared<Texture>(renderer, 1, 1,
+						TextureAccess::Static,
+						PixelFormats::ARGB8888);
+
+      if (SDL_UpdateTexture(m_placeholder->toSDL(), NULL, &transparent, 4) != 0)
+	throw Error(SDL_GetError());
+
+      m_placeholder->setBlendMode(BlendModes::Blend);
+    }
+
+    for (std::size_t i = 0; i < (threads > 0 ? threads : 1); ++i)
+      m_workers.emplace_back(&TextureLoader::run, this);
+  }
+
+  TextureLoader::~TextureLoader()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_requested.notify_all();
+
+    for (std::thread& worker : m_workers)
+      worker.join();
+  }
+
+  /* Methods */
+
+  TextureLoader::Handle TextureLoader::load(const std::string& path, const Color& colorKeying)
+  {
+    std::shared_ptr<State> state = std::make_shared<State>();
+
+    state->path        = path;
+    state->colorKeying = colorKeying;
+    state->placeholder = m_placeholder;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_requests.push_back(state);
+      ++m_pending;
+    }
+
+    m_requested.notify_one();
+
+    return Handle(state);
+  }
+
+  TextureLoader& TextureLoader::upload(double milliseconds, std::size_t bytes)
+  {
+    const Uint64 start     = SDL_GetPerformanceCounter();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    std::size_t uploaded = 0;
+
+    for (bool first = true;; first = false)
+    {
+      if (!first)
+      {
+	const double elapsed = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+	if (elapsed >= milliseconds || (bytes != 0 && uploaded >= bytes))
+	  break;
+      }
+
+      Decoded decoded;
+
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_decoded.empty())
+	  break;
+
+	decoded = std::move(m_decoded.front());
+	m_decoded.pop_front();
+	--m_pending;
+      }
+
+      State& state = *decoded.state;
+
+      state.done  = true;
+      state.error = std::move(decoded.error);
+
+      if (decoded.surface == nullptr)
+	continue;
+
+      try
+      {
+	state.texture = std::make_shared<Texture>(m_renderer, *decoded.surface);
+	uploaded += static_cast<std::size_t>(decoded.surface->toSDL()->h) * decoded.surface->getPitch();
+      }
+      catch (const Error& error)
+      {
+	state.error = error.what();
+      }
+    }
+
+    return *this;
+  }
+
+  std::size_t TextureLoader::getPending() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_pending;
+  }
+
+  // Private methods of class TextureLoader
+
+  void TextureLoader::run()
+  {
+    for (;;)
+    {
+      Decoded decoded;
+
+      {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_requested.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+
+	if (m_stop)
+	  return;
+
+	decoded.state = std::move(m_requests.front());
+	m_requests.pop_front();
+      }
+
+      // The path and color key never change once requested, the rest of
+      // the state is left to the rendering thread
+      const State& state = *decoded.state;
+
+      SDL_Surface* surface = IMG_Load(state.path.c_str());
+
+      if (surface == nullptr)
+	decoded.error = IMG_GetError();
+      else
+      {
+	// Same keying as Texture::loadFromFile
+	const Color& key = state.colorKeying;
+
+	if (key != Color {0, 0, 0, 0})
+	  SDL_SetColorKey(surface, SDL_TRUE,
+			  SDL_MapRGB(surface->format, key.getRed(), key.getGreen(), key.getBlue()));
+
+	decoded.surface.reset(new Surface(surface));
+      }
+
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_decoded.push_back(std::move(decoded));
+      }
+    }
+  }
+
+}
+
+#endif // _SDL_IMAGE_H
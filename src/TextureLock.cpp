@@ -0,0 +1,117 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextureLock.hpp"
+#include "Renderer.hpp"
+
+namespace SO
+{
+
+  // Public methods of class TextureLock
+
+  /* Constructor/destructor */
+
+  TextureLock::TextureLock(Texture& texture)
+    : m_texture(&texture),
+      m_pixels(nullptr),
+      m_pitch(0),
+      m_width(texture.getWidth()),
+      m_height(texture.getHeight()),
+      m_format(texture.getFormat())
+  {
+    texture.lock(nullptr, &m_pixels, &m_pitch);
+  }
+
+  TextureLock::TextureLock(Texture& texture, const Rect& rect)
+    : m_texture(&texture),
+      m_pixels(nullptr),
+      m_pitch(0),
+      m_width(rect.getWidth()),
+      m_height(rect.getHeight()),
+      m_format(texture.getFormat())
+  {
+    texture.lock(&rect, &m_pixels, &m_pitch);
+  }
+
+  TextureLock::TextureLock(TextureLock&& orig)
+    : m_texture(orig.m_texture),
+      m_pixels(orig.m_pixels),
+      m_pitch(orig.m_pitch),
+      m_width(orig.m_width),
+      m_height(orig.m_height),
+      m_format(orig.m_format)
+  {
+    orig.m_texture = nullptr;
+    orig.m_pixels  = nullptr;
+  }
+
+  TextureLock::~TextureLock()
+  {
+    if (m_texture != nullptr)
+      m_texture->unlock();
+  }
+
+  // Public methods of class StreamingTexture
+
+  /* Constructor/destructor */
+
+  StreamingTexture::StreamingTexture(Renderer& renderer,
+				     int width,
+				     int height,
+				     PixelFormats format)
+    : m_textures {Texture(renderer, width, height, TextureAccess::Streaming, format),
+		  Texture(renderer, width, height, TextureAccess::Streaming, format)},
+      m_front(0)
+  {
+
+  }
+
+  /* Methods */
+
+  TextureLock StreamingTexture::lock()
+  {
+    return TextureLock(this->getBack());
+  }
+
+  TextureLock StreamingTexture::lock(const Rect& rect)
+  {
+    return TextureLock(this->getBack(), rect);
+  }
+
+  StreamingTexture& StreamingTexture::swap()
+  {
+    m_front = 1 - m_front;
+
+    return *this;
+  }
+
+  Texture& StreamingTexture::getBack()
+  {
+    return m_textures[1 - m_front];
+  }
+
+  Texture& StreamingTexture::getFront()
+  {
+    return m_textures[m_front];
+  }
+
+}
@@ -0,0 +1,308 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "TextureMemory.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace SO
+{
+
+  namespace
+  {
+    struct State
+    {
+      std::mutex                                mutex;
+      std::size_t                               live   = 0;
+      std::size_t                               peak   = 0;
+      std::size_t                               count  = 0;
+      std::size_t                               budget = 0;
+
+      std::vector<std::string>                  names = {"default"};
+      std::vector<std::size_t>                  categories = {0};
+
+      std::vector<std::pair<TextureMemory::Handle,
+			    TextureMemory::Callback>> callbacks;
+      TextureMemory::Handle                     next = 0;
+    };
+
+    // Built on first use, textures may outlive static objects of other units
+    State& state()
+    {
+      static State* instance = new State();
+
+      return *instance;
+    }
+
+    thread_local TextureMemory::Category current   = 0;
+    thread_local bool                    reserving = false;
+  }
+
+  // Public methods of class TextureMemory::Scope
+
+  /* Constructor/destructor */
+
+  TextureMemory::Scope::Scope(const std::string& category)
+    : m_previous(current)
+  {
+    current = TextureMemory::getCategory(category);
+  }
+
+  TextureMemory::Scope::~Scope()
+  {
+    current = m_previous;
+  }
+
+  // Public methods of class TextureMemory
+
+  /* Methods */
+
+  std::size_t TextureMemory::getBytes(int width, int height, PixelFormats format)
+  {
+    const Uint32      value = static_cast<Uint32>(format);
+    const std::size_t w     = std::max(width, 0);
+    const std::size_t h     = std::max(height, 0);
+
+    switch (format)
+    {
+    case PixelFormats::Unknown:
+      return w * h * 4;
+
+    // Planar, full luma and quarter chroma planes
+    case PixelFormats::YV12:
+    case PixelFormats::IYUV:
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+    case PixelFormats::NV12:
+    case PixelFormats::NV21:
+#endif
+      return w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+
+    // Packed, 4 bytes for every 2 pixels
+    case PixelFormats::YUY2:
+    case PixelFormats::UYVY:
+    case PixelFormats::YVYU:
+      return (w + 1) / 2 * 4 * h;
+
+    default:
+      return (w * SDL_BITSPERPIXEL(value) + 7) / 8 * h;
+    }
+  }
+
+  std::size_t TextureMemory::getLive()
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    return state().live;
+  }
+
+  std::size_t TextureMemory::getLive(const std::string& category)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto found = std::find(s.names.begin(), s.names.end(), category);
+
+    return found != s.names.end() ? s.categories[found - s.names.begin()] : 0;
+  }
+
+  std::size_t TextureMemory::getPeak()
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    return state().peak;
+  }
+
+  std::size_t TextureMemory::getCount()
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    return state().count;
+  }
+
+  std::map<std::string, std::size_t> TextureMemory::getCategories()
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::map<std::string, std::size_t> categories;
+
+    for (std::size_t i = 0; i < s.names.size(); ++i)
+      categories.emplace(s.names[i], s.categories[i]);
+
+    return categories;
+  }
+
+  std::size_t TextureMemory::getBudget()
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    return state().budget;
+  }
+
+  void TextureMemory::setBudget(std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    state().budget = bytes;
+  }
+
+  void TextureMemory::resetPeak()
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    state().peak = state().live;
+  }
+
+  TextureMemory::Handle TextureMemory::addBudgetCallback(Callback callback)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.callbacks.emplace_back(++s.next, std::move(callback));
+
+    return s.next;
+  }
+
+  void TextureMemory::removeBudgetCallback(Handle handle)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.callbacks.erase(std::remove_if(s.callbacks.begin(), s.callbacks.end(),
+				     [handle](const std::pair<Handle, Callback>& callback)
+				     {
+				       return callback.first == handle;
+				     }),
+		      s.callbacks.end());
+  }
+
+  void TextureMemory::reserve(std::size_t bytes)
+  {
+    // Callbacks releasing memory must not recurse here
+    if (reserving)
+      return;
+
+    State& s = state();
+
+    std::vector<std::pair<Handle, Callback>> callbacks;
+
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+
+      if (s.budget == 0 || s.live + bytes <= s.budget)
+	return;
+
+      callbacks = s.callbacks;
+    }
+
+    reserving = true;
+
+    for (const std::pair<Handle, Callback>& callback : callbacks)
+    {
+      std::size_t excess;
+
+      {
+	std::lock_guard<std::mutex> lock(s.mutex);
+
+	if (s.live + bytes <= s.budget)
+	  break;
+
+	excess = s.live + bytes - s.budget;
+      }
+
+      // Called unlocked, it releases textures
+      try
+      {
+	callback.second(excess);
+      }
+      catch (...)
+      {
+	reserving = false;
+	throw;
+      }
+    }
+
+    reserving = false;
+  }
+
+  TextureMemory::Category TextureMemory::getCategory(const std::string& name)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto found = std::find(s.names.begin(), s.names.end(), name);
+
+    if (found != s.names.end())
+      return found - s.names.begin();
+
+    s.names.push_back(name);
+    s.categories.push_back(0);
+
+    return s.names.size() - 1;
+  }
+
+  std::string TextureMemory::getCategoryName(Category category)
+  {
+    std::lock_guard<std::mutex> lock(state().mutex);
+
+    return category < state().names.size() ? state().names[category] : std::string();
+  }
+
+  TextureMemory::Category TextureMemory::getCurrent()
+  {
+    return current;
+  }
+
+  // Private methods of class TextureMemory
+
+  void TextureMemory::acquire(std::size_t bytes, Category category)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.live += bytes;
+    s.peak  = std::max(s.peak, s.live);
+    s.count++;
+    s.categories[category] += bytes;
+  }
+
+  void TextureMemory::release(std::size_t bytes, Category category)
+  {
+    State& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.live -= bytes;
+    s.count--;
+    s.categories[category] -= bytes;
+  }
+
+}
@@ -70,6 +70,56 @@ namespace SO
   {
     TTF_Quit();
   }
+
+  int getKerning(TTF_Font* font, Uint16 previous, Uint16 codepoint)
+  {
+#if SDL_VERSIONNUM(SDL_TTF_MAJOR_VERSION, SDL_TTF_MINOR_VERSION, SDL_TTF_PATCHLEVEL) >= SDL_VERSIONNUM(2, 0, 14)
+    if (TTF_GetFontKerning(font) != 0)
+      return TTF_GetFontKerningSizeGlyphs(font, previous, codepoint);
+#endif
+
+    return 0;
+  }
 #endif 
 
+  Uint16 nextCodepoint(const char*& text, const char* end)
+  {
+    const Uint8 lead = static_cast<Uint8>(*text++);
+
+    if (lead < 0x80)
+      return lead;
+
+    // Length of the sequence and payload bits of its lead byte
+    int    length;
+    Uint32 codepoint;
+
+    if ((lead & 0xE0) == 0xC0)
+    {
+      length    = 2;
+      codepoint = lead & 0x1F;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+      length    = 3;
+      codepoint = lead & 0x0F;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+      length    = 4;
+      codepoint = lead & 0x07;
+    }
+    else
+      return '?';
+
+    for (int i = 1; i < length; ++i)
+    {
+      if (text == end || (static_cast<Uint8>(*text) & 0xC0) != 0x80)
+	return '?';
+
+      codepoint = codepoint << 6 | (static_cast<Uint8>(*text++) & 0x3F);
+    }
+
+    return codepoint <= 0xFFFF ? static_cast<Uint16>(codepoint) : '?';
+  }
+
 }
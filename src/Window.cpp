@@ -297,4 +297,20 @@ namespace SO
     return *this;
   }
 
+  Window& Window::update(const Rect* rects, std::size_t count)
+  {
+    if (count == 0)
+      return *this;
+
+    if (SDL_UpdateWindowSurfaceRects(m_window, (const SDL_Rect*)rects, count) != 0)
+      throw Error(SDL_GetError());
+
+    return *this;
+  }
+
+  Window& Window::update(const std::vector<Rect>& rects)
+  {
+    return this->update(rects.data(), rects.size());
+  }
+
 }
@@ -0,0 +1,104 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "AssetPack.hpp"
+#include "Surface.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  std::vector<char> readFile(const char* path)
+  {
+    std::vector<char> contents;
+    std::FILE*        file = std::fopen(path, "rb");
+
+    for (int c; file != nullptr && (c = std::fgetc(file)) != EOF;)
+      contents.push_back(static_cast<char>(c));
+
+    if (file != nullptr)
+      std::fclose(file);
+
+    return contents;
+  }
+}
+
+SCENARIO("class SO::AssetPack", "[AssetPack]")
+{
+  GIVEN("A pack of a few files")
+    {
+      SO::AssetPack::pack("assets-test.pack", {"media/x.bmp", "fonts/lazy.ttf", "media/arrow.png"});
+
+      SO::AssetPack pack("assets-test.pack");
+
+      THEN("The entries are sorted by name")
+	{
+	  REQUIRE(pack.getCount() == 3);
+	  REQUIRE(pack.getName(0) == "fonts/lazy.ttf");
+	  REQUIRE(pack.getName(1) == "media/arrow.png");
+	  REQUIRE(pack.getName(2) == "media/x.bmp");
+	}
+      THEN("Each entry is the aligned contents of its file")
+	{
+	  for (const char* name : {"media/x.bmp", "fonts/lazy.ttf", "media/arrow.png"})
+	    {
+	      const std::vector<char>      contents = readFile(name);
+	      const SO::AssetPack::Entry   entry    = pack.get(name);
+
+	      REQUIRE(entry.size == contents.size());
+	      REQUIRE(std::memcmp(entry.data, contents.data(), entry.size) == 0);
+	      REQUIRE(reinterpret_cast<uintptr_t>(entry.data) % 64 == 0);
+	    }
+	}
+      THEN("Missing names are not found")
+	{
+	  REQUIRE_FALSE(pack.contains("media"));
+	  REQUIRE_FALSE(pack.contains("media/x.bmp2"));
+	  REQUIRE_FALSE(pack.contains(""));
+	  REQUIRE_THROWS_AS(pack.get("media/y.bmp"), SO::Error);
+	}
+      WHEN("An image is loaded from the pack")
+	{
+	  SO::Surface packed(pack, "media/x.bmp");
+	  SO::Surface loaded("media/x.bmp");
+
+	  THEN("It is the same as loaded from its file")
+	    {
+	      REQUIRE(packed.toSDL()->w == loaded.toSDL()->w);
+	      REQUIRE(packed.toSDL()->h == loaded.toSDL()->h);
+	    }
+	}
+
+      std::remove("assets-test.pack");
+    }
+  GIVEN("A name packed twice")
+    {
+      THEN("The pack is refused")
+	{
+	  REQUIRE_THROWS_AS(SO::AssetPack::pack("assets-test.pack", {"media/x.bmp", "media/x.bmp"}),
+			    SO::Error);
+	}
+    }
+}
@@ -0,0 +1,219 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "BakedImage.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+SCENARIO("class SO::BakedImage", "[BakedImage]")
+{
+  GIVEN("A 7x3 ARGB8888 surface")
+    {
+      SO::Surface surface(SDL_CreateRGBSurface(0, 7, 3, 32,
+					       0x00FF0000, 0x0000FF00,
+					       0x000000FF, 0xFF000000));
+
+      SDL_Surface* sdl = surface.toSDL();
+
+      for (int y = 0; y < sdl->h; ++y)
+	for (int x = 0; x < sdl->w; ++x)
+	  static_cast<Uint32*>(sdl->pixels)[y * sdl->pitch / 4 + x] = 0x80000000 | y << 8 | x;
+
+      WHEN("It is baked in its own format")
+	{
+	  SO::BakedImage::bake(surface, "baked-test.sobk", SO::PixelFormats::ARGB8888);
+
+	  SO::BakedImage image("baked-test.sobk");
+
+	  THEN("The pixels are loaded untouched")
+	    {
+	      REQUIRE(image.getFormat() == SO::PixelFormats::ARGB8888);
+	      REQUIRE(image.getWidth() == 7);
+	      REQUIRE(image.getHeight() == 3);
+	      REQUIRE(reinterpret_cast<uintptr_t>(image.getPixels()) % 64 == 0);
+
+	      for (int y = 0; y < 3; ++y)
+		REQUIRE(std::memcmp(static_cast<const Uint8*>(image.getPixels()) + y * image.getPitch(),
+				    static_cast<const Uint8*>(sdl->pixels) + y * sdl->pitch,
+				    7 * 4) == 0);
+	    }
+	}
+      WHEN("It is baked in another format")
+	{
+	  SO::BakedImage::bake(surface, "baked-test.sobk", SO::PixelFormats::RGB565);
+
+	  SO::BakedImage image("baked-test.sobk");
+
+	  THEN("The pixels are converted when baking")
+	    {
+	      REQUIRE(image.getFormat() == SO::PixelFormats::RGB565);
+	      REQUIRE(image.getPitch() >= 7 * 2);
+	    }
+	}
+      WHEN("The header of a baked image is corrupted")
+	{
+	  // Overwrite one little endian field of a freshly baked image
+	  auto corrupt = [&](long offset, Uint32 value)
+	    {
+	      SO::BakedImage::bake(surface, "baked-test.sobk", SO::PixelFormats::ARGB8888);
+
+	      const Uint8 bytes[4] = {Uint8(value), Uint8(value >> 8),
+				      Uint8(value >> 16), Uint8(value >> 24)};
+
+	      std::FILE* file = std::fopen("baked-test.sobk", "r+b");
+	      std::fseek(file, offset, SEEK_SET);
+	      std::fwrite(bytes, 1, 4, file);
+	      std::fclose(file);
+	    };
+
+	  THEN("Formats without packed pixels are refused")
+	    {
+	      corrupt(8, SDL_PIXELFORMAT_YV12);
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+
+	      corrupt(8, SDL_PIXELFORMAT_UNKNOWN);
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+	    }
+	  THEN("Sizes that would overflow are refused")
+	    {
+	      corrupt(12, 0x40000000);
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+
+	      corrupt(16, 0xFFFFFFFF);
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+
+	      corrupt(20, 0x80000000);
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+	    }
+	}
+      WHEN("A file isn't a baked image")
+	{
+	  std::FILE* file = std::fopen("baked-test.sobk", "wb");
+	  std::fputs("\x89PNG not baked at all, just long enough", file);
+	  std::fclose(file);
+
+	  THEN("It is refused")
+	    {
+	      REQUIRE_THROWS_AS(SO::BakedImage("baked-test.sobk"), SO::Error);
+	    }
+	}
+
+      std::remove("baked-test.sobk");
+    }
+}
+
+#ifdef _SDL_IMAGE_H
+
+namespace
+{
+  // Drop a file from the page cache, for cold loads
+  void evict(const char* path)
+  {
+#ifdef __linux__
+    const int fd = open(path, O_RDONLY);
+
+    if (fd != -1)
+    {
+      fdatasync(fd);
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+#endif
+  }
+
+  template <typename Load>
+  double milliseconds(const char* path, bool cold, int runs, Load load)
+  {
+    std::chrono::duration<double, std::milli> total(0);
+
+    for (int i = 0; i < runs; ++i)
+    {
+      if (cold)
+	evict(path);
+
+      const auto start = std::chrono::steady_clock::now();
+      load();
+      total += std::chrono::steady_clock::now() - start;
+    }
+
+    return total.count() / runs;
+  }
+}
+
+TEST_CASE("Baked images against IMG_Load", "[.][benchmark]")
+{
+  const char* png   = "media/background.png";
+  const char* baked = "background.sobk";
+
+  SO::initImage(SO::ImageInit::PNG);
+
+  {
+    SO::Surface surface(png);
+
+    SO::BakedImage::bake(surface, baked, SO::PixelFormats::ARGB8888);
+  }
+
+  // Textures are created by a software renderer, no window is needed
+  SO::Surface screen(SDL_CreateRGBSurface(0, 16, 16, 32,
+					  0x00FF0000, 0x0000FF00,
+					  0x000000FF, 0xFF000000));
+  SO::Renderer renderer(screen);
+
+  auto decode = [&]()
+    {
+      SO::Surface surface(IMG_Load(png));
+      SO::Surface converted(SDL_ConvertSurfaceFormat(surface.toSDL(), SDL_PIXELFORMAT_ARGB8888, 0));
+      SO::Texture texture(renderer, converted);
+    };
+
+  auto map = [&]()
+    {
+      SO::BakedImage image(baked);
+      SO::Texture    texture(renderer, image);
+    };
+
+  const int runs = 20;
+
+  std::printf("%-28s %10s %10s\n", "", "cold (ms)", "warm (ms)");
+  std::printf("%-28s %10.3f %10.3f\n", "IMG_Load + convert + upload",
+	      milliseconds(png, true, runs, decode),
+	      milliseconds(png, false, runs, decode));
+  std::printf("%-28s %10.3f %10.3f\n", "BakedImage + upload",
+	      milliseconds(baked, true, runs, map),
+	      milliseconds(baked, false, runs, map));
+
+  std::remove(baked);
+
+  SO::quitImage();
+}
+
+#endif // _SDL_IMAGE_H
@@ -0,0 +1,757 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Blitter.hpp"
+#include "Surface.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+  const SO::Blitter::Kernel kernels[] = {SO::Blitter::Kernel::Scalar,
+					 SO::Blitter::Kernel::SSE2,
+					 SO::Blitter::Kernel::AVX2};
+
+  // Mostly translucent, with runs of transparent and opaque pixels
+  std::vector<Uint32> randomPixels(std::size_t count, std::mt19937& random)
+  {
+    std::vector<Uint32> pixels(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      pixels[i] = random();
+
+      if (i / 16 % 4 == 1)
+	pixels[i] &= 0x00FFFFFF;
+      else if (i / 16 % 4 == 2)
+	pixels[i] |= 0xFF000000;
+    }
+
+    return pixels;
+  }
+
+  SO::Surface* createSurface(int width, int height, Uint32 format)
+  {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, format);
+
+    REQUIRE(surface != nullptr);
+
+    return new SO::Surface(surface);
+  }
+
+  void fill(SO::Surface& surface, std::mt19937& random)
+  {
+    SDL_Surface* sdl = surface.toSDL();
+
+    for (int y = 0; y < sdl->h; ++y)
+    {
+      const std::vector<Uint32> row = randomPixels(sdl->w, random);
+
+      std::copy(row.begin(), row.end(), (Uint32*)((Uint8*)sdl->pixels + y * sdl->pitch));
+    }
+  }
+}
+
+SCENARIO("class SO::Blitter", "[Blitter]")
+{
+  std::mt19937 random(42);
+
+  GIVEN("Random source and destination rows")
+    {
+      const std::vector<Uint32> src = randomPixels(256, random);
+      const std::vector<Uint32> dst = randomPixels(256, random);
+
+      const SO::Blitter::Kernel original = SO::Blitter::getKernel();
+
+      THEN("Every supported kernel gives the result of the scalar one")
+	{
+	  for (SO::Blitter::Kernel kernel : kernels)
+	    {
+	      if (!SO::Blitter::isSupported(kernel))
+		continue;
+
+	      // Odd lengths and misaligned starts exercise the tails
+	      for (std::size_t offset = 0; offset < 5; ++offset)
+		for (std::size_t count : {0, 1, 3, 4, 7, 8, 9, 17, 33, 200})
+		  {
+		    std::vector<Uint32> expected = dst;
+		    std::vector<Uint32> result   = dst;
+
+		    SO::Blitter::setKernel(SO::Blitter::Kernel::Scalar);
+		    SO::Blitter::blendRow(src.data() + offset, expected.data() + offset, count);
+
+		    SO::Blitter::setKernel(kernel);
+		    SO::Blitter::blendRow(src.data() + offset, result.data() + offset, count);
+
+		    REQUIRE(result == expected);
+		  }
+	    }
+
+	  SO::Blitter::setKernel(original);
+	}
+      THEN("The blend is exact at both ends of the alpha range")
+	{
+	  Uint32 transparent = 0x00123456;
+	  Uint32 opaque      = 0xFF123456;
+	  Uint32 half        = 0x80FF0000;
+	  Uint32 pixel       = 0x00ABCDEF;
+
+	  SO::Blitter::blendRow(&transparent, &pixel, 1);
+	  REQUIRE(pixel == 0x00ABCDEF);
+
+	  SO::Blitter::blendRow(&opaque, &pixel, 1);
+	  REQUIRE(pixel == 0xFF123456);
+
+	  pixel = 0xFF000000;
+	  SO::Blitter::blendRow(&half, &pixel, 1);
+	  REQUIRE(pixel == 0xFF800000);
+	}
+    }
+  GIVEN("An ARGB8888 surface and a RGB888 surface")
+    {
+      std::unique_ptr<SO::Surface> src(createSurface(61, 37, SDL_PIXELFORMAT_ARGB8888));
+      std::unique_ptr<SO::Surface> dst(createSurface(53, 41, SDL_PIXELFORMAT_RGB888));
+      std::unique_ptr<SO::Surface> ref(createSurface(53, 41, SDL_PIXELFORMAT_RGB888));
+
+      fill(*src, random);
+      fill(*dst, random);
+
+      SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_BLEND);
+      SDL_BlitSurface(dst->toSDL(), nullptr, ref->toSDL(), nullptr);
+
+      WHEN("It is blitted partly out of the destination")
+	{
+	  SO::Rect srcRect(-3, 2, 50, 40);
+	  SO::Rect dstRect(10, -5, 0, 0);
+	  SO::Rect refRect = dstRect;
+
+	  src->blit(srcRect, *dst, dstRect);
+	  REQUIRE(SDL_BlitSurface(src->toSDL(), (SDL_Rect*)&srcRect,
+				  ref->toSDL(), (SDL_Rect*)&refRect) == 0);
+
+	  THEN("It clips and blends as SDL_BlitSurface")
+	    {
+	      REQUIRE(dstRect == refRect);
+
+	      const SDL_Surface* a = dst->toSDL();
+	      const SDL_Surface* b = ref->toSDL();
+
+	      int worst = 0;
+
+	      for (int y = 0; y < a->h; ++y)
+		for (int x = 0; x < a->w; ++x)
+		  {
+		    const Uint32 p = ((const Uint32*)((const Uint8*)a->pixels + y * a->pitch))[x];
+		    const Uint32 q = ((const Uint32*)((const Uint8*)b->pixels + y * b->pitch))[x];
+
+		    // RGB888 has no alpha channel to compare
+		    for (int shift = 0; shift < 24; shift += 8)
+		      worst = std::max(worst, std::abs(int(p >> shift & 0xFF) - int(q >> shift & 0xFF)));
+		  }
+
+	      // SDL divides by 256 instead of 255
+	      REQUIRE(worst <= 2);
+	    }
+	}
+    }
+}
+
+SCENARIO("Operations split across threads", "[Blitter]")
+{
+  std::mt19937 random(7);
+
+  const int         threads   = SO::Blitter::getThreads();
+  const std::size_t threshold = SO::Blitter::getThreshold();
+
+  GIVEN("Surfaces worked on by one thread and by four")
+    {
+      std::unique_ptr<SO::Surface> src(createSurface(301, 203, SDL_PIXELFORMAT_ARGB8888));
+      std::unique_ptr<SO::Surface> one(createSurface(509, 311, SDL_PIXELFORMAT_ARGB8888));
+      std::unique_ptr<SO::Surface> four(createSurface(509, 311, SDL_PIXELFORMAT_ARGB8888));
+
+      fill(*src, random);
+      fill(*one, random);
+      SDL_BlitSurface(one->toSDL(), nullptr, four->toSDL(), nullptr);
+
+      auto same = [&]()
+	{
+	  const SDL_Surface* a = one->toSDL();
+	  const SDL_Surface* b = four->toSDL();
+
+	  for (int y = 0; y < a->h; ++y)
+	    if (std::memcmp((const Uint8*)a->pixels + y * a->pitch,
+			    (const Uint8*)b->pixels + y * b->pitch, a->w * 4) != 0)
+	      return false;
+
+	  return true;
+	};
+
+      auto twice = [&](const std::function<void(SO::Surface&)>& operation)
+	{
+	  SO::Blitter::setThreads(1);
+	  operation(*one);
+
+	  SO::Blitter::setThreads(4);
+	  SO::Blitter::setThreshold(0);
+	  operation(*four);
+
+	  SO::Blitter::setThreads(threads);
+	  SO::Blitter::setThreshold(threshold);
+	};
+
+      THEN("Fills are the same")
+	{
+	  twice([](SO::Surface& surface) { surface.fillRect(SO::Rect(-7, 13, 400, 500), 0x80FF4020); });
+
+	  REQUIRE(same());
+	}
+      THEN("Copies are the same")
+	{
+	  SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_NONE);
+
+	  twice([&](SO::Surface& surface)
+		{
+		  SO::Rect dstRect(250, 150, 0, 0);
+
+		  src->blit(surface, dstRect);
+
+		  REQUIRE(dstRect == SO::Rect(250, 150, 259, 161));
+		});
+
+	  REQUIRE(same());
+	}
+      THEN("Scaled blits are the same as SDL's")
+	{
+	  // Twice the size, where every version of SDL samples alike
+	  SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_NONE);
+	  SO::Rect srcRect(0, 0, 150, 100);
+	  SO::Rect dstRect(10, 20, 300, 200);
+
+	  twice([&](SO::Surface& surface) { src->blitScaled(srcRect, surface, dstRect); });
+
+	  REQUIRE(same());
+	  REQUIRE(dstRect == SO::Rect(10, 20, 300, 200));
+
+	  REQUIRE(SDL_BlitScaled(src->toSDL(), (SDL_Rect*)&srcRect,
+				 four->toSDL(), (SDL_Rect*)&dstRect) == 0);
+	  REQUIRE(same());
+	}
+      THEN("Blended scaled blits are the same")
+	{
+	  twice([&](SO::Surface& surface) { src->blitScaled(surface); });
+
+	  REQUIRE(same());
+	}
+    }
+  GIVEN("A negative number of threads")
+    {
+      THEN("It is refused")
+	{
+	  REQUIRE_THROWS_AS(SO::Blitter::setThreads(-1), SO::Error);
+	  REQUIRE(SO::Blitter::getThreads() == threads);
+	}
+    }
+}
+
+SCENARIO("Filtered scaling", "[Blitter]")
+{
+  std::mt19937 random(11);
+
+  GIVEN("Random pixels")
+    {
+      const std::vector<Uint32> src = randomPixels(83 * 61, random);
+
+      const SO::Blitter::Kernel original = SO::Blitter::getKernel();
+
+      THEN("Every supported kernel gives the result of the scalar one")
+	{
+	  for (SO::ScaleFilters filter : {SO::ScaleFilters::Linear, SO::ScaleFilters::Box})
+	    for (SO::Blitter::Kernel kernel : kernels)
+	      {
+		if (!SO::Blitter::isSupported(kernel))
+		  continue;
+
+		for (int size : {1, 7, 40, 201})
+		  {
+		    std::vector<Uint32> expected(size * size);
+		    std::vector<Uint32> result(size * size);
+
+		    SO::Blitter::setKernel(SO::Blitter::Kernel::Scalar);
+		    SO::Blitter::scale(src.data(), 83 * 4, 83, 61,
+				       expected.data(), size * 4, size, size, false, filter);
+
+		    SO::Blitter::setKernel(kernel);
+		    SO::Blitter::scale(src.data(), 83 * 4, 83, 61,
+				       result.data(), size * 4, size, size, false, filter);
+
+		    REQUIRE(result == expected);
+		  }
+	      }
+
+	  SO::Blitter::setKernel(original);
+	}
+      THEN("Box averages the pixels it covers")
+	{
+	  std::vector<Uint32> result(41 * 30);
+
+	  SO::Blitter::scale(src.data(), 83 * 4, 82, 60,
+			     result.data(), 41 * 4, 41, 30, false, SO::ScaleFilters::Box);
+
+	  for (int y = 0; y < 30; ++y)
+	    for (int x = 0; x < 41; ++x)
+	      for (int shift = 0; shift < 32; shift += 8)
+		{
+		  int sum = 0;
+
+		  for (int j = 0; j < 2; ++j)
+		    for (int i = 0; i < 2; ++i)
+		      sum += src[(2 * y + j) * 83 + 2 * x + i] >> shift & 0xFF;
+
+		  REQUIRE((result[y * 41 + x] >> shift & 0xFF) == Uint32(sum + 2) / 4);
+		}
+	}
+      THEN("Linear and Box keep pixels scaled by one")
+	{
+	  std::vector<Uint32> result(83 * 61);
+
+	  for (SO::ScaleFilters filter : {SO::ScaleFilters::Linear, SO::ScaleFilters::Box})
+	    {
+	      SO::Blitter::scale(src.data(), 83 * 4, 83, 61,
+				 result.data(), 83 * 4, 83, 61, false, filter);
+
+	      REQUIRE(result == src);
+	    }
+	}
+    }
+  GIVEN("A surface of a single color")
+    {
+      std::unique_ptr<SO::Surface> src(createSurface(64, 48, SDL_PIXELFORMAT_RGB565));
+      std::unique_ptr<SO::Surface> dst(createSurface(100, 100, SDL_PIXELFORMAT_ARGB8888));
+
+      src->fillRect(SDL_MapRGB(src->toSDL()->format, 0xFF, 0, 0));
+      dst->fillRect(0);
+
+      WHEN("It is scaled partly out of an other format")
+	{
+	  SO::Rect dstRect(70, -10, 50, 40);
+
+	  src->blitScaled(*dst, dstRect, SO::ScaleFilters::Linear);
+
+	  THEN("It is clipped as a blit and keeps its color")
+	    {
+	      REQUIRE(dstRect == SO::Rect(70, 0, 30, 30));
+
+	      const SDL_Surface* sdl = dst->toSDL();
+
+	      for (int y = 0; y < sdl->h; ++y)
+		for (int x = 0; x < sdl->w; ++x)
+		  {
+		    const Uint32 pixel = ((const Uint32*)((const Uint8*)sdl->pixels + y * sdl->pitch))[x];
+
+		    REQUIRE(pixel == (x >= 70 && y < 30 ? 0xFFFF0000 : 0));
+		  }
+	    }
+	}
+    }
+  GIVEN("A RLE encoded surface")
+    {
+      std::unique_ptr<SO::Surface> src(createSurface(64, 48, SDL_PIXELFORMAT_ARGB8888));
+      std::unique_ptr<SO::Surface> dst(createSurface(100, 100, SDL_PIXELFORMAT_ARGB8888));
+
+      src->fillRect(0xFFFF0000);
+      dst->fillRect(0);
+
+      // Encoded by its first blit
+      SDL_SetSurfaceRLE(src->toSDL(), 1);
+      SDL_BlitSurface(src->toSDL(), nullptr, dst->toSDL(), nullptr);
+      dst->fillRect(0);
+
+      REQUIRE(SDL_MUSTLOCK(src->toSDL()));
+
+      WHEN("It is scaled with a filter")
+	{
+	  SO::Rect dstRect(10, 10, 40, 30);
+
+	  src->blitScaled(*dst, dstRect, SO::ScaleFilters::Box);
+
+	  THEN("Its decoded pixels are scaled")
+	    {
+	      const SDL_Surface* sdl = dst->toSDL();
+
+	      for (int y = 0; y < sdl->h; ++y)
+		for (int x = 0; x < sdl->w; ++x)
+		  {
+		    const Uint32 pixel = ((const Uint32*)((const Uint8*)sdl->pixels + y * sdl->pitch))[x];
+		    const bool   inside = x >= 10 && x < 50 && y >= 10 && y < 40;
+
+		    REQUIRE(pixel == (inside ? 0xFFFF0000 : 0));
+		  }
+	    }
+	}
+    }
+}
+
+SCENARIO("Pixel format conversion", "[Blitter]")
+{
+  const SO::PixelFormats formats[] = {
+    SO::PixelFormats::RGB24,    SO::PixelFormats::BGR24,    SO::PixelFormats::RGB888,
+    SO::PixelFormats::RGBX8888, SO::PixelFormats::BGR888,   SO::PixelFormats::BGRX8888,
+    SO::PixelFormats::ARGB8888, SO::PixelFormats::RGBA8888, SO::PixelFormats::ABGR8888,
+    SO::PixelFormats::BGRA8888
+  };
+
+  std::mt19937 random(13);
+
+  const int width  = 37;
+  const int height = 5;
+
+  std::vector<Uint8> src(width * height * 4);
+
+  for (Uint8& byte : src)
+    byte = random();
+
+  GIVEN("Every pair of formats with native kernels")
+    {
+      const SO::Blitter::Kernel original = SO::Blitter::getKernel();
+
+      THEN("Every kernel gives the colors of SDL_ConvertPixels")
+	{
+	  for (SO::PixelFormats from : formats)
+	    for (SO::PixelFormats to : formats)
+	      {
+		REQUIRE(SO::Blitter::canConvert(from, to));
+
+		const int srcPitch = width * SDL_BYTESPERPIXEL(static_cast<Uint32>(from));
+		const int dstPitch = width * SDL_BYTESPERPIXEL(static_cast<Uint32>(to));
+		const int bytes    = SDL_BYTESPERPIXEL(static_cast<Uint32>(to));
+
+		std::vector<Uint8> expected(dstPitch * height);
+
+		REQUIRE(SDL_ConvertPixels(width, height, static_cast<Uint32>(from), src.data(), srcPitch,
+					  static_cast<Uint32>(to), expected.data(), dstPitch) == 0);
+
+		SDL_PixelFormat* format = SDL_AllocFormat(static_cast<Uint32>(to));
+
+		for (SO::Blitter::Kernel kernel : kernels)
+		  {
+		    if (!SO::Blitter::isSupported(kernel))
+		      continue;
+
+		    std::vector<Uint8> result(dstPitch * height);
+
+		    SO::Blitter::setKernel(kernel);
+		    SO::Blitter::convert(src.data(), srcPitch, from, result.data(), dstPitch, to, width, height);
+
+		    // Compared through SDL_GetRGBA, unused bytes may differ
+		    for (int i = 0; i < width * height; ++i)
+		      {
+			Uint32 a = 0, b = 0;
+
+			std::memcpy(&a, &expected[i * bytes], bytes);
+			std::memcpy(&b, &result[i * bytes], bytes);
+
+			Uint8 ra, ga, ba, aa, rb, gb, bb, ab;
+
+			SDL_GetRGBA(a, format, &ra, &ga, &ba, &aa);
+			SDL_GetRGBA(b, format, &rb, &gb, &bb, &ab);
+
+			REQUIRE(ra == rb);
+			REQUIRE(ga == gb);
+			REQUIRE(ba == bb);
+			REQUIRE(aa == ab);
+		      }
+
+		    if (bytes == SDL_BYTESPERPIXEL(static_cast<Uint32>(from)))
+		      {
+			std::vector<Uint8> pixels(src.begin(), src.begin() + srcPitch * height);
+
+			SO::Blitter::convert(pixels.data(), srcPitch, from, pixels.data(), srcPitch, to, width, height);
+
+			REQUIRE(pixels == result);
+		      }
+		  }
+
+		SDL_FreeFormat(format);
+	      }
+
+	  SO::Blitter::setKernel(original);
+	}
+      THEN("Converting in place to an other size is refused")
+	{
+	  REQUIRE_THROWS_AS(SO::Blitter::convert(src.data(), width * 3, SO::PixelFormats::RGB24,
+						 src.data(), width * 3, SO::PixelFormats::ARGB8888,
+						 width, height), SO::Error);
+	}
+    }
+  GIVEN("An ABGR8888 surface and a preallocated ARGB8888 one")
+    {
+      std::unique_ptr<SO::Surface> abgr(createSurface(width, height, SDL_PIXELFORMAT_ABGR8888));
+      std::unique_ptr<SO::Surface> argb(createSurface(width, height, SDL_PIXELFORMAT_ARGB8888));
+
+      fill(*abgr, random);
+
+      THEN("Converting swaps red and blue")
+	{
+	  abgr->convertTo(*argb);
+
+	  const SDL_Surface* a = abgr->toSDL();
+	  const SDL_Surface* b = argb->toSDL();
+
+	  for (int y = 0; y < height; ++y)
+	    for (int x = 0; x < width; ++x)
+	      {
+		const Uint32 p = ((const Uint32*)((const Uint8*)a->pixels + y * a->pitch))[x];
+		const Uint32 q = ((const Uint32*)((const Uint8*)b->pixels + y * b->pitch))[x];
+
+		REQUIRE(q == ((p & 0xFF00FF00) | (p >> 16 & 0xFF) | (p & 0xFF) << 16));
+	      }
+	}
+      THEN("Converting into a surface of an other size is refused")
+	{
+	  std::unique_ptr<SO::Surface> small(createSurface(width - 1, height, SDL_PIXELFORMAT_ARGB8888));
+
+	  REQUIRE_THROWS_AS(abgr->convertTo(*small), SO::Error);
+	}
+    }
+  GIVEN("An ARGB8888 image file")
+    {
+      const char* path = "argb-stretch.bmp";
+
+      {
+	std::unique_ptr<SO::Surface> image(createSurface(width, height, SDL_PIXELFORMAT_ARGB8888));
+
+	fill(*image, random);
+	REQUIRE(SDL_SaveBMP(image->toSDL(), path) == 0);
+      }
+
+      std::unique_ptr<SO::Surface> rgb(createSurface(1, 1, SDL_PIXELFORMAT_RGB888));
+      std::unique_ptr<SO::Surface> argb(createSurface(1, 1, SDL_PIXELFORMAT_ARGB8888));
+
+      THEN("Loading it converted blends as SDL_ConvertSurface would")
+	{
+	  SDL_BlendMode mode;
+
+	  SO::Surface opaque(path, rgb.get());
+	  SDL_GetSurfaceBlendMode(opaque.toSDL(), &mode);
+	  REQUIRE(mode == SDL_BLENDMODE_NONE);
+
+	  SO::Surface blended(path, argb.get());
+	  SDL_GetSurfaceBlendMode(blended.toSDL(), &mode);
+	  REQUIRE(mode == SDL_BLENDMODE_BLEND);
+	}
+
+      std::remove(path);
+    }
+}
+
+TEST_CASE("Blending throughput", "[.][benchmark]")
+{
+  std::mt19937 random(42);
+
+  std::unique_ptr<SO::Surface> src(createSurface(1920, 1080, SDL_PIXELFORMAT_ARGB8888));
+  std::unique_ptr<SO::Surface> dst(createSurface(1920, 1080, SDL_PIXELFORMAT_RGB888));
+
+  fill(*src, random);
+  SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_BLEND);
+
+  const int runs = 50;
+
+  auto measure = [&](const char* name, const std::function<void()>& blit)
+    {
+      const auto start = std::chrono::steady_clock::now();
+
+      for (int i = 0; i < runs; ++i)
+	blit();
+
+      const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+      std::printf("%-8s %8.3f ms %8.1f Mpixels/s\n", name, elapsed.count() / runs,
+		  1920.0 * 1080 * runs / elapsed.count() / 1000);
+    };
+
+  measure("SDL", [&]() { SDL_BlitSurface(src->toSDL(), nullptr, dst->toSDL(), nullptr); });
+
+  const SO::Blitter::Kernel original = SO::Blitter::getKernel();
+  const char*               names[]  = {"Scalar", "SSE2", "AVX2"};
+
+  for (SO::Blitter::Kernel kernel : kernels)
+    if (SO::Blitter::isSupported(kernel))
+    {
+      SO::Blitter::setKernel(kernel);
+      measure(names[static_cast<int>(kernel)], [&]() { src->blit(*dst); });
+    }
+
+  SO::Blitter::setKernel(original);
+}
+
+TEST_CASE("Threaded throughput", "[.][benchmark]")
+{
+  std::mt19937 random(42);
+
+  std::unique_ptr<SO::Surface> src(createSurface(3840, 2160, SDL_PIXELFORMAT_ARGB8888));
+  std::unique_ptr<SO::Surface> dst(createSurface(7680, 4320, SDL_PIXELFORMAT_ARGB8888));
+
+  fill(*src, random);
+  SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_NONE);
+
+  const int threads = SO::Blitter::getThreads();
+  const int runs    = 10;
+
+  for (int count : {1, threads})
+    {
+      SO::Blitter::setThreads(count);
+
+      auto measure = [&](const std::function<void()>& operation)
+	{
+	  const auto start = std::chrono::steady_clock::now();
+
+	  for (int i = 0; i < runs; ++i)
+	    operation();
+
+	  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+	};
+
+      const double filled = measure([&]() { dst->fillRect(0xFF204080); });
+      const double copied = measure([&]() { src->blit(*dst); });
+      const double scaled = measure([&]() { src->blitScaled(*dst); });
+
+      std::printf("%2d threads: fill %8.3f ms, blit %8.3f ms, scale %8.3f ms\n",
+		  count, filled, copied, scaled);
+    }
+
+  SO::Blitter::setThreads(0);
+}
+
+TEST_CASE("Thumbnail throughput", "[.][benchmark]")
+{
+  std::mt19937 random(42);
+
+  std::unique_ptr<SO::Surface> src(createSurface(3840, 2160, SDL_PIXELFORMAT_ARGB8888));
+  std::unique_ptr<SO::Surface> dst(createSurface(480, 270, SDL_PIXELFORMAT_ARGB8888));
+
+  fill(*src, random);
+  SDL_SetSurfaceBlendMode(src->toSDL(), SDL_BLENDMODE_NONE);
+
+  const int runs = 10;
+
+  auto measure = [&](const char* name, const std::function<void()>& operation)
+    {
+      const auto start = std::chrono::steady_clock::now();
+
+      for (int i = 0; i < runs; ++i)
+	operation();
+
+      const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+      std::printf("%-16s %8.3f ms\n", name, elapsed.count() / runs);
+    };
+
+  // What filtering used to take, a nearest scale at twice the size and
+  // a second pass averaging it down
+  std::unique_ptr<SO::Surface> twice(createSurface(960, 540, SDL_PIXELFORMAT_ARGB8888));
+
+  measure("Nearest + pass", [&]()
+	  {
+	    SDL_BlitScaled(src->toSDL(), nullptr, twice->toSDL(), nullptr);
+
+	    const SDL_Surface* from = twice->toSDL();
+	    SDL_Surface*       to   = dst->toSDL();
+
+	    for (int y = 0; y < to->h; ++y)
+	      for (int x = 0; x < to->w; ++x)
+		{
+		  const Uint8* a = (const Uint8*)from->pixels + 2 * y * from->pitch + 8 * x;
+		  const Uint8* b = a + from->pitch;
+		  Uint8*       d = (Uint8*)to->pixels + y * to->pitch + 4 * x;
+
+		  for (int c = 0; c < 4; ++c)
+		    d[c] = (a[c] + a[c + 4] + b[c] + b[c + 4] + 2) / 4;
+		}
+	  });
+
+  measure("Nearest", [&]() { src->blitScaled(*dst, SO::ScaleFilters::Nearest); });
+  measure("Linear", [&]() { src->blitScaled(*dst, SO::ScaleFilters::Linear); });
+  measure("Box", [&]() { src->blitScaled(*dst, SO::ScaleFilters::Box); });
+}
+
+TEST_CASE("Conversion throughput", "[.][benchmark]")
+{
+  std::mt19937 random(42);
+
+  const int width  = 1920;
+  const int height = 1080;
+  const int runs   = 20;
+
+  std::vector<Uint8> src(width * height * 4);
+  std::vector<Uint8> dst(width * height * 4);
+
+  for (Uint8& byte : src)
+    byte = random();
+
+  const SO::Blitter::Kernel original = SO::Blitter::getKernel();
+  const char*               names[]  = {"Scalar", "SSE2", "AVX2"};
+
+  for (SO::PixelFormats from : {SO::PixelFormats::RGB24, SO::PixelFormats::ABGR8888})
+    {
+      const int pitch = width * SDL_BYTESPERPIXEL(static_cast<Uint32>(from));
+
+      auto measure = [&](const char* name, const std::function<void()>& convert)
+	{
+	  const auto start = std::chrono::steady_clock::now();
+
+	  for (int i = 0; i < runs; ++i)
+	    convert();
+
+	  const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	  std::printf("%-8s %-8s to ARGB8888 %8.3f ms\n", SDL_GetPixelFormatName(static_cast<Uint32>(from)) + 16,
+		      name, elapsed.count() / runs);
+	};
+
+      measure("SDL", [&]()
+	      {
+		SDL_ConvertPixels(width, height, static_cast<Uint32>(from), src.data(), pitch,
+				  SDL_PIXELFORMAT_ARGB8888, dst.data(), width * 4);
+	      });
+
+      for (SO::Blitter::Kernel kernel : kernels)
+	if (SO::Blitter::isSupported(kernel))
+	  {
+	    SO::Blitter::setKernel(kernel);
+	    measure(names[static_cast<int>(kernel)], [&]()
+		    {
+		      SO::Blitter::convert(src.data(), pitch, from, dst.data(), width * 4,
+					   SO::PixelFormats::ARGB8888, width, height);
+		    });
+	  }
+    }
+
+  SO::Blitter::setKernel(original);
+}
@@ -81,6 +81,20 @@ SCENARIO( "class SO::Color", "[Color]" )
 	REQUIRE( A == W );
       }
     }
+    WHEN( "Color D is assigned a color with distinct channels" ) // operator =
+    {
+      SO::Color D;
+
+      D = SO::Color(1, 2, 3, 4);
+
+      THEN( "Every channel is copied" )
+      {
+	REQUIRE( D.getRed() == 1 );
+	REQUIRE( D.getGreen() == 2 );
+	REQUIRE( D.getBlue() == 3 );
+	REQUIRE( D.getAlpha() == 4 );
+      }
+    }
     WHEN( "Color S is created from class Color static method 'fromRGB' with same values as W" ) // static methods fromRGB fromRGBA
     {
       SO::Color S = SO::Color::fromRGB(255, 255, 255);
@@ -0,0 +1,195 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "DamageTracker.hpp"
+#include "WindowSurface.hpp"
+
+#include <random>
+
+namespace
+{
+
+  bool overlap(const SO::Rect& a, const SO::Rect& b)
+  {
+    return a.getX() < b.getX() + b.getWidth() && b.getX() < a.getX() + a.getWidth() &&
+      a.getY() < b.getY() + b.getHeight() && b.getY() < a.getY() + a.getHeight();
+  }
+
+  bool covers(const std::vector<SO::Rect>& rects, int x, int y)
+  {
+    for (const SO::Rect& r : rects)
+      if (x >= r.getX() && x < r.getX() + r.getWidth() &&
+	  y >= r.getY() && y < r.getY() + r.getHeight())
+	return true;
+
+    return false;
+  }
+
+}
+
+SCENARIO("class SO::DamageTracker", "[DamageTracker]")
+{
+  GIVEN("A tracker with a margin of 8 pixels")
+    {
+      SO::DamageTracker damage(8, 4);
+
+      REQUIRE(damage.isEmpty());
+
+      WHEN("Two distant rects are added")
+	{
+	  damage.add({0, 0, 10, 10}).add({100, 100, 10, 10});
+
+	  THEN("They are kept apart")
+	    {
+	      REQUIRE(damage.getRects().size() == 2);
+	      REQUIRE(damage.getArea() == 200);
+	    }
+	}
+      WHEN("Two close rects are added")
+	{
+	  damage.add({0, 0, 10, 10}).add({12, 0, 10, 10});
+
+	  THEN("They are merged")
+	    {
+	      REQUIRE(damage.getRects().size() == 1);
+	      REQUIRE(damage.getRects()[0] == SO::Rect(0, 0, 22, 10));
+	    }
+	}
+      WHEN("A rect bridges two others")
+	{
+	  damage.add({0, 0, 10, 10}).add({40, 0, 10, 10}).add({15, 0, 20, 10});
+
+	  THEN("All three are merged")
+	    {
+	      REQUIRE(damage.getRects().size() == 1);
+	      REQUIRE(damage.getRects()[0] == SO::Rect(0, 0, 50, 10));
+	    }
+	}
+      WHEN("A rect inside a damaged one is added")
+	{
+	  damage.add({0, 0, 50, 50}).add({100, 0, 10, 10});
+
+	  const std::vector<SO::Rect> before = damage.getRects();
+
+	  damage.add({10, 10, 5, 5});
+
+	  THEN("The set is unchanged")
+	    {
+	      REQUIRE(damage.getRects() == before);
+	    }
+	}
+      WHEN("Bounds are set")
+	{
+	  damage.setBounds({0, 0, 100, 100});
+	  damage.add({90, 90, 20, 20}).add({200, 200, 10, 10});
+
+	  THEN("Damage is clipped to them")
+	    {
+	      REQUIRE(damage.getRects().size() == 1);
+	      REQUIRE(damage.getRects()[0] == SO::Rect(90, 90, 10, 10));
+	    }
+	  THEN("addAll damages the whole bounds")
+	    {
+	      damage.addAll();
+
+	      REQUIRE(damage.getRects().size() == 1);
+	      REQUIRE(damage.getArea() == 100 * 100);
+	    }
+	}
+      WHEN("It is cleared")
+	{
+	  damage.add({0, 0, 10, 10}).clear();
+
+	  THEN("It is empty")
+	    {
+	      REQUIRE(damage.isEmpty());
+	    }
+	}
+    }
+
+  GIVEN("Many random rects")
+    {
+      SO::DamageTracker damage(4, 8);
+      std::vector<SO::Rect> added;
+      std::mt19937 random(7);
+
+      for (int i = 0; i < 200; ++i)
+	{
+	  SO::Rect rect(random() % 1000, random() % 1000, 1 + random() % 30, 1 + random() % 30);
+
+	  added.push_back(rect);
+	  damage.add(rect);
+	}
+
+      const std::vector<SO::Rect>& rects = damage.getRects();
+
+      THEN("The result is bounded, disjoint and covers everything added")
+	{
+	  REQUIRE(rects.size() <= 8);
+
+	  for (std::size_t i = 0; i < rects.size(); ++i)
+	    for (std::size_t j = i + 1; j < rects.size(); ++j)
+	      REQUIRE_FALSE(overlap(rects[i], rects[j]));
+
+	  for (const SO::Rect& r : added)
+	    {
+	      REQUIRE(covers(rects, r.getX(), r.getY()));
+	      REQUIRE(covers(rects, r.getX() + r.getWidth() - 1, r.getY() + r.getHeight() - 1));
+	    }
+	}
+    }
+}
+
+SCENARIO("damage tracking of SO::WindowSurface", "[DamageTracker]")
+{
+  GIVEN("The surface of a hidden window")
+    {
+      SO::init(SO::Init::Video);
+
+      SO::Window        window("WindowSurface damage", {64, 48}, SO::Window::Hidden);
+      SO::WindowSurface surface(window);
+
+      REQUIRE(surface.getDamage().isEmpty());
+
+      WHEN("A rect is filled partly outside of it")
+	{
+	  surface.fillRect(SO::Rect(-8, 40, 16, 16), 0);
+
+	  THEN("The visible part is damaged")
+	    {
+	      const std::vector<SO::Rect>& rects = surface.getDamage().getRects();
+
+	      REQUIRE(covers(rects, 0, 40));
+	      REQUIRE(covers(rects, 7, 47));
+	      REQUIRE_FALSE(covers(rects, 8, 40));
+	      REQUIRE_FALSE(covers(rects, 0, 39));
+	    }
+	  THEN("Updating the window clears it")
+	    {
+	      surface.update();
+
+	      REQUIRE(surface.getDamage().isEmpty());
+	    }
+	}
+    }
+}
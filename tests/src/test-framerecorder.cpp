@@ -0,0 +1,127 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "FrameRecorder.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+  // Straightforward per-pixel conversion the recorder must agree with
+  void referenceI420(const std::vector<Uint32>& argb, int width, int height,
+		     std::vector<Uint8>& y, std::vector<Uint8>& u, std::vector<Uint8>& v)
+  {
+    const int cw = (width + 1) / 2;
+
+    auto channel = [&](int px, int py, int shift)
+      {
+	px = px < width  ? px : width - 1;
+	py = py < height ? py : height - 1;
+	return (int)((argb[py * width + px] >> shift) & 0xFF);
+      };
+
+    auto avg = [](int a, int b) { return (a + b + 1) >> 1; };
+
+    for (int j = 0; j < height; ++j)
+      for (int i = 0; i < width; ++i)
+	y[j * width + i] = ((66 * channel(i, j, 16) + 129 * channel(i, j, 8)
+			     + 25 * channel(i, j, 0) + 128) >> 8) + 16;
+
+    for (int j = 0; j < height; j += 2)
+      for (int i = 0; i < width; i += 2)
+      {
+	int c[3];
+
+	for (int k = 0; k < 3; ++k)
+	{
+	  const int shift = 16 - 8 * k;
+
+	  c[k] = avg(avg(channel(i, j, shift),     channel(i, j + 1, shift)),
+		     avg(channel(i + 1, j, shift), channel(i + 1, j + 1, shift)));
+	}
+
+	u[(j / 2) * cw + i / 2] = ((-38 * c[0] - 74 * c[1] + 112 * c[2] + 128) >> 8) + 128;
+	v[(j / 2) * cw + i / 2] = ((112 * c[0] - 94 * c[1] - 18 * c[2] + 128) >> 8) + 128;
+      }
+  }
+
+}
+
+SCENARIO("SO::FrameRecorder::toI420", "[FrameRecorder]")
+{
+  GIVEN("Uniform white and black images")
+    {
+      std::vector<Uint32> white(16 * 4, 0xFFFFFFFF);
+      std::vector<Uint32> black(16 * 4, 0xFF000000);
+
+      std::vector<Uint8> y(16 * 4), u(8 * 2), v(8 * 2);
+
+      THEN("They map to the ends of the studio range")
+	{
+	  SO::FrameRecorder::toI420(white.data(), 16 * 4, 16, 4, y.data(), u.data(), v.data());
+
+	  REQUIRE(y == std::vector<Uint8>(16 * 4, 235));
+	  REQUIRE(u == std::vector<Uint8>(8 * 2, 128));
+	  REQUIRE(v == std::vector<Uint8>(8 * 2, 128));
+
+	  SO::FrameRecorder::toI420(black.data(), 16 * 4, 16, 4, y.data(), u.data(), v.data());
+
+	  REQUIRE(y == std::vector<Uint8>(16 * 4, 16));
+	  REQUIRE(u == std::vector<Uint8>(8 * 2, 128));
+	  REQUIRE(v == std::vector<Uint8>(8 * 2, 128));
+	}
+    }
+
+  GIVEN("Random images of even and odd sizes")
+    {
+      std::mt19937 random(42);
+
+      THEN("The result matches the per-pixel reference")
+	{
+	  for (int width : {1, 7, 8, 17, 64})
+	    for (int height : {1, 2, 5})
+	    {
+	      std::vector<Uint32> argb(width * height);
+
+	      for (Uint32& pixel : argb)
+		pixel = random();
+
+	      const int cw = (width + 1) / 2;
+	      const int ch = (height + 1) / 2;
+
+	      std::vector<Uint8> y(width * height), u(cw * ch), v(cw * ch);
+	      std::vector<Uint8> ry(y.size()), ru(u.size()), rv(v.size());
+
+	      SO::FrameRecorder::toI420(argb.data(), width * 4, width, height,
+					y.data(), u.data(), v.data());
+	      referenceI420(argb, width, height, ry, ru, rv);
+
+	      REQUIRE(y == ry);
+	      REQUIRE(u == ru);
+	      REQUIRE(v == rv);
+	    }
+	}
+    }
+}
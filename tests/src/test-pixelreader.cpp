@@ -0,0 +1,99 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Renderer.hpp"
+#include "PixelReader.hpp"
+
+#include <cstring>
+
+namespace
+{
+
+  Uint32 pixelAt(const SO::PixelReader::Frame& frame, int x, int y)
+  {
+    Uint32 pixel;
+
+    std::memcpy(&pixel, &frame.pixels[y * frame.pitch + x * 4], 4);
+
+    return pixel;
+  }
+
+}
+
+SCENARIO("class SO::PixelReader", "[PixelReader]")
+{
+  GIVEN("A reader on a software renderer with a red square drawn")
+    {
+      SO::Surface     screen(SDL_CreateRGBSurface(0, 16, 16, 32,
+						  0x00FF0000, 0x0000FF00,
+						  0x000000FF, 0xFF000000));
+      SO::Renderer    renderer(screen);
+      SO::PixelReader reader(renderer, 2, 16, 16);
+
+      renderer.setDrawColor(SO::Color(0, 0, 0, 0xFF)).clear();
+      renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF)).fillRect(SO::Rect(0, 0, 8, 8));
+
+      WHEN("An area is read through a future")
+	{
+	  SO::PixelReader::Frame frame = reader.read(SO::Rect(4, 4, 8, 8), SO::PixelFormats::ABGR8888).get();
+
+	  THEN("The pixels are converted to the requested format")
+	    {
+	      REQUIRE(frame.width == 8);
+	      REQUIRE(frame.height == 8);
+	      REQUIRE(frame.format == SO::PixelFormats::ABGR8888);
+	      REQUIRE(frame.pitch >= 8 * 4);
+	      REQUIRE(frame.pixels.size() >= std::size_t(frame.pitch) * 8);
+
+	      REQUIRE(pixelAt(frame, 0, 0) == 0xFF0000FF);
+	      REQUIRE(pixelAt(frame, 3, 3) == 0xFF0000FF);
+	      REQUIRE(pixelAt(frame, 4, 3) == 0xFF000000);
+	      REQUIRE(pixelAt(frame, 7, 7) == 0xFF000000);
+	    }
+	}
+      WHEN("An area is read through a callback")
+	{
+	  SO::PixelReader::Frame frame;
+
+	  reader.read(SO::Rect(4, 4, 8, 8), SO::PixelFormats::RGBA8888,
+		      [&frame](SO::PixelReader::Frame& delivered)
+		      {
+			frame = std::move(delivered);
+		      });
+	  reader.wait();
+
+	  THEN("The converted pixels are delivered once waited for")
+	    {
+	      REQUIRE(reader.getPending() == 0);
+	      REQUIRE(frame.width == 8);
+	      REQUIRE(frame.height == 8);
+	      REQUIRE(frame.format == SO::PixelFormats::RGBA8888);
+
+	      REQUIRE(pixelAt(frame, 0, 0) == 0xFF0000FF);
+	      REQUIRE(pixelAt(frame, 3, 3) == 0xFF0000FF);
+	      REQUIRE(pixelAt(frame, 4, 3) == 0x000000FF);
+	      REQUIRE(pixelAt(frame, 7, 7) == 0x000000FF);
+	    }
+	}
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "PixelView.hpp"
+#include "Renderer.hpp"
+
+#include <cstring>
+#include <random>
+
+namespace
+{
+  // Raw value of a pixel, as SDL_GetRGBA expects it
+  Uint32 rawPixel(const Uint8* pixel, int bytes)
+  {
+    Uint32 raw = 0;
+
+    std::memcpy(&raw, pixel, bytes);
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    raw >>= 8 * (4 - bytes);
+#endif
+
+    return raw;
+  }
+}
+
+SCENARIO("class SO::PixelView", "[PixelView]")
+{
+  const SO::PixelFormats formats[] = {
+    SO::PixelFormats::RGB332,   SO::PixelFormats::RGB444,   SO::PixelFormats::RGB555,
+    SO::PixelFormats::BGR555,   SO::PixelFormats::ARGB4444, SO::PixelFormats::RGBA4444,
+    SO::PixelFormats::ABGR4444, SO::PixelFormats::BGRA4444, SO::PixelFormats::ARGB1555,
+    SO::PixelFormats::RGBA5551, SO::PixelFormats::ABGR1555, SO::PixelFormats::BGRA5551,
+    SO::PixelFormats::RGB565,   SO::PixelFormats::BGR565,   SO::PixelFormats::RGB24,
+    SO::PixelFormats::BGR24,    SO::PixelFormats::RGB888,   SO::PixelFormats::RGBX8888,
+    SO::PixelFormats::BGR888,   SO::PixelFormats::BGRX8888, SO::PixelFormats::ARGB8888,
+    SO::PixelFormats::RGBA8888, SO::PixelFormats::ABGR8888, SO::PixelFormats::BGRA8888
+  };
+
+  std::mt19937 random(5);
+
+  GIVEN("Surfaces of random pixels in every supported format")
+    {
+      THEN("Views convert colors as SDL_GetRGBA and SDL_MapRGBA")
+	{
+	  for (SO::PixelFormats format : formats)
+	    {
+	      SO::Surface surface(SDL_CreateRGBSurfaceWithFormat(0, 61, 37, 0, static_cast<Uint32>(format)));
+
+	      SDL_Surface* sdl = surface.toSDL();
+
+	      REQUIRE(sdl != nullptr);
+
+	      for (int y = 0; y < sdl->h; ++y)
+		for (int i = 0; i < sdl->pitch; ++i)
+		  static_cast<Uint8*>(sdl->pixels)[y * sdl->pitch + i] = random();
+
+	      const int bytes = sdl->format->BytesPerPixel;
+
+	      SO::visitPixels(surface, [&](auto view)
+			      {
+				REQUIRE(view.getWidth() == 61);
+				REQUIRE(view.getHeight() == 37);
+				REQUIRE(sizeof(typename decltype(view)::Pixel) == std::size_t(bytes));
+
+				for (int y = 0; y < view.getHeight(); ++y)
+				  for (int x = 0; x < view.getWidth(); ++x)
+				    {
+				      const Uint8* pixel = static_cast<const Uint8*>(sdl->pixels) + y * sdl->pitch + x * bytes;
+
+				      Uint8 r, g, b, a;
+
+				      SDL_GetRGBA(rawPixel(pixel, bytes), sdl->format, &r, &g, &b, &a);
+
+				      const SO::Color color = view.load(x, y);
+
+				      REQUIRE(color.getRed() == r);
+				      REQUIRE(color.getGreen() == g);
+				      REQUIRE(color.getBlue() == b);
+				      REQUIRE(color.getAlpha() == a);
+
+				      view.store(x, y, SO::Color(random()));
+
+				      const SO::Color stored = view.load(x, y);
+
+				      REQUIRE(rawPixel(pixel, bytes) == SDL_MapRGBA(sdl->format,
+										   stored.getRed(),
+										   stored.getGreen(),
+										   stored.getBlue(),
+										   stored.getAlpha()));
+				    }
+			      });
+	    }
+	}
+    }
+  GIVEN("A 5x3 RGB565 surface with padded rows")
+    {
+      SO::Surface surface(SDL_CreateRGBSurfaceWithFormat(0, 5, 3, 16, SDL_PIXELFORMAT_RGB565));
+
+      SO::PixelView<SO::PixelFormats::RGB565> view(surface);
+
+      THEN("Iterators and rows cover every pixel once")
+	{
+	  REQUIRE(view.getPitch() > 5 * 2);
+
+	  int count = 0;
+
+	  for (Uint16& pixel : view)
+	    pixel = ++count;
+
+	  REQUIRE(count == 15);
+
+	  for (int y = 0; y < 3; ++y)
+	    {
+	      REQUIRE(view.getRow(y).size() == 5);
+
+	      for (int x = 0; x < 5; ++x)
+		REQUIRE(view.getRow(y)[x] == y * 5 + x + 1);
+	    }
+	}
+      THEN("A view of an other format is refused")
+	{
+	  REQUIRE_THROWS_AS(SO::PixelView<SO::PixelFormats::BGR565>{surface}, SO::Error);
+	}
+    }
+  GIVEN("A locked streaming texture")
+    {
+      SO::Surface screen(SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 32, SDL_PIXELFORMAT_ARGB8888));
+      SO::Renderer renderer(screen);
+
+      SO::Texture texture(renderer, 4, 4, SO::TextureAccess::Streaming, SO::PixelFormats::ARGB8888);
+
+      SO::TextureLock lock(texture);
+
+      THEN("Its pixels are viewed in its format")
+	{
+	  SO::PixelView<SO::PixelFormats::ARGB8888> view(lock);
+
+	  view.store(3, 3, SO::Color(1, 2, 3, 4));
+
+	  REQUIRE(lock.at<Uint32>(3, 3) == 0x04010203);
+	  REQUIRE_THROWS_AS(SO::PixelView<SO::PixelFormats::RGBA8888>{lock}, SO::Error);
+	}
+    }
+}
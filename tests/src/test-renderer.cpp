@@ -0,0 +1,737 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+#include "TextureLock.hpp"
+#include "RenderTargetPool.hpp"
+
+#include <list>
+#include <vector>
+
+namespace
+{
+
+  const Uint32 Black = 0xFF000000;
+  const Uint32 Red   = 0xFFFF0000;
+  const Uint32 Green = 0xFF00FF00;
+  const Uint32 Blue  = 0xFF0000FF;
+  const Uint32 White = 0xFFFFFFFF;
+
+  SDL_Surface* createARGB(int width, int height, Uint32 pixel)
+  {
+    SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, 32,
+						0x00FF0000, 0x0000FF00,
+						0x000000FF, 0xFF000000);
+
+    SDL_FillRect(surface, nullptr, pixel);
+
+    return surface;
+  }
+
+  Uint32 pixelAt(SO::Surface& surface, int x, int y)
+  {
+    const SDL_Surface* sdl = surface.toSDL();
+
+    return ((const Uint32*)((const Uint8*)sdl->pixels + y * sdl->pitch))[x];
+  }
+
+  // 4x4, its 2x2 quadrants red, green, blue and white
+  SDL_Surface* createQuadrants()
+  {
+    SDL_Surface* surface = createARGB(4, 4, Red);
+    SDL_Rect     area    = {2, 0, 2, 2};
+
+    SDL_FillRect(surface, &area, Green);
+
+    area.x = 0;
+    area.y = 2;
+    SDL_FillRect(surface, &area, Blue);
+
+    area.x = 2;
+    SDL_FillRect(surface, &area, White);
+
+    return surface;
+  }
+
+  // Pixels away from the edges of the quadrants of dst, where both
+  // rasterizers agree
+  bool sameQuadrants(SO::Surface& a, SO::Surface& b, const SO::Rect& dst)
+  {
+    const int inner[] = {1, 2, 5, 6};
+
+    for (int y : inner)
+      for (int x : inner)
+	if (pixelAt(a, dst.getX() + x, dst.getY() + y) != pixelAt(b, dst.getX() + x, dst.getY() + y))
+	  return false;
+
+    return true;
+  }
+
+  // Red where art has a '#', black elsewhere, art starting at x, y
+  bool matches(SO::Surface& surface, int x, int y, const char* const art[], int rows)
+  {
+    for (int row = 0; row < rows; ++row)
+      for (int column = 0; art[row][column] != '\0'; ++column)
+	if (pixelAt(surface, x + column, y + row) != (art[row][column] == '#' ? Red : Black))
+	  return false;
+
+    return true;
+  }
+
+}
+
+SCENARIO("deferred mode of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A deferred software renderer")
+    {
+      SO::Surface  screen(createARGB(16, 16, Black));
+      SO::Renderer renderer(screen);
+
+      renderer.setDeferred(true);
+
+      WHEN("Rects are filled")
+	{
+	  renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+	  renderer.fillRect(SO::Rect(0, 0, 8, 8));
+
+	  THEN("Nothing is drawn until the commands are flushed")
+	    {
+	      REQUIRE(pixelAt(screen, 2, 2) == Black);
+
+	      renderer.flush();
+
+	      REQUIRE(pixelAt(screen, 2, 2) == Red);
+	      REQUIRE(pixelAt(screen, 12, 12) == Black);
+	    }
+	}
+      WHEN("A texture is destroyed while copies from it are pending")
+	{
+	  SO::Surface green(createARGB(4, 4, Green));
+
+	  {
+	    SO::Texture texture(renderer, green);
+	    SO::Rect    dst(4, 4, 4, 4);
+
+	    renderer.copy(texture, nullptr, &dst);
+	  }
+
+	  THEN("The copies are flushed first")
+	    {
+	      REQUIRE(pixelAt(screen, 5, 5) == Green);
+
+	      renderer.flush();
+
+	      REQUIRE(pixelAt(screen, 5, 5) == Green);
+	    }
+	}
+      WHEN("Copies from the same texture are recorded in a row")
+	{
+	  SO::Surface green(createARGB(4, 4, Green));
+	  SO::Texture texture(renderer, green);
+
+	  const SO::Rect src(0, 0, 2, 2);
+	  const SO::Rect left(0, 0, 4, 4);
+	  const SO::Rect right(8, 0, 4, 4);
+
+	  renderer.copy(texture, &src, &left);
+	  renderer.copy(texture, nullptr, &right);
+	  renderer.present();
+
+	  THEN("They are all drawn")
+	    {
+	      REQUIRE(pixelAt(screen, 1, 1) == Green);
+	      REQUIRE(pixelAt(screen, 10, 2) == Green);
+	      REQUIRE(pixelAt(screen, 6, 2) == Black);
+	    }
+#if SDL_VERSION_ATLEAST(2, 0, 18) && !defined(SO_NO_RENDERER_STATS)
+	  THEN("They reach SDL in a single call")
+	    {
+	      REQUIRE(renderer.stats().geometryCalls == 1);
+	      REQUIRE(renderer.stats().copyCalls == 0);
+	      REQUIRE(renderer.stats().pixelsCopied == 2 * 4 * 4);
+	    }
+#endif
+	}
+      WHEN("A texture is locked while copies from it are pending")
+	{
+	  SO::Texture    texture(renderer, 4, 4, SO::TextureAccess::Streaming, SO::PixelFormats::ARGB8888);
+	  const SO::Rect dst(0, 0, 4, 4);
+
+	  {
+	    SO::TextureLock lock(texture);
+
+	    for (int y = 0; y < 4; ++y)
+	      for (int x = 0; x < 4; ++x)
+		lock.at<Uint32>(x, y) = Green;
+	  }
+
+	  renderer.copy(texture, nullptr, &dst);
+
+	  Uint32 drawn = Black;
+
+	  {
+	    SO::TextureLock lock(texture);
+
+	    drawn = pixelAt(screen, 1, 1);
+
+	    for (int y = 0; y < 4; ++y)
+	      for (int x = 0; x < 4; ++x)
+		lock.at<Uint32>(x, y) = Red;
+	  }
+
+	  renderer.flush();
+
+	  THEN("The copies are flushed first, with the pixels they were given")
+	    {
+	      REQUIRE(drawn == Green);
+	      REQUIRE(pixelAt(screen, 1, 1) == Green);
+	    }
+	}
+    }
+}
+
+SCENARIO("render target stack of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A software renderer and a target texture")
+    {
+      SO::Surface  screen(createARGB(16, 16, Black));
+      SO::Renderer renderer(screen);
+      SO::Texture  target(renderer, 8, 8, SO::TextureAccess::Target, SO::PixelFormats::ARGB8888);
+      SO::Texture  other(renderer, 8, 8, SO::TextureAccess::Target, SO::PixelFormats::ARGB8888);
+
+      WHEN("Targets are pushed and popped")
+	{
+	  renderer.pushTarget(target);
+	  REQUIRE(renderer.getTarget() == target.toSDL());
+
+	  renderer.pushTarget(other);
+	  REQUIRE(renderer.getTarget() == other.toSDL());
+
+	  renderer.popTarget();
+	  REQUIRE(renderer.getTarget() == target.toSDL());
+
+	  renderer.popTarget();
+
+	  THEN("The default target is restored")
+	    {
+	      REQUIRE(renderer.getTarget() == nullptr);
+	      REQUIRE_THROWS_AS(renderer.popTarget(), SO::Error);
+	    }
+	}
+      WHEN("The current target is destroyed")
+	{
+	  {
+	    SO::Texture temporary(renderer, 8, 8, SO::TextureAccess::Target, SO::PixelFormats::ARGB8888);
+
+	    renderer.pushTarget(temporary);
+	  }
+
+	  THEN("The default target is restored and remembered as such")
+	    {
+	      REQUIRE(renderer.getTarget() == nullptr);
+
+	      renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+	      renderer.fillRect(SO::Rect(0, 0, 2, 2));
+
+	      REQUIRE(pixelAt(screen, 1, 1) == Red);
+
+	      SO::Texture next(renderer, 8, 8, SO::TextureAccess::Target, SO::PixelFormats::ARGB8888);
+
+	      renderer.setTarget(next);
+	      REQUIRE(renderer.getTarget() == next.toSDL());
+
+	      renderer.resetTarget();
+	      renderer.popTarget();
+	      REQUIRE(renderer.getTarget() == nullptr);
+	    }
+	}
+      WHEN("A texture can't be made the target")
+	{
+	  SO::Texture staticTexture(renderer, 8, 8, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+
+	  renderer.pushTarget(target);
+
+	  REQUIRE_THROWS_AS(renderer.pushTarget(staticTexture), SO::Error);
+
+	  THEN("Nothing is pushed")
+	    {
+	      REQUIRE(renderer.getTarget() == target.toSDL());
+
+	      renderer.popTarget();
+
+	      REQUIRE(renderer.getTarget() == nullptr);
+	      REQUIRE_THROWS_AS(renderer.popTarget(), SO::Error);
+	    }
+	}
+    }
+}
+
+SCENARIO("class SO::RenderTargetPool", "[RenderTargetPool]")
+{
+  GIVEN("A pool on a software renderer")
+    {
+      SO::Surface          screen(createARGB(16, 16, Black));
+      SO::Renderer         renderer(screen);
+      SO::RenderTargetPool pool(renderer);
+
+      WHEN("A target is leased")
+	{
+	  SO::RenderTargetPool::Lease lease = pool.acquire(8, 4);
+
+	  THEN("It has the requested size and is counted as leased")
+	    {
+	      REQUIRE(lease);
+	      REQUIRE(lease->getWidth() == 8);
+	      REQUIRE(lease->getHeight() == 4);
+	      REQUIRE(lease->getAccess() == SO::TextureAccess::Target);
+	      REQUIRE(pool.getLeased() == 1);
+	      REQUIRE(pool.getIdle() == 0);
+	    }
+	}
+      WHEN("A target is given back and the same size leased again")
+	{
+	  SDL_Texture* first = nullptr;
+
+	  {
+	    SO::RenderTargetPool::Lease lease = pool.acquire(8, 4);
+	    first = lease->toSDL();
+	  }
+
+	  REQUIRE(pool.getIdle() == 1);
+	  REQUIRE(pool.getLeased() == 0);
+
+	  SO::RenderTargetPool::Lease again = pool.acquire(8, 4);
+	  SO::RenderTargetPool::Lease other = pool.acquire(4, 8);
+
+	  THEN("The idle target is reused for the same key only")
+	    {
+	      REQUIRE(again->toSDL() == first);
+	      REQUIRE(other->toSDL() != first);
+	      REQUIRE(pool.getIdle() == 0);
+	      REQUIRE(pool.getLeased() == 2);
+	    }
+	}
+      WHEN("Idle targets time out")
+	{
+	  pool.acquire(8, 4).release();
+	  pool.setIdleTimeout(0).trim();
+
+	  THEN("They are destroyed")
+	    {
+	      REQUIRE(pool.getIdle() == 0);
+	    }
+	}
+    }
+}
+
+SCENARIO("damage tracking of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A software renderer tracking damage")
+    {
+      SO::Surface  screen(createARGB(16, 16, Black));
+      SO::Renderer renderer(screen);
+
+      renderer.setDamageTracking(true);
+      renderer.present();
+
+      REQUIRE(renderer.getDamage().isEmpty());
+
+      WHEN("A line starts far off screen")
+	{
+	  renderer.drawLine(-40000, 2, 4, 2);
+
+	  THEN("The visible part of it is damaged")
+	    {
+	      bool covered = false;
+
+	      for (const SO::Rect& rect : renderer.getDamage().getRects())
+		covered = covered ||
+		  (rect.getX() <= 0 && rect.getX() + rect.getWidth() >= 5 &&
+		   rect.getY() <= 2 && rect.getY() + rect.getHeight() > 2);
+
+	      REQUIRE(covered);
+	    }
+	}
+    }
+}
+
+SCENARIO("sprite batches of SO::Renderer", "[Renderer]")
+{
+  GIVEN("Two software renderers and a texture of four colors on each")
+    {
+      SO::Surface  batched(createARGB(16, 16, Black));
+      SO::Surface  single(createARGB(16, 16, Black));
+      SO::Renderer batchRenderer(batched);
+      SO::Renderer singleRenderer(single);
+      SO::Surface  quadrants(createQuadrants());
+      SO::Texture  batchTexture(batchRenderer, quadrants);
+      SO::Texture  singleTexture(singleRenderer, quadrants);
+
+      const SO::Rect dst(4, 4, 8, 8);
+
+      WHEN("Rotated and flipped sprites are drawn")
+	{
+	  const double   angles[] = {0, 90, 180, 270};
+	  const SO::Flip flips[]  = {SO::Flip::Null, SO::Flip::Horizontal, SO::Flip::Vertical};
+
+	  THEN("They match SO::Renderer::copyEx")
+	    {
+	      for (double angle : angles)
+		for (SO::Flip flip : flips)
+		  {
+		    SO::Sprite sprite;
+
+		    sprite.dst   = dst;
+		    sprite.angle = angle;
+		    sprite.flip  = flip;
+
+		    batchRenderer.drawSprites(batchTexture, &sprite, 1).present();
+		    singleRenderer.copyEx(singleTexture, nullptr, &dst, angle, nullptr, flip).present();
+
+		    REQUIRE(sameQuadrants(batched, single, dst));
+		  }
+	    }
+	}
+      WHEN("Sprites have their own source area and color")
+	{
+	  std::vector<SO::Sprite> sprites(2);
+
+	  sprites[0].src      = SO::Rect(2, 2, 2, 2);
+	  sprites[0].dst      = SO::Rect(0, 0, 4, 4);
+	  sprites[0].colorMod = SO::Color(0, 0, 0xFF, 0xFF);
+	  sprites[1].dst      = dst;
+	  sprites[1].colorMod = SO::Color(0xFF, 0, 0, 0xFF);
+
+	  batchRenderer.drawSprites(batchTexture, sprites).present();
+
+	  THEN("Each one is drawn from its own area, modulated by its own color")
+	    {
+	      REQUIRE(pixelAt(batched, 1, 1) == Blue);
+	      REQUIRE(pixelAt(batched, 2, 2) == Blue);
+	      REQUIRE(pixelAt(batched, 5, 5) == Red);
+	      REQUIRE(pixelAt(batched, 9, 5) == Black);
+	    }
+	  THEN("An empty source area stands for the whole texture")
+	    {
+	      REQUIRE(pixelAt(batched, 5, 9) == Black);
+	      REQUIRE(pixelAt(batched, 9, 9) == Red);
+	    }
+	}
+      WHEN("The texture has color and alpha mods of its own")
+	{
+	  SO::Sprite sprite;
+
+	  sprite.dst      = dst;
+	  sprite.colorMod = SO::Color(0xFF, 0, 0, 0xFF);
+
+	  batchTexture.setColorMod(SO::Color(0, 0xFF, 0x40)).setAlphaMod(0x80);
+	  batchRenderer.drawSprites(batchTexture, &sprite, 1).present();
+
+	  THEN("They are left untouched")
+	    {
+	      const SO::Color mod = batchTexture.getColorMod();
+
+	      REQUIRE(mod.getRed() == 0);
+	      REQUIRE(mod.getGreen() == 0xFF);
+	      REQUIRE(mod.getBlue() == 0x40);
+	      REQUIRE(batchTexture.getAlphaMod() == 0x80);
+	    }
+	}
+    }
+}
+
+SCENARIO("batch drawing of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A software renderer drawing in red")
+    {
+      SO::Surface  screen(createARGB(16, 16, Black));
+      SO::Renderer renderer(screen);
+
+      renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+
+      // x, y pairs as SDL_Point lays them out, and with a field between
+      struct XY    { int x, y; };
+      struct XYTag { int x, y, tag; };
+
+      WHEN("Empty batches are drawn")
+	{
+	  const std::vector<SO::Point> points;
+	  const std::vector<SO::Rect>  rects;
+	  const std::list<SO::Point>   pointList;
+	  const std::list<SO::Rect>    rectList;
+
+	  renderer.drawPoints(points).drawPoints(points.data(), 0)
+	    .drawPoints(pointList.begin(), pointList.end())
+	    .drawPoints(nullptr, nullptr, 0);
+
+	  renderer.drawLines(points).drawLines(points.data(), 0)
+	    .drawLines(pointList.begin(), pointList.end())
+	    .drawLines(nullptr, nullptr, 0);
+
+	  renderer.drawRects(rects).drawRects(rects.data(), 0)
+	    .drawRects(rectList.begin(), rectList.end())
+	    .drawRects(nullptr, nullptr, nullptr, nullptr, 0);
+
+	  renderer.fillRects(rects).fillRects(rects.data(), 0)
+	    .fillRects(rectList.begin(), rectList.end())
+	    .fillRects(nullptr, nullptr, nullptr, nullptr, 0);
+
+	  renderer.present();
+
+	  THEN("Nothing is drawn")
+	    {
+	      for (int y = 0; y < 16; ++y)
+		for (int x = 0; x < 16; ++x)
+		  REQUIRE(pixelAt(screen, x, y) == Black);
+	    }
+	}
+      WHEN("Points are drawn through every overload")
+	{
+	  const std::vector<SO::Point> points    = {{1, 1}, {3, 1}};
+	  const SO::Point              array[]   = {{1, 3}, {3, 3}};
+	  const std::list<SO::Point>   pointList = {{1, 5}, {3, 5}};
+	  const int                    xs[]      = {1, 3};
+	  const int                    ys[]      = {7, 7};
+	  const XY                     xy[]      = {{1, 9}, {3, 9}};
+	  const XYTag                  xyTag[]   = {{1, 11, 0}, {3, 11, 0}};
+
+	  renderer.drawPoints(points)
+	    .drawPoints(array, 2)
+	    .drawPoints(pointList.begin(), pointList.end())
+	    .drawPoints(xs, ys, 2)
+	    .drawPoints(&xy[0].x, &xy[0].y, 2, sizeof(XY))
+	    .drawPoints(&xyTag[0].x, &xyTag[0].y, 2, sizeof(XYTag))
+	    .present();
+
+	  THEN("Each batch draws its points only")
+	    {
+	      for (int y = 1; y <= 11; y += 2)
+		{
+		  REQUIRE(pixelAt(screen, 1, y) == Red);
+		  REQUIRE(pixelAt(screen, 2, y) == Black);
+		  REQUIRE(pixelAt(screen, 3, y) == Red);
+		  REQUIRE(pixelAt(screen, 1, y + 1) == Black);
+		}
+	    }
+	}
+      WHEN("Lines are drawn through every overload")
+	{
+	  const std::vector<SO::Point> points    = {{0, 1}, {4, 1}};
+	  const SO::Point              array[]   = {{0, 3}, {4, 3}};
+	  const std::list<SO::Point>   pointList = {{0, 5}, {4, 5}};
+	  const int                    xs[]      = {0, 4};
+	  const int                    ys[]      = {7, 7};
+	  const XY                     xy[]      = {{0, 9}, {4, 9}};
+	  const XYTag                  xyTag[]   = {{0, 11, 0}, {4, 11, 0}};
+
+	  renderer.drawLines(points)
+	    .drawLines(array, 2)
+	    .drawLines(pointList.begin(), pointList.end())
+	    .drawLines(xs, ys, 2)
+	    .drawLines(&xy[0].x, &xy[0].y, 2, sizeof(XY))
+	    .drawLines(&xyTag[0].x, &xyTag[0].y, 2, sizeof(XYTag))
+	    .present();
+
+	  THEN("Each batch draws its line only")
+	    {
+	      for (int y = 1; y <= 11; y += 2)
+		{
+		  REQUIRE(pixelAt(screen, 0, y) == Red);
+		  REQUIRE(pixelAt(screen, 2, y) == Red);
+		  REQUIRE(pixelAt(screen, 4, y) == Red);
+		  REQUIRE(pixelAt(screen, 6, y) == Black);
+		  REQUIRE(pixelAt(screen, 2, y + 1) == Black);
+		}
+	    }
+	}
+      WHEN("Rects are drawn and filled through every overload")
+	{
+	  struct XYWH    { int x, y, w, h; };
+	  struct XYWHTag { int x, y, w, h, tag; };
+
+	  const std::vector<SO::Rect> rects     = {SO::Rect(0, 0, 4, 4)};
+	  const SO::Rect              array[]   = {SO::Rect(4, 0, 4, 4)};
+	  const std::list<SO::Rect>   rectList  = {SO::Rect(8, 0, 4, 4), SO::Rect(12, 0, 4, 4)};
+	  const int                   xs[]      = {0, 4};
+	  const int                   ys[]      = {4, 4};
+	  const int                   ws[]      = {4, 4};
+	  const int                   hs[]      = {4, 4};
+	  const XYWH                  xywh[]    = {{8, 4, 4, 4}};
+	  const XYWHTag               xywhTag[] = {{12, 4, 4, 4, 0}};
+
+	  renderer.drawRects(rects)
+	    .drawRects(array, 1)
+	    .drawRects(rectList.begin(), rectList.end())
+	    .drawRects(xs, ys, ws, hs, 2)
+	    .drawRects(&xywh[0].x, &xywh[0].y, &xywh[0].w, &xywh[0].h, 1, sizeof(XYWH))
+	    .drawRects(&xywhTag[0].x, &xywhTag[0].y, &xywhTag[0].w, &xywhTag[0].h, 1, sizeof(XYWHTag));
+
+	  const std::vector<SO::Rect> filled      = {SO::Rect(0, 8, 4, 4)};
+	  const SO::Rect              fillArray[] = {SO::Rect(4, 8, 4, 4)};
+	  const std::list<SO::Rect>   fillList    = {SO::Rect(8, 8, 4, 4)};
+	  const int                   fillXs[]    = {12, 0};
+	  const int                   fillYs[]    = {8, 12};
+	  const XYWH                  fillXYWH[]  = {{4, 12, 4, 4}};
+	  const XYWHTag               fillTag[]   = {{8, 12, 4, 4, 0}};
+
+	  renderer.fillRects(filled)
+	    .fillRects(fillArray, 1)
+	    .fillRects(fillList.begin(), fillList.end())
+	    .fillRects(fillXs, fillYs, ws, hs, 2)
+	    .fillRects(&fillXYWH[0].x, &fillXYWH[0].y, &fillXYWH[0].w, &fillXYWH[0].h, 1, sizeof(XYWH))
+	    .fillRects(&fillTag[0].x, &fillTag[0].y, &fillTag[0].w, &fillTag[0].h, 1, sizeof(XYWHTag))
+	    .present();
+
+	  THEN("The drawn rects are outlined")
+	    {
+	      for (int x = 0; x < 16; x += 4)
+		for (int y = 0; y < 8; y += 4)
+		  {
+		    REQUIRE(pixelAt(screen, x, y) == Red);
+		    REQUIRE(pixelAt(screen, x + 3, y + 3) == Red);
+		    REQUIRE(pixelAt(screen, x + 1, y + 1) == Black);
+		    REQUIRE(pixelAt(screen, x + 2, y + 2) == Black);
+		  }
+	    }
+	  THEN("The filled rects are covered")
+	    {
+	      for (int x = 0; x < 16; x += 4)
+		for (int y = 8; y < 16; y += 4)
+		  if (x != 12 || y != 12)
+		    {
+		      REQUIRE(pixelAt(screen, x + 1, y + 1) == Red);
+		      REQUIRE(pixelAt(screen, x + 2, y + 2) == Red);
+		    }
+
+	      REQUIRE(pixelAt(screen, 13, 13) == Black);
+	    }
+	}
+    }
+}
+
+SCENARIO("circles of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A software renderer drawing in red")
+    {
+      SO::Surface  screen(createARGB(32, 16, Black));
+      SO::Renderer renderer(screen);
+
+      renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+
+      // Two circles of radius 5, their pixels within 4 of the center
+      const std::vector<SO::Pair<SO::Point, int>> circles = {{{8, 8}, 5}, {{24, 8}, 5}};
+
+      WHEN("Their outlines are drawn")
+	{
+	  const char* const outline[] = {
+	    "...........",
+	    "..#######..",
+	    ".#.......#.",
+	    ".#.......#.",
+	    ".#.......#.",
+	    ".#.......#.",
+	    ".#.......#.",
+	    ".#.......#.",
+	    ".#.......#.",
+	    "..#######..",
+	    "..........."
+	  };
+
+	  renderer.drawCircles(circles).present();
+
+	  THEN("Only the midpoint outlines are drawn")
+	    {
+	      REQUIRE(matches(screen, 3, 3, outline, 11));
+	      REQUIRE(matches(screen, 19, 3, outline, 11));
+	    }
+	}
+      WHEN("They are filled")
+	{
+	  const char* const disc[] = {
+	    "...........",
+	    "..#######..",
+	    ".#########.",
+	    ".#########.",
+	    ".#########.",
+	    ".#########.",
+	    ".#########.",
+	    ".#########.",
+	    ".#########.",
+	    "..#######..",
+	    "..........."
+	  };
+
+	  renderer.fillCircles(circles).present();
+
+	  THEN("The outlines and everything within are covered")
+	    {
+	      REQUIRE(matches(screen, 3, 3, disc, 11));
+	      REQUIRE(matches(screen, 19, 3, disc, 11));
+	    }
+	}
+    }
+}
+
+#ifndef SO_NO_RENDERER_STATS
+SCENARIO("state changes of SO::Renderer", "[Renderer]")
+{
+  GIVEN("A software renderer at the start of a frame")
+    {
+      SO::Surface  screen(createARGB(16, 16, Black));
+      SO::Renderer renderer(screen);
+
+      renderer.present();
+
+      REQUIRE(renderer.getStateChanges() == 0);
+
+      WHEN("Every state is set twice to the same value")
+	{
+	  renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF))
+	    .setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+	  renderer.setViewport(SO::Rect(0, 0, 8, 8))
+	    .setViewport(SO::Rect(0, 0, 8, 8));
+	  renderer.setClipRect(SO::Rect(0, 0, 4, 4))
+	    .setClipRect(SO::Rect(0, 0, 4, 4));
+	  renderer.setScale(2, 2)
+	    .setScale(2, 2);
+
+	  THEN("Only the first of each reaches SDL")
+	    {
+	      REQUIRE(renderer.getStateChanges() == 4);
+	    }
+	}
+      WHEN("A state is set back to the value it had")
+	{
+	  renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+	  renderer.setDrawColor(SO::Color(0, 0xFF, 0, 0xFF));
+	  renderer.setDrawColor(SO::Color(0xFF, 0, 0, 0xFF));
+
+	  THEN("Every actual change is counted")
+	    {
+	      REQUIRE(renderer.getStateChanges() == 3);
+	    }
+	}
+    }
+}
+#endif
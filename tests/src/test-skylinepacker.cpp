@@ -0,0 +1,109 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "SkylinePacker.hpp"
+
+#include <random>
+#include <vector>
+
+SCENARIO("class SO::SkylinePacker", "[SkylinePacker]")
+{
+  GIVEN("A packer of 64x64")
+    {
+      SO::SkylinePacker packer(64, 64);
+      SO::Rect rect;
+
+      WHEN("Four 32x32 rects are inserted")
+	{
+	  THEN("They fill the area exactly")
+	    {
+	      for (int i = 0; i < 4; ++i)
+		REQUIRE(packer.insert(32, 32, rect));
+
+	      REQUIRE(packer.getOccupancy() == Approx(1.0f));
+	      REQUIRE_FALSE(packer.insert(1, 1, rect));
+	    }
+	}
+      WHEN("A rect larger than the area is inserted")
+	{
+	  THEN("It is refused")
+	    {
+	      REQUIRE_FALSE(packer.insert(65, 1, rect));
+	      REQUIRE_FALSE(packer.insert(1, 65, rect));
+	    }
+	}
+      WHEN("It is cleared")
+	{
+	  packer.insert(64, 64, rect);
+	  packer.clear();
+
+	  THEN("The whole area is free again")
+	    {
+	      REQUIRE(packer.getOccupancy() == 0.0f);
+	      REQUIRE(packer.insert(64, 64, rect));
+	      REQUIRE(rect == SO::Rect(0, 0, 64, 64));
+	    }
+	}
+    }
+
+  GIVEN("Random rects inserted into a 512x512 packer")
+    {
+      SO::SkylinePacker packer(512, 512);
+      std::vector<SO::Rect> placed;
+      std::mt19937 random(3);
+
+      for (int i = 0; i < 500; ++i)
+	{
+	  SO::Rect rect;
+
+	  if (packer.insert(4 + random() % 40, 4 + random() % 40, rect))
+	    placed.push_back(rect);
+	}
+
+      THEN("They stay inside the area and never overlap")
+	{
+	  int outside = 0, overlaps = 0;
+
+	  for (std::size_t i = 0; i < placed.size(); ++i)
+	    {
+	      const SO::Rect& a = placed[i];
+
+	      if (a.getX() + a.getWidth() > 512 || a.getY() + a.getHeight() > 512)
+		++outside;
+
+	      for (std::size_t j = i + 1; j < placed.size(); ++j)
+		{
+		  const SO::Rect& b = placed[j];
+
+		  if (a.getX() < b.getX() + b.getWidth() && b.getX() < a.getX() + a.getWidth() &&
+		      a.getY() < b.getY() + b.getHeight() && b.getY() < a.getY() + a.getHeight())
+		    ++overlaps;
+		}
+	    }
+
+	  REQUIRE(packer.getOccupancy() > 0.7f);
+	  REQUIRE(outside == 0);
+	  REQUIRE(overlaps == 0);
+	}
+    }
+}
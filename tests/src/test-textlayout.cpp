@@ -0,0 +1,149 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "TextLayout.hpp"
+
+#ifdef _SDL_TTF_H
+
+SCENARIO("class SO::TextLayout", "[TextLayout]")
+{
+  GIVEN("A font and a layout cache of two entries")
+    {
+      SO::initTTF();
+
+      TTF_Font* font = TTF_OpenFont("fonts/lazy.ttf", 28);
+
+      REQUIRE(font != nullptr);
+
+      SO::TextLayout layouts(2);
+
+      const std::string text = "The quick brown fox jumps over the lazy dog";
+
+      WHEN("It is laid out without wrapping")
+	{
+	  auto layout = layouts.layout(font, text);
+
+	  THEN("It fits a single line of the size measured by SDL_ttf")
+	    {
+	      int width, height;
+
+	      TTF_SizeUTF8(font, text.c_str(), &width, &height);
+
+	      REQUIRE(layout->lines.size() == 1);
+	      REQUIRE(layout->width == width);
+	      REQUIRE(layout->height == TTF_FontHeight(font));
+	    }
+	}
+      WHEN("It is wrapped")
+	{
+	  const int wrapWidth = layouts.measure(font, "The quick").first;
+
+	  auto layout = layouts.layout(font, text, wrapWidth);
+
+	  THEN("Every line fits and the words are kept whole")
+	    {
+	      REQUIRE(layout->lines.size() > 1);
+
+	      for (const SO::TextLayout::Line& line : layout->lines)
+		REQUIRE(line.width <= wrapWidth);
+
+	      // "The quick" fits exactly, the space isn't drawn
+	      REQUIRE(layout->lines[0].count == 8);
+	      REQUIRE(layout->glyphs[8].codepoint == 'b');
+	      REQUIRE(layout->glyphs[8].x == 0);
+	      REQUIRE(layout->glyphs[8].y == TTF_FontLineSkip(font));
+	    }
+	}
+      WHEN("A word wider than the line follows leading spaces")
+	{
+	  const int wrapWidth = layouts.measure(font, "quick").first;
+
+	  auto layout = layouts.layout(font, "  quickquick", wrapWidth);
+
+	  THEN("No empty line is made before it")
+	    {
+	      REQUIRE(layout->lines[0].count > 0);
+	      REQUIRE(layout->glyphs[0].codepoint == 'q');
+	    }
+	}
+      WHEN("The kerning of the font changes")
+	{
+	  auto kerned = layouts.layout(font, text);
+
+	  TTF_SetFontKerning(font, !TTF_GetFontKerning(font));
+
+	  auto toggled = layouts.layout(font, text);
+
+	  TTF_SetFontKerning(font, !TTF_GetFontKerning(font));
+
+	  THEN("The text is laid out again")
+	    {
+	      REQUIRE(kerned != toggled);
+	      REQUIRE(layouts.getMisses() == 2);
+	    }
+	}
+      WHEN("It is aligned to the right")
+	{
+	  auto layout = layouts.layout(font, "a\nbbb", 0, SO::TextLayout::Align::Right);
+
+	  THEN("The lines end at the widest one")
+	    {
+	      const SO::TextLayout::Line& first = layout->lines[0];
+
+	      REQUIRE(layout->glyphs[first.first].x == layout->width - first.width);
+	      REQUIRE(layout->glyphs[layout->lines[1].first].x == 0);
+	    }
+	}
+      WHEN("The same text is laid out twice")
+	{
+	  auto first  = layouts.layout(font, text, 200);
+	  auto second = layouts.layout(font, text, 200);
+
+	  THEN("The cached layout is returned")
+	    {
+	      REQUIRE(first == second);
+	      REQUIRE(layouts.getHits() == 1);
+	      REQUIRE(layouts.getMisses() == 1);
+	    }
+	}
+      WHEN("More texts than the capacity are laid out")
+	{
+	  auto first = layouts.layout(font, "one");
+
+	  layouts.layout(font, "two");
+	  layouts.layout(font, "three");
+
+	  THEN("The least recently used one is evicted")
+	    {
+	      REQUIRE(layouts.layout(font, "one") != first);
+	      REQUIRE(layouts.getMisses() == 4);
+	    }
+	}
+
+      TTF_CloseFont(font);
+
+      SO::quitTTF();
+    }
+}
+
+#endif // _SDL_TTF_H
@@ -0,0 +1,126 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Renderer.hpp"
+#include "TextureCache.hpp"
+
+#ifdef _SDL_IMAGE_H
+
+namespace
+{
+
+  SDL_Surface* createScreen()
+  {
+    return SDL_CreateRGBSurface(0, 16, 16, 32,
+				0x00FF0000, 0x0000FF00,
+				0x000000FF, 0xFF000000);
+  }
+
+}
+
+SCENARIO("class SO::TextureCache", "[TextureCache]")
+{
+  GIVEN("A cache on a software renderer")
+    {
+      SO::Surface      screen(createScreen());
+      SO::Renderer     renderer(screen);
+      SO::TextureCache cache(renderer);
+
+      WHEN("A file is loaded again, with the same color key or another")
+	{
+	  std::shared_ptr<SO::Texture> first = cache.load("media/foo.png");
+	  std::shared_ptr<SO::Texture> again = cache.load("media/foo.png");
+	  std::shared_ptr<SO::Texture> keyed = cache.load("media/foo.png", SO::Color(0xFF, 0xFF, 0xFF));
+
+	  THEN("The texture is shared for the same color key only")
+	    {
+	      REQUIRE(again == first);
+	      REQUIRE(keyed != first);
+	      REQUIRE(cache.getHits() == 1);
+	      REQUIRE(cache.getMisses() == 2);
+	      REQUIRE(cache.getEvictions() == 0);
+	      REQUIRE(cache.getBytes() == first->getBytes() + keyed->getBytes());
+	    }
+	}
+      WHEN("A missing file is loaded")
+	{
+	  REQUIRE_THROWS_AS(cache.load("media/missing.png"), SO::Error);
+
+	  THEN("Nothing is kept")
+	    {
+	      REQUIRE(cache.getMisses() == 1);
+	      REQUIRE(cache.getBytes() == 0);
+	    }
+	}
+      WHEN("The budget is lowered below the unused textures")
+	{
+	  cache.load("media/foo.png");
+	  cache.load("media/dots.png");
+	  cache.load("media/arrow.png");
+	  cache.load("media/foo.png");
+
+	  cache.setBudget(cache.getBytes() - 1);
+
+	  THEN("The least recently used one is evicted")
+	    {
+	      REQUIRE(cache.getEvictions() == 1);
+
+	      cache.load("media/foo.png");
+	      cache.load("media/arrow.png");
+
+	      REQUIRE(cache.getHits() == 3);
+	      REQUIRE(cache.getMisses() == 3);
+
+	      cache.load("media/dots.png");
+
+	      REQUIRE(cache.getMisses() == 4);
+	    }
+	}
+      WHEN("The least recently used texture is still held")
+	{
+	  std::shared_ptr<SO::Texture> held = cache.load("media/dots.png");
+
+	  cache.load("media/foo.png");
+	  const std::size_t arrowBytes = cache.load("media/arrow.png")->getBytes();
+
+	  cache.setBudget(cache.getBytes() - 1);
+
+	  THEN("It is skipped for the next one")
+	    {
+	      REQUIRE(cache.getEvictions() == 1);
+	      REQUIRE(cache.getBytes() == held->getBytes() + arrowBytes);
+	      REQUIRE(cache.load("media/dots.png") == held);
+	      REQUIRE(cache.getHits() == 1);
+	    }
+	  THEN("Clearing the cache keeps it only")
+	    {
+	      cache.clear();
+
+	      REQUIRE(cache.getEvictions() == 2);
+	      REQUIRE(cache.getBytes() == held->getBytes());
+	    }
+	}
+    }
+}
+
+#endif // _SDL_IMAGE_H
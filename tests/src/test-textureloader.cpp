@@ -0,0 +1,122 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Renderer.hpp"
+#include "TextureLoader.hpp"
+
+#include <vector>
+
+#ifdef _SDL_IMAGE_H
+
+namespace
+{
+
+  struct Image
+  {
+    const char* path;
+    int         width;
+    int         height;
+  };
+
+  const Image Images[] = {
+    {"media/arrow.png",      296, 214},
+    {"media/background.png", 640, 480},
+    {"media/button.png",     300, 800},
+    {"media/dots.png",       200, 200},
+    {"media/foo.png",         64, 128}
+  };
+
+}
+
+SCENARIO("class SO::TextureLoader", "[TextureLoader]")
+{
+  GIVEN("A loader on a software renderer with a placeholder")
+    {
+      SO::initImage(SO::ImageInit::PNG);
+
+      SO::Surface  screen(SDL_CreateRGBSurface(0, 16, 16, 32,
+					       0x00FF0000, 0x0000FF00,
+					       0x000000FF, 0xFF000000));
+      SO::Renderer renderer(screen);
+
+      std::shared_ptr<SO::Texture> placeholder =
+	std::make_shared<SO::Texture>(renderer, 2, 2, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+
+      SO::TextureLoader loader(renderer, 2, placeholder);
+
+      WHEN("Files are loaded, one of them missing")
+	{
+	  std::vector<SO::TextureLoader::Handle> handles;
+
+	  for (const Image& image : Images)
+	    handles.push_back(loader.load(image.path));
+
+	  SO::TextureLoader::Handle missing = loader.load("media/missing.png");
+
+	  THEN("Nothing is ready nor failed before being uploaded")
+	    {
+	      REQUIRE(loader.getPending() == handles.size() + 1);
+
+	      for (const SO::TextureLoader::Handle& handle : handles)
+		{
+		  REQUIRE_FALSE(handle.isReady());
+		  REQUIRE_FALSE(handle.hasFailed());
+		  REQUIRE(&handle.get() == placeholder.get());
+		  REQUIRE(handle.getTexture() == nullptr);
+		}
+
+	      REQUIRE_FALSE(missing.hasFailed());
+	      REQUIRE(missing.getError().empty());
+	    }
+	  THEN("Uploading publishes every texture and the error")
+	    {
+	      // A few seconds at most for the workers to decode
+	      for (int i = 0; i < 1000 && loader.getPending() != 0; ++i)
+		{
+		  loader.upload();
+		  SDL_Delay(5);
+		}
+
+	      REQUIRE(loader.getPending() == 0);
+
+	      for (std::size_t i = 0; i < handles.size(); ++i)
+		{
+		  const SO::TextureLoader::Handle& handle = handles[i];
+
+		  REQUIRE(handle.isReady());
+		  REQUIRE_FALSE(handle.hasFailed());
+		  REQUIRE(&handle.get() == handle.getTexture().get());
+		  REQUIRE(handle.get().getWidth() == Images[i].width);
+		  REQUIRE(handle.get().getHeight() == Images[i].height);
+		}
+
+	      REQUIRE_FALSE(missing.isReady());
+	      REQUIRE(missing.hasFailed());
+	      REQUIRE_FALSE(missing.getError().empty());
+	      REQUIRE(&missing.get() == placeholder.get());
+	    }
+	}
+    }
+}
+
+#endif // _SDL_IMAGE_H
@@ -0,0 +1,134 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+#include "TextureMemory.hpp"
+
+#include <utility>
+
+SCENARIO("function SO::TextureMemory::getBytes", "[TextureMemory]")
+{
+  GIVEN("Textures of various formats")
+    {
+      THEN("Their size follows their pixel format")
+	{
+	  REQUIRE(SO::TextureMemory::getBytes(64, 32, SO::PixelFormats::ARGB8888) == 64 * 32 * 4);
+	  REQUIRE(SO::TextureMemory::getBytes(64, 32, SO::PixelFormats::RGB565) == 64 * 32 * 2);
+	  REQUIRE(SO::TextureMemory::getBytes(64, 32, SO::PixelFormats::RGB24) == 64 * 32 * 3);
+	  REQUIRE(SO::TextureMemory::getBytes(64, 32, SO::PixelFormats::Unknown) == 64 * 32 * 4);
+	  REQUIRE(SO::TextureMemory::getBytes(64, 32, SO::PixelFormats::IYUV) == 64 * 32 * 3 / 2);
+	  REQUIRE(SO::TextureMemory::getBytes(63, 31, SO::PixelFormats::YV12) == 63 * 31 + 2 * 32 * 16);
+	  REQUIRE(SO::TextureMemory::getBytes(63, 32, SO::PixelFormats::YUY2) == 32 * 4 * 32);
+	}
+    }
+}
+
+SCENARIO("class SO::TextureMemory", "[TextureMemory]")
+{
+  GIVEN("A software renderer")
+    {
+      SO::Surface  screen(SDL_CreateRGBSurface(0, 16, 16, 32,
+					       0x00FF0000, 0x0000FF00,
+					       0x000000FF, 0xFF000000));
+      SO::Renderer renderer(screen);
+
+      const std::size_t live  = SO::TextureMemory::getLive();
+      const std::size_t count = SO::TextureMemory::getCount();
+      const std::size_t bytes = 32 * 32 * 4;
+
+      WHEN("Textures are created and destroyed")
+	{
+	  {
+	    SO::Texture first(renderer, 32, 32, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+	    SO::Texture second(renderer, 32, 32, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+
+	    REQUIRE(first.getBytes() == bytes);
+	    REQUIRE(SO::TextureMemory::getLive() == live + 2 * bytes);
+	    REQUIRE(SO::TextureMemory::getCount() == count + 2);
+	    REQUIRE(SO::TextureMemory::getPeak() >= live + 2 * bytes);
+
+	    SO::Texture moved(std::move(first));
+
+	    REQUIRE(SO::TextureMemory::getLive() == live + 2 * bytes);
+	  }
+
+	  THEN("Their memory is given back")
+	    {
+	      REQUIRE(SO::TextureMemory::getLive() == live);
+	      REQUIRE(SO::TextureMemory::getCount() == count);
+	    }
+	}
+      WHEN("Textures are created in a category")
+	{
+	  const std::size_t ui = SO::TextureMemory::getLive("ui");
+
+	  SO::TextureMemory::Scope scope("ui");
+
+	  SO::Texture texture(renderer, 32, 32, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+
+	  THEN("They are counted in it until moved to another one")
+	    {
+	      REQUIRE(texture.getCategory() == "ui");
+	      REQUIRE(SO::TextureMemory::getLive("ui") == ui + bytes);
+	      REQUIRE(SO::TextureMemory::getCategories()["ui"] == ui + bytes);
+
+	      texture.setCategory("sprites");
+
+	      REQUIRE(SO::TextureMemory::getLive("ui") == ui);
+	      REQUIRE(SO::TextureMemory::getLive("sprites") >= bytes);
+	    }
+	}
+      WHEN("A texture would exceed the budget")
+	{
+	  SO::Texture* cached = new SO::Texture(renderer, 32, 32, SO::TextureAccess::Static,
+						SO::PixelFormats::ARGB8888);
+	  std::size_t  asked  = 0;
+
+	  const SO::TextureMemory::Handle handle = SO::TextureMemory::addBudgetCallback(
+	    [&](std::size_t excess)
+	    {
+	      asked = excess;
+
+	      delete cached;
+	      cached = nullptr;
+	    });
+
+	  SO::TextureMemory::setBudget(live + bytes + bytes / 2);
+
+	  SO::Texture texture(renderer, 32, 32, SO::TextureAccess::Static, SO::PixelFormats::ARGB8888);
+
+	  SO::TextureMemory::setBudget(0);
+	  SO::TextureMemory::removeBudgetCallback(handle);
+
+	  THEN("The callbacks are asked to release the excess first")
+	    {
+	      REQUIRE(asked == bytes / 2);
+	      REQUIRE(cached == nullptr);
+	      REQUIRE(SO::TextureMemory::getLive() == live + bytes);
+	    }
+
+	  delete cached;
+	}
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "catch.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+
+SCENARIO("function SO::nextCodepoint", "[Utils]")
+{
+  GIVEN("An UTF-8 string mixing sequence lengths")
+    {
+      const char* text = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+      const char* end  = text + std::strlen(text);
+
+      THEN("Each character is decoded in order")
+	{
+	  REQUIRE(SO::nextCodepoint(text, end) == 'a');
+	  REQUIRE(SO::nextCodepoint(text, end) == 0xE9);
+	  REQUIRE(SO::nextCodepoint(text, end) == 0x20AC);
+
+	  // Outside of the basic multilingual plane
+	  REQUIRE(SO::nextCodepoint(text, end) == '?');
+	  REQUIRE(text == end);
+	}
+    }
+  GIVEN("A sequence cut by the end of the string")
+    {
+      const char* text = "\xE2\x82";
+      const char* end  = text + 2;
+
+      THEN("It is replaced and the end is not overrun")
+	{
+	  REQUIRE(SO::nextCodepoint(text, end) == '?');
+	  REQUIRE(text <= end);
+	}
+    }
+  GIVEN("A stray continuation byte")
+    {
+      const char* text = "\x80z";
+      const char* end  = text + 2;
+
+      THEN("It is replaced and decoding resumes after it")
+	{
+	  REQUIRE(SO::nextCodepoint(text, end) == '?');
+	  REQUIRE(SO::nextCodepoint(text, end) == 'z');
+	}
+    }
+}
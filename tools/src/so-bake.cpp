@@ -0,0 +1,136 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+/*
+ * so-bake -- convert images to baked images loaded by SO::BakedImage.
+ *
+ * Usage: so-bake [-f FORMAT] INPUT OUTPUT
+ *
+ * FORMAT is the name of a SDL pixel format without its prefix, e.g.
+ * ARGB8888 (the default), ABGR8888 or RGB565. INPUT is anything
+ * IMG_Load reads, or a BMP without SDL_image.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "SDL.hpp"
+
+namespace
+{
+  const SO::PixelFormats formats[] = {SO::PixelFormats::RGB332,
+				      SO::PixelFormats::RGB444,
+				      SO::PixelFormats::RGB555,
+				      SO::PixelFormats::BGR555,
+				      SO::PixelFormats::ARGB4444,
+				      SO::PixelFormats::RGBA4444,
+				      SO::PixelFormats::ABGR4444,
+				      SO::PixelFormats::BGRA4444,
+				      SO::PixelFormats::ARGB1555,
+				      SO::PixelFormats::RGBA5551,
+				      SO::PixelFormats::ABGR1555,
+				      SO::PixelFormats::BGRA5551,
+				      SO::PixelFormats::RGB565,
+				      SO::PixelFormats::BGR565,
+				      SO::PixelFormats::RGB24,
+				      SO::PixelFormats::BGR24,
+				      SO::PixelFormats::RGB888,
+				      SO::PixelFormats::RGBX8888,
+				      SO::PixelFormats::BGR888,
+				      SO::PixelFormats::BGRX8888,
+				      SO::PixelFormats::ARGB8888,
+				      SO::PixelFormats::RGBA8888,
+				      SO::PixelFormats::ABGR8888,
+				      SO::PixelFormats::BGRA8888,
+				      SO::PixelFormats::ARGB2101010};
+
+  bool parseFormat(const char* name, SO::PixelFormats& format)
+  {
+    const std::string wanted = std::string("SDL_PIXELFORMAT_") + name;
+
+    for (SO::PixelFormats candidate : formats)
+      if (wanted == SDL_GetPixelFormatName(static_cast<Uint32>(candidate)))
+      {
+	format = candidate;
+	return true;
+      }
+
+    return false;
+  }
+
+  int usage(const char* program)
+  {
+    std::fprintf(stderr, "Usage: %s [-f FORMAT] INPUT OUTPUT\n", program);
+    return 2;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  SO::PixelFormats format = SO::PixelFormats::ARGB8888;
+
+  int arg = 1;
+
+  if (arg + 1 < argc && std::strcmp(argv[arg], "-f") == 0)
+  {
+    if (!parseFormat(argv[arg + 1], format))
+    {
+      std::fprintf(stderr, "%s: unknown pixel format %s\n", argv[0], argv[arg + 1]);
+      return 2;
+    }
+
+    arg += 2;
+  }
+
+  if (argc - arg != 2)
+    return usage(argv[0]);
+
+  try
+  {
+    SO::init(SO::Init::Video);
+
+#ifdef _SDL_IMAGE_H
+    SO::initImage(SO::ImageInit::PNG | SO::ImageInit::JPG);
+
+    SDL_Surface* loaded = IMG_Load(argv[arg]);
+#else
+    SDL_Surface* loaded = SDL_LoadBMP(argv[arg]);
+#endif
+
+    if (loaded == nullptr)
+      throw SO::Error(SDL_GetError());
+
+    SO::Surface surface(loaded);
+
+    SO::BakedImage::bake(surface, argv[arg + 1], format);
+
+    SO::quit();
+  }
+  catch (const SO::Error& error)
+  {
+    std::fprintf(stderr, "%s: %s\n", argv[0], error.what());
+    return 1;
+  }
+
+  return 0;
+}
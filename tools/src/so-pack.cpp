@@ -0,0 +1,101 @@
+/*
+ *  Cobra -- SDL2 C++ Wrapper
+ * 
+ *  Copyright (C) 2017 Olivier Dion <olivier-dion@hotmail.com>
+ * 
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty.  In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ * 
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ * 
+ *  1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+/*
+ * so-pack -- gather files in an asset pack opened by SO::AssetPack.
+ *
+ * Usage: so-pack [-C DIR] OUTPUT [NAME...]
+ *
+ * Each NAME is read from DIR (the working directory by default) and
+ * stored under that name. Without NAME, names are read from the
+ * standard input, one per line, e.g.
+ *
+ *   (cd assets && find . -type f) | so-pack -C assets game.pack
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SDL.hpp"
+
+namespace
+{
+  // "./a/b.png" is stored as "a/b.png"
+  std::string normalize(std::string name)
+  {
+    while (name.compare(0, 2, "./") == 0)
+      name.erase(0, 2);
+
+    return name;
+  }
+
+  int usage(const char* program)
+  {
+    std::fprintf(stderr, "Usage: %s [-C DIR] OUTPUT [NAME...]\n", program);
+    return 2;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const char* root = nullptr;
+
+  int arg = 1;
+
+  if (arg + 1 < argc && std::strcmp(argv[arg], "-C") == 0)
+  {
+    root = argv[arg + 1];
+    arg += 2;
+  }
+
+  if (arg >= argc)
+    return usage(argv[0]);
+
+  const char* output = argv[arg++];
+
+  std::vector<std::string> names;
+
+  for (; arg < argc; ++arg)
+    names.push_back(normalize(argv[arg]));
+
+  if (names.empty())
+    for (std::string line; std::getline(std::cin, line);)
+      if (!line.empty())
+	names.push_back(normalize(line));
+
+  try
+  {
+    SO::AssetPack::pack(output, names, root);
+  }
+  catch (const SO::Error& error)
+  {
+    std::fprintf(stderr, "%s: %s\n", argv[0], error.what());
+    return 1;
+  }
+
+  std::printf("%s: %zu entries\n", output, names.size());
+
+  return 0;
+}